@@ -24,6 +24,7 @@
 #   include "skill_type.h"
 #   include "map.h"
 #   include "unit.h"
+#   include "id_slot_map.h"
 //#include "randomc.h"
 #   include "leak_dumper.h"
 
@@ -31,6 +32,8 @@ using
 std::vector;
 using
 Shared::Graphics::Vec2i;
+using
+Shared::Util::IdSlotMap;
 
 namespace
 	Glest {
@@ -178,11 +181,9 @@ namespace
 				int
 					useMaxNodeCount;
 
-				std::map < int,
-					TravelState >
+				IdSlotMap < TravelState >
 					precachedTravelState;
-				std::map < int,
-					std::vector <
+				IdSlotMap < std::vector <
 					Vec2i > >
 					precachedPath;
 			};
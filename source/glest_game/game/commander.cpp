@@ -660,6 +660,7 @@ namespace
 				networkCommand->getNetworkCommandType() != nctSwitchTeamVote &&
 				networkCommand->getNetworkCommandType() != nctPauseResume &&
 				networkCommand->getNetworkCommandType() != nctPlayerStatusChange &&
+				networkCommand->getNetworkCommandType() != nctNetworkFramePeriod &&
 				networkCommand->getNetworkCommandType() !=
 				nctDisconnectNetworkPlayer) {
 				unit = world->findUnitById(networkCommand->getUnitId());
@@ -1384,6 +1385,47 @@ namespace
 				}
 				break;
 
+				case nctNetworkFramePeriod:
+				{
+					if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).
+						enabled)
+						SystemFlags::OutputDebug(SystemFlags::debugSystem,
+							"In [%s::%s Line: %d] found nctNetworkFramePeriod\n",
+							extractFileFromDirectoryPath
+							(__FILE__).c_str(), __FUNCTION__,
+							__LINE__);
+
+					commandWasHandled = true;
+
+					// Every peer runs this at the same keyframe so the next
+					// keyframe is computed with the new period everywhere
+					int
+						networkFramePeriod = networkCommand->getUnitId();
+					if (networkFramePeriod >= GameConstants::minNetworkFramePeriod &&
+						networkFramePeriod <= GameConstants::maxNetworkFramePeriod) {
+						GameSettings *
+							settings = world->getGameSettingsPtr();
+						if (settings != NULL) {
+							settings->setNetworkFramePeriod(networkFramePeriod);
+						}
+						GameNetworkInterface *
+							gameNetworkInterface =
+							NetworkManager::getInstance().getGameNetworkInterface();
+						if (gameNetworkInterface != NULL) {
+							gameNetworkInterface->setNetworkFramePeriod(networkFramePeriod);
+						}
+					}
+
+					if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).
+						enabled)
+						SystemFlags::OutputDebug(SystemFlags::debugSystem,
+							"In [%s::%s Line: %d] frame: %d networkFramePeriod = %d\n",
+							extractFileFromDirectoryPath
+							(__FILE__).c_str(), __FUNCTION__,
+							__LINE__, world->getFrameCount(), networkFramePeriod);
+				}
+				break;
+
 				default:
 					break;
 
@@ -39,6 +39,7 @@
 #include "video_player.h"
 #include "compression_utils.h"
 #include "cache_manager.h"
+#include "residency_manager.h"
 #include "conversion.h"
 #include "steam.h"
 #include "shared_const.h"
@@ -52,6 +53,12 @@ using namespace Shared::CompressionUtil;
 
 namespace Glest {
 	namespace Game {
+
+		static ConfigBoolHandle configShowPerfStats("ShowPerfStats", "false");
+		static ConfigBoolHandle configEnableNewThreadManager("EnableNewThreadManager", "false");
+		static ConfigBoolHandle configPerformanceWarningEnabled("PerformanceWarningEnabled", "false");
+		static ConfigIntHandle configPerformanceWarningMillis("PerformanceWarningMillis", "7");
+		static ConfigIntHandle configPerformanceWarningRenderMillis("PerformanceWarningRenderMillis", "40");
 		string GameSettings::playerDisconnectedText = "";
 		Game *thisGamePtr = NULL;
 
@@ -102,6 +109,8 @@ namespace Glest {
 			paused = false;
 			networkPauseGameForLaggedClientsRequested = false;
 			networkResumeGameForLaggedClientsRequested = false;
+			configStringLookupsLastFrame = Config::getStringLookupCount();
+			configStringLookupsPerFrame = 0;
 			pausedForJoinGame = false;
 			pausedBeforeJoinGame = false;
 			pauseRequestSent = false;
@@ -287,6 +296,8 @@ namespace Glest {
 			paused = false;
 			networkPauseGameForLaggedClientsRequested = false;
 			networkResumeGameForLaggedClientsRequested = false;
+			configStringLookupsLastFrame = Config::getStringLookupCount();
+			configStringLookupsPerFrame = 0;
 			pausedForJoinGame = false;
 			pausedBeforeJoinGame = false;
 			resumeRequestSent = false;
@@ -2571,8 +2582,7 @@ namespace Glest {
 				}
 
 				bool
-					showPerfStats =
-					Config::getInstance().getBool("ShowPerfStats", "false");
+					showPerfStats = configShowPerfStats.get();
 				Chrono chronoPerf;
 				char perfBuf[8096] = "";
 				std::vector < string > perfList;
@@ -2933,8 +2943,7 @@ namespace Glest {
 
 								const bool
 									newThreadManager =
-									Config::getInstance().getBool("EnableNewThreadManager",
-										"false");
+									configEnableNewThreadManager.get();
 								if (newThreadManager == true) {
 									int currentFrameCount = world.getFrameCount();
 									masterController.signalSlaves(&currentFrameCount);
@@ -3113,6 +3122,11 @@ namespace Glest {
 							addPerformanceCount("ProcessWorldUpdate",
 								chronoGamePerformanceCounts.getMillis());
 
+							int64 configStringLookups = Config::getStringLookupCount();
+							configStringLookupsPerFrame =
+								configStringLookups - configStringLookupsLastFrame;
+							configStringLookupsLastFrame = configStringLookups;
+
 							if (SystemFlags::getSystemSettingType
 							(SystemFlags::debugPerformance).enabled
 								&& chrono.getMillis() > 0)
@@ -3978,16 +3992,9 @@ namespace Glest {
 			}
 
 			bool displayWarningHeader = true;
-			bool
-				WARN_TO_CONSOLE =
-				Config::getInstance().getBool("PerformanceWarningEnabled", "false");
-			int
-				WARNING_MILLIS =
-				Config::getInstance().getInt("PerformanceWarningMillis", "7");
-			int
-				WARNING_RENDER_MILLIS =
-				Config::getInstance().getInt("PerformanceWarningRenderMillis",
-					"40");
+			bool WARN_TO_CONSOLE = configPerformanceWarningEnabled.get();
+			int WARNING_MILLIS = configPerformanceWarningMillis.get();
+			int WARNING_RENDER_MILLIS = configPerformanceWarningRenderMillis.get();
 
 			string result = "";
 			for (std::map < string, int64 >::const_iterator iterMap =
@@ -4025,6 +4032,16 @@ namespace Glest {
 				result += perfStat;
 			}
 
+			// Remaining string keyed config lookups, these should be moved to
+			// a ConfigHandle if they show up in hot code
+			if (configStringLookupsPerFrame > 0) {
+				if (result != "") {
+					result += "\n";
+				}
+				result += "Config string lookups per frame: " +
+					intToStr(configStringLookupsPerFrame);
+			}
+
 			return result;
 		}
 
@@ -7175,6 +7192,8 @@ namespace Glest {
 				&& chrono.getMillis() > 0)
 				chrono.start();
 
+			renderer.updateRenderSnapshot(&world);
+
 			//shadow map
 			renderer.renderShadowsToTexture(avgRenderFps);
 			if (SystemFlags::
@@ -7554,6 +7573,8 @@ namespace Glest {
 			} else {
 				str += "Total unit count: " + intToStr(totalUnitcount) + "\n";
 			}
+			str += ObjectPoolStats::getStatsText();
+			str += ResidencyManager::getStatsText();
 
 			// resources
 			for (int i = 0; i < world.getFactionCount(); ++i) {
@@ -243,6 +243,8 @@ namespace Glest {
 
 			std::map < int, FowAlphaCellsLookupItem > teamFowAlphaCellsLookupItem;
 			std::map < string, int64 > gamePerformanceCounts;
+			int64 configStringLookupsLastFrame;
+			int64 configStringLookupsPerFrame;
 
 			bool networkPauseGameForLaggedClientsRequested;
 			bool networkResumeGameForLaggedClientsRequested;
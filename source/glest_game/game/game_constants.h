@@ -196,6 +196,10 @@ namespace
 
 			static int
 				networkFramePeriod;
+			static const int
+				minNetworkFramePeriod = 10;
+			static const int
+				maxNetworkFramePeriod = 40;
 			static const int
 				networkPingInterval = 5;
 			static const int
@@ -16,6 +16,7 @@
 #include "game_camera.h"
 #include "game.h"
 #include "config.h"
+#include <algorithm>
 
 #include "leak_dumper.h"
 
@@ -205,6 +206,234 @@ namespace
 			}
 		}
 
+		// Removes the first occurrence of value, order of the rest is kept
+		static void
+			eraseEventId(std::vector < int > &eventIdList, int eventId) {
+			for (unsigned int i = 0; i < eventIdList.size(); ++i) {
+				if (eventIdList[i] == eventId) {
+					eventIdList.erase(eventIdList.begin() + i);
+					return;
+				}
+			}
+		}
+
+		CellTriggerEventIndex::CellTriggerEventIndex() {
+			bucketsW = 0;
+			bucketsH = 0;
+		}
+
+		// The bucket grid covers the map and never grows, locations
+		// outside of it can't be reached by a unit
+		void
+			CellTriggerEventIndex::init(int mapW, int mapH) {
+			clear();
+			bucketsW = (max(mapW, 0) + bucketCellSize - 1) / bucketCellSize;
+			bucketsH = (max(mapH, 0) + bucketCellSize - 1) / bucketCellSize;
+			buckets.resize(bucketsW * bucketsH);
+		}
+
+		void
+			CellTriggerEventIndex::clear() {
+			bucketsW = 0;
+			bucketsH = 0;
+			buckets.clear();
+			unitEvents.clear();
+			factionEvents.clear();
+			unitInsideAreaEvents.clear();
+		}
+
+		bool
+			CellTriggerEventIndex::getBucketRange(const CellTriggerEvent & event,
+				Vec2i & bucketStart,
+				Vec2i & bucketEnd) const {
+			Vec2i
+				posStart = event.destPos;
+			Vec2i
+				posEnd = event.destPos;
+			if (event.type == ctet_FactionAreaPos || event.type == ctet_AreaPos) {
+				posEnd = event.destPosEnd;
+			}
+			// Areas that cover no cell on the map can never be entered
+			if (posEnd.x < posStart.x || posEnd.y < posStart.y ||
+				posEnd.x < 0 || posEnd.y < 0) {
+				return false;
+			}
+			bucketStart.x = max(posStart.x, 0) / bucketCellSize;
+			bucketStart.y = max(posStart.y, 0) / bucketCellSize;
+			if (bucketStart.x >= bucketsW || bucketStart.y >= bucketsH) {
+				return false;
+			}
+			bucketEnd.x = min(posEnd.x / bucketCellSize, bucketsW - 1);
+			bucketEnd.y = min(posEnd.y / bucketCellSize, bucketsH - 1);
+			return true;
+		}
+
+		void
+			CellTriggerEventIndex::addEvent(int eventId,
+				const CellTriggerEvent & event) {
+			switch (event.type) {
+				case ctet_Unit:
+				case ctet_UnitPos:
+				case ctet_UnitAreaPos:
+					if (event.sourceId >= 0) {
+						unitEvents[event.sourceId].push_back(eventId);
+					}
+					break;
+				case ctet_Faction:
+					factionEvents[event.sourceId].push_back(eventId);
+					break;
+				case ctet_FactionPos:
+				case ctet_FactionAreaPos:
+				case ctet_AreaPos:
+				{
+					Vec2i
+						bucketStart;
+					Vec2i
+						bucketEnd;
+					if (getBucketRange(event, bucketStart, bucketEnd) == false) {
+						break;
+					}
+					for (int y = bucketStart.y; y <= bucketEnd.y; ++y) {
+						for (int x = bucketStart.x; x <= bucketEnd.x; ++x) {
+							buckets[y * bucketsW + x].push_back(eventId);
+						}
+					}
+				}
+				break;
+			}
+
+			if (event.type == ctet_AreaPos) {
+				for (std::map < int, string >::const_iterator iterMap =
+					event.eventStateInfo.begin();
+					iterMap != event.eventStateInfo.end(); ++iterMap) {
+					setUnitInsideArea(iterMap->first, eventId, true);
+				}
+			}
+		}
+
+		void
+			CellTriggerEventIndex::removeEvent(int eventId,
+				const CellTriggerEvent & event) {
+			switch (event.type) {
+				case ctet_Unit:
+				case ctet_UnitPos:
+				case ctet_UnitAreaPos:
+				{
+					std::vector < int > *
+						eventIdList = unitEvents.get(event.sourceId);
+					if (eventIdList != NULL) {
+						eraseEventId(*eventIdList, eventId);
+						if (eventIdList->empty() == true) {
+							unitEvents.erase(event.sourceId);
+						}
+					}
+				}
+				break;
+				case ctet_Faction:
+					eraseEventId(factionEvents[event.sourceId], eventId);
+					break;
+				case ctet_FactionPos:
+				case ctet_FactionAreaPos:
+				case ctet_AreaPos:
+				{
+					Vec2i
+						bucketStart;
+					Vec2i
+						bucketEnd;
+					if (getBucketRange(event, bucketStart, bucketEnd) == false) {
+						break;
+					}
+					for (int y = bucketStart.y; y <= bucketEnd.y; ++y) {
+						for (int x = bucketStart.x; x <= bucketEnd.x; ++x) {
+							eraseEventId(buckets[y * bucketsW + x], eventId);
+						}
+					}
+				}
+				break;
+			}
+
+			if (event.type == ctet_AreaPos) {
+				for (std::map < int, string >::const_iterator iterMap =
+					event.eventStateInfo.begin();
+					iterMap != event.eventStateInfo.end(); ++iterMap) {
+					setUnitInsideArea(iterMap->first, eventId, false);
+				}
+			}
+		}
+
+		void
+			CellTriggerEventIndex::setUnitInsideArea(int unitId, int eventId,
+				bool inside) {
+			if (unitId < 0) {
+				return;
+			}
+			if (inside == true) {
+				unitInsideAreaEvents[unitId].push_back(eventId);
+			} else {
+				std::vector < int > *
+					eventIdList = unitInsideAreaEvents.get(unitId);
+				if (eventIdList != NULL) {
+					eraseEventId(*eventIdList, eventId);
+					if (eventIdList->empty() == true) {
+						unitInsideAreaEvents.erase(unitId);
+					}
+				}
+			}
+		}
+
+		void
+			CellTriggerEventIndex::getCandidateEvents(int unitId, int factionIndex,
+				const Vec2i & pos, int unitSize,
+				std::vector < int > &eventIdList) const {
+			eventIdList.clear();
+
+			const std::vector < int > *
+				unitEventIdList = unitEvents.get(unitId);
+			if (unitEventIdList != NULL) {
+				eventIdList.insert(eventIdList.end(), unitEventIdList->begin(),
+					unitEventIdList->end());
+			}
+			// Units already inside an area must be checked for leaving it
+			// wherever they moved to
+			unitEventIdList = unitInsideAreaEvents.get(unitId);
+			if (unitEventIdList != NULL) {
+				eventIdList.insert(eventIdList.end(), unitEventIdList->begin(),
+					unitEventIdList->end());
+			}
+			std::map < int, std::vector < int > >::const_iterator iterFind =
+				factionEvents.find(factionIndex);
+			if (iterFind != factionEvents.end()) {
+				eventIdList.insert(eventIdList.end(), iterFind->second.begin(),
+					iterFind->second.end());
+			}
+
+			// A unit at pos covers cells pos .. pos + size - 1, so a location
+			// matches when it lies in pos - size + 1 .. pos
+			int
+				bucketStartX = max(pos.x - unitSize + 1, 0) / bucketCellSize;
+			int
+				bucketStartY = max(pos.y - unitSize + 1, 0) / bucketCellSize;
+			int
+				bucketEndX = min(pos.x / bucketCellSize, bucketsW - 1);
+			int
+				bucketEndY = min(pos.y / bucketCellSize, bucketsH - 1);
+			if (pos.x >= 0 && pos.y >= 0) {
+				for (int y = bucketStartY; y <= bucketEndY; ++y) {
+					for (int x = bucketStartX; x <= bucketEndX; ++x) {
+						const std::vector < int > &
+							bucket = buckets[y * bucketsW + x];
+						eventIdList.insert(eventIdList.end(), bucket.begin(),
+							bucket.end());
+					}
+				}
+			}
+
+			// Fire in event id order like a walk of the whole event list
+			std::sort(eventIdList.begin(), eventIdList.end());
+			eventIdList.erase(std::unique(eventIdList.begin(), eventIdList.end()),
+				eventIdList.end());
+		}
+
 		TimerTriggerEvent::TimerTriggerEvent() {
 			running = false;
 			startFrame = 0;
@@ -267,6 +496,19 @@ namespace
 			ScriptManager::messageWrapCount = 35;
 		const int
 			ScriptManager::displayTextWrapCount = 64;
+		const char *
+			ScriptManager::luaEventHandlerNames[leht_Count] = {
+			"resourceHarvested",
+			"unitCreated",
+			"unitDied",
+			"unitAttacked",
+			"unitAttacking",
+			"gameOver",
+			"timerTriggerEvent",
+			"cellTriggerEvent",
+			"unitTriggerEvent",
+			"dayNightTriggerEvent"
+		};
 
 		ScriptManager::ScriptManager() {
 			world = NULL;
@@ -293,12 +535,89 @@ namespace
 
 			lastUnitTriggerEventUnitId = -1;
 			lastUnitTriggerEventType = utet_None;
+
+			luaEventHandlersResolved = false;
+			for (int i = 0; i < leht_Count; ++i) {
+				luaEventHandlerRefs[i] = LUA_NOREF;
+			}
 		}
 
 		ScriptManager::~ScriptManager() {
 
 		}
 
+		// Called once global and startup (or onLoad) have run, so handlers
+		// those define are found too. Until then events are called by name.
+		void
+			ScriptManager::resolveLuaEventHandlers() {
+			releaseLuaEventHandlers();
+
+			for (int i = 0; i < leht_Count; ++i) {
+				luaEventHandlerRefs[i] =
+					luaScript.getFunctionRef(luaEventHandlerNames[i]);
+			}
+			for (int i = 0; i < world->getFactionCount(); ++i) {
+				const FactionType *
+					factionType = world->getFaction(i)->getType();
+				for (int j = 0; j < factionType->getUnitTypeCount(); ++j) {
+					const UnitType *
+						unitType = factionType->getUnitType(j);
+					if (unitCreatedOfTypeHandlerRefs.find(unitType) !=
+						unitCreatedOfTypeHandlerRefs.end()) {
+						continue;
+					}
+					int
+						functionRef =
+						luaScript.getFunctionRef("unitCreatedOfType_" +
+							unitType->getName());
+					if (functionRef != LUA_NOREF) {
+						unitCreatedOfTypeHandlerRefs[unitType] = functionRef;
+					}
+				}
+			}
+			luaEventHandlersResolved = true;
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) {
+				for (int i = 0; i < leht_Count; ++i) {
+					SystemFlags::OutputDebug(SystemFlags::debugLUA,
+						"In [%s::%s Line: %d] lua event handler [%s] defined = %d\n",
+						extractFileFromDirectoryPath(__FILE__).
+						c_str(), __FUNCTION__, __LINE__,
+						luaEventHandlerNames[i],
+						(luaEventHandlerRefs[i] != LUA_NOREF));
+				}
+			}
+		}
+
+		void
+			ScriptManager::releaseLuaEventHandlers() {
+			for (int i = 0; i < leht_Count; ++i) {
+				if (luaEventHandlerRefs[i] != LUA_NOREF) {
+					luaScript.releaseFunctionRef(luaEventHandlerRefs[i]);
+					luaEventHandlerRefs[i] = LUA_NOREF;
+				}
+			}
+			for (std::map < const UnitType *, int >::iterator iterMap =
+				unitCreatedOfTypeHandlerRefs.begin();
+				iterMap != unitCreatedOfTypeHandlerRefs.end(); ++iterMap) {
+				luaScript.releaseFunctionRef(iterMap->second);
+			}
+			unitCreatedOfTypeHandlerRefs.clear();
+			luaEventHandlersResolved = false;
+		}
+
+		void
+			ScriptManager::callLuaEventHandler(LuaEventHandlerType handlerType) {
+			if (luaEventHandlersResolved == false) {
+				luaScript.beginCall(luaEventHandlerNames[handlerType]);
+				luaScript.endCall();
+			} else if (luaEventHandlerRefs[handlerType] != LUA_NOREF) {
+				luaScript.beginCall(luaEventHandlerRefs[handlerType],
+					luaEventHandlerNames[handlerType]);
+				luaScript.endCall();
+			}
+		}
+
 		void
 			ScriptManager::init(World * world, GameCamera * gameCamera,
 				const XmlNode * rootNode) {
@@ -322,6 +641,8 @@ namespace
 			//printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 			currentEventId = 1;
 			CellTriggerEventList.clear();
+			cellTriggerEventIndex.init(world->getMap()->getW(),
+				world->getMap()->getH());
 			TimerTriggerEventList.clear();
 
 			//printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
@@ -633,6 +954,8 @@ namespace
 					luaScript.beginCall("onLoad");
 					luaScript.endCall();
 				}
+
+				resolveLuaEventHandlers();
 			} catch (const megaglest_runtime_error & ex) {
 				//string sErrBuf = "";
 				//if(ex.wantStackTrace() == true) {
@@ -727,8 +1050,7 @@ namespace
 					c_str(), __FUNCTION__, __LINE__);
 
 			if (this->rootNode == NULL) {
-				luaScript.beginCall("resourceHarvested");
-				luaScript.endCall();
+				callLuaEventHandler(leht_ResourceHarvested);
 			}
 		}
 
@@ -743,11 +1065,21 @@ namespace
 			if (this->rootNode == NULL) {
 				lastCreatedUnitName = unit->getType()->getName(false);
 				lastCreatedUnitId = unit->getId();
-				luaScript.beginCall("unitCreated");
-				luaScript.endCall();
-				luaScript.beginCall("unitCreatedOfType_" +
-					unit->getType()->getName());
-				luaScript.endCall();
+				callLuaEventHandler(leht_UnitCreated);
+				if (luaEventHandlersResolved == false) {
+					luaScript.beginCall("unitCreatedOfType_" +
+						unit->getType()->getName());
+					luaScript.endCall();
+				} else if (unitCreatedOfTypeHandlerRefs.empty() == false) {
+					std::map < const UnitType *, int >::iterator iterFind =
+						unitCreatedOfTypeHandlerRefs.find(unit->getType());
+					if (iterFind != unitCreatedOfTypeHandlerRefs.end()) {
+						luaScript.beginCall(iterFind->second,
+							"unitCreatedOfType_" +
+							unit->getType()->getName());
+						luaScript.endCall();
+					}
+				}
 			}
 		}
 
@@ -784,8 +1116,7 @@ namespace
 				lastDeadUnitId = unit->getId();
 				lastDeadUnitCauseOfDeath = unit->getCauseOfDeath();
 
-				luaScript.beginCall("unitDied");
-				luaScript.endCall();
+				callLuaEventHandler(leht_UnitDied);
 			}
 		}
 
@@ -800,8 +1131,7 @@ namespace
 			if (this->rootNode == NULL) {
 				lastAttackedUnitName = unit->getType()->getName(false);
 				lastAttackedUnitId = unit->getId();
-				luaScript.beginCall("unitAttacked");
-				luaScript.endCall();
+				callLuaEventHandler(leht_UnitAttacked);
 			}
 		}
 
@@ -816,8 +1146,7 @@ namespace
 			if (this->rootNode == NULL) {
 				lastAttackingUnitName = unit->getType()->getName(false);
 				lastAttackingUnitId = unit->getId();
-				luaScript.beginCall("unitAttacking");
-				luaScript.endCall();
+				callLuaEventHandler(leht_UnitAttacking);
 			}
 		}
 
@@ -830,8 +1159,7 @@ namespace
 					c_str(), __FUNCTION__, __LINE__);
 
 			gameWon = won;
-			luaScript.beginCall("gameOver");
-			luaScript.endCall();
+			callLuaEventHandler(leht_GameOver);
 		}
 
 		void
@@ -886,8 +1214,7 @@ namespace
 						}
 					}
 					currentTimerTriggeredEventId = iterMap->first;
-					luaScript.beginCall("timerTriggerEvent");
-					luaScript.endCall();
+					callLuaEventHandler(leht_TimerTriggerEvent);
 
 					if (event.triggerSecondsElapsed > 0) {
 						int
@@ -921,9 +1248,35 @@ namespace
 			if (movingUnit != NULL) {
 				//ScenarioInfo scenarioInfoStart = world->getScenario()->getInfo();
 
-				for (std::map < int, CellTriggerEvent >::iterator iterMap =
-					CellTriggerEventList.begin();
-					iterMap != CellTriggerEventList.end(); ++iterMap) {
+				// Only events the index finds near the unit can trigger, events
+				// registered by the lua handlers meanwhile are checked after them
+				std::vector < int >
+					eventIdList;
+				cellTriggerEventIndex.getCandidateEvents(movingUnit->getId(),
+					movingUnit->getFactionIndex(),
+					movingUnit->getPos(),
+					movingUnit->getType()->getSize(),
+					eventIdList);
+				int
+					firstNewEventId = currentEventId;
+				int
+					lastCheckedEventId = -1;
+
+				for (unsigned int eventIndex = 0;; ++eventIndex) {
+					if (eventIndex >= eventIdList.size()) {
+						if (firstNewEventId >= currentEventId) {
+							break;
+						}
+						for (; firstNewEventId < currentEventId; ++firstNewEventId) {
+							eventIdList.push_back(firstNewEventId);
+						}
+					}
+					std::map < int, CellTriggerEvent >::iterator iterMap =
+						CellTriggerEventList.find(eventIdList[eventIndex]);
+					if (iterMap == CellTriggerEventList.end()) {
+						continue;
+					}
+					lastCheckedEventId = iterMap->first;
 					CellTriggerEvent & event = iterMap->second;
 
 					if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).
@@ -1399,6 +1752,9 @@ namespace
 											event.eventStateInfo[movingUnit->
 												getId()] =
 												Vec2i(x, y).getString();
+											cellTriggerEventIndex.
+												setUnitInsideArea(movingUnit->getId(),
+													iterMap->first, true);
 										}
 									}
 								}
@@ -1453,6 +1809,9 @@ namespace
 										movingUnit->getId();
 
 									event.eventStateInfo.erase(movingUnit->getId());
+									cellTriggerEventIndex.
+										setUnitInsideArea(movingUnit->getId(),
+											iterMap->first, false);
 								}
 							}
 						}
@@ -1472,8 +1831,7 @@ namespace
 						currentCellTriggeredEventId = iterMap->first;
 						event.triggerCount++;
 
-						luaScript.beginCall("cellTriggerEvent");
-						luaScript.endCall();
+						callLuaEventHandler(leht_CellTriggerEvent);
 					}
 
 					//                      ScenarioInfo scenarioInfoEnd = world->getScenario()->getInfo();
@@ -1481,6 +1839,15 @@ namespace
 					//                              break;
 					//                      }
 				}
+
+				// Skipped events never trigger, so when the last registered one
+				// was skipped the ids read the same as after checking it
+				if (CellTriggerEventList.empty() == false &&
+					CellTriggerEventList.rbegin()->first != lastCheckedEventId) {
+					currentCellTriggeredEventAreaEntryUnitId = 0;
+					currentCellTriggeredEventAreaExitUnitId = 0;
+					currentCellTriggeredEventUnitId = 0;
+				}
 			}
 
 			inCellTriggerEvent = false;
@@ -2034,9 +2401,38 @@ namespace
 			return false;
 		}
 
+		// Scripts get an error for locations no unit can ever reach, areas
+		// reaching past the map edge are fine
+		void
+			ScriptManager::checkTriggerArea(const Vec2i & posStart,
+				const Vec2i & posEnd) const {
+			const Map *
+				map = world->getMap();
+			if (posEnd.x < posStart.x || posEnd.y < posStart.y ||
+				posEnd.x < 0 || posEnd.y < 0 ||
+				posStart.x >= map->getW() || posStart.y >= map->getH()) {
+				throw
+					megaglest_runtime_error("Cell trigger location " +
+						posStart.getString() + " - " + posEnd.getString() +
+						" is outside the map", true);
+			}
+		}
+
+		// The trigger lists keep per unit slots, ids a script made up must
+		// not reach them
+		void
+			ScriptManager::checkTriggerUnitId(int unitId) const {
+			if (world->isUnitIdInRange(unitId) == false) {
+				throw
+					megaglest_runtime_error("Invalid unit id: " + intToStr(unitId), true);
+			}
+		}
+
 		int
 			ScriptManager::registerCellTriggerEventForUnitToUnit(int sourceUnitId,
 				int destUnitId) {
+			checkTriggerUnitId(sourceUnitId);
+			checkTriggerUnitId(destUnitId);
 			CellTriggerEvent
 				trigger;
 			trigger.type = ctet_Unit;
@@ -2046,6 +2442,7 @@ namespace
 			int
 				eventId = currentEventId++;
 			CellTriggerEventList[eventId] = trigger;
+			cellTriggerEventIndex.addEvent(eventId, trigger);
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled)
 				SystemFlags::OutputDebug(SystemFlags::debugLUA,
@@ -2061,6 +2458,8 @@ namespace
 			ScriptManager::
 			registerCellTriggerEventForUnitToLocation(int sourceUnitId,
 				const Vec2i & pos) {
+			checkTriggerUnitId(sourceUnitId);
+			checkTriggerArea(pos, pos);
 			CellTriggerEvent
 				trigger;
 			trigger.type = ctet_UnitPos;
@@ -2070,6 +2469,7 @@ namespace
 			int
 				eventId = currentEventId++;
 			CellTriggerEventList[eventId] = trigger;
+			cellTriggerEventIndex.addEvent(eventId, trigger);
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled)
 				SystemFlags::OutputDebug(SystemFlags::debugLUA,
@@ -2086,6 +2486,8 @@ namespace
 			ScriptManager::
 			registerCellAreaTriggerEventForUnitToLocation(int sourceUnitId,
 				const Vec4i & pos) {
+			checkTriggerUnitId(sourceUnitId);
+			checkTriggerArea(Vec2i(pos.x, pos.y), Vec2i(pos.z, pos.w));
 			CellTriggerEvent
 				trigger;
 			trigger.type = ctet_UnitAreaPos;
@@ -2098,6 +2500,7 @@ namespace
 			int
 				eventId = currentEventId++;
 			CellTriggerEventList[eventId] = trigger;
+			cellTriggerEventIndex.addEvent(eventId, trigger);
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled)
 				SystemFlags::OutputDebug(SystemFlags::debugLUA,
@@ -2114,6 +2517,7 @@ namespace
 			ScriptManager::
 			registerCellTriggerEventForFactionToUnit(int sourceFactionId,
 				int destUnitId) {
+			checkTriggerUnitId(destUnitId);
 			CellTriggerEvent
 				trigger;
 			trigger.type = ctet_Faction;
@@ -2123,6 +2527,7 @@ namespace
 			int
 				eventId = currentEventId++;
 			CellTriggerEventList[eventId] = trigger;
+			cellTriggerEventIndex.addEvent(eventId, trigger);
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled)
 				SystemFlags::OutputDebug(SystemFlags::debugLUA,
@@ -2138,6 +2543,7 @@ namespace
 			ScriptManager::
 			registerCellTriggerEventForFactionToLocation(int sourceFactionId,
 				const Vec2i & pos) {
+			checkTriggerArea(pos, pos);
 			CellTriggerEvent
 				trigger;
 			trigger.type = ctet_FactionPos;
@@ -2147,6 +2553,7 @@ namespace
 			int
 				eventId = currentEventId++;
 			CellTriggerEventList[eventId] = trigger;
+			cellTriggerEventIndex.addEvent(eventId, trigger);
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled)
 				SystemFlags::OutputDebug(SystemFlags::debugLUA,
@@ -2163,6 +2570,7 @@ namespace
 			ScriptManager::
 			registerCellAreaTriggerEventForFactionToLocation(int sourceFactionId,
 				const Vec4i & pos) {
+			checkTriggerArea(Vec2i(pos.x, pos.y), Vec2i(pos.z, pos.w));
 			CellTriggerEvent
 				trigger;
 			trigger.type = ctet_FactionAreaPos;
@@ -2175,6 +2583,7 @@ namespace
 			int
 				eventId = currentEventId++;
 			CellTriggerEventList[eventId] = trigger;
+			cellTriggerEventIndex.addEvent(eventId, trigger);
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled)
 				SystemFlags::OutputDebug(SystemFlags::debugLUA,
@@ -2189,6 +2598,7 @@ namespace
 
 		int
 			ScriptManager::registerCellAreaTriggerEvent(const Vec4i & pos) {
+			checkTriggerArea(Vec2i(pos.x, pos.y), Vec2i(pos.z, pos.w));
 			CellTriggerEvent
 				trigger;
 			trigger.type = ctet_AreaPos;
@@ -2201,6 +2611,7 @@ namespace
 			int
 				eventId = currentEventId++;
 			CellTriggerEventList[eventId] = trigger;
+			cellTriggerEventIndex.addEvent(eventId, trigger);
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled)
 				SystemFlags::OutputDebug(SystemFlags::debugLUA,
@@ -2227,6 +2638,8 @@ namespace
 			ScriptManager::unregisterCellTriggerEvent(int eventId) {
 			if (CellTriggerEventList.find(eventId) != CellTriggerEventList.end()) {
 				if (inCellTriggerEvent == false) {
+					cellTriggerEventIndex.removeEvent(eventId,
+						CellTriggerEventList[eventId]);
 					CellTriggerEventList.erase(eventId);
 				} else {
 					unRegisterCellTriggerEventList.push_back(eventId);
@@ -2239,7 +2652,13 @@ namespace
 						i < (int) unRegisterCellTriggerEventList.size(); ++i) {
 						int
 							delayedEventId = unRegisterCellTriggerEventList[i];
-						CellTriggerEventList.erase(delayedEventId);
+						std::map < int, CellTriggerEvent >::iterator iterFind =
+							CellTriggerEventList.find(delayedEventId);
+						if (iterFind != CellTriggerEventList.end()) {
+							cellTriggerEventIndex.removeEvent(delayedEventId,
+								iterFind->second);
+							CellTriggerEventList.erase(iterFind);
+						}
 					}
 					unRegisterCellTriggerEventList.clear();
 				}
@@ -3051,6 +3470,7 @@ namespace
 
 		void
 			ScriptManager::registerUnitTriggerEvent(int unitId) {
+			checkTriggerUnitId(unitId);
 			UnitTriggerEventList[unitId] = utet_None;
 		}
 
@@ -3196,8 +3616,7 @@ namespace
 			//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
 			if (UnitTriggerEventList.empty() == false) {
 				//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
-				std::map < int,
-					UnitTriggerEventType >::iterator
+				IdSlotMap < UnitTriggerEventType >::iterator
 					iterFind = UnitTriggerEventList.find(unit->getId());
 				if (iterFind != UnitTriggerEventList.end()) {
 					//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
@@ -3207,8 +3626,7 @@ namespace
 
 					//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
 
-					luaScript.beginCall("unitTriggerEvent");
-					luaScript.endCall();
+					callLuaEventHandler(leht_UnitTriggerEvent);
 
 					//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
 				}
@@ -3243,8 +3661,7 @@ namespace
 					printf("Triggering daynight event isDay: %d [%f]\n", isDay,
 						getTimeOfDay());
 
-					luaScript.beginCall("dayNightTriggerEvent");
-					luaScript.endCall();
+					callLuaEventHandler(leht_DayNightTriggerEvent);
 				}
 			}
 		}
@@ -6224,7 +6641,7 @@ namespace
 				intToStr(lastDayNightTriggerStatus),
 				mapTagReplacements);
 
-			for (std::map < int, UnitTriggerEventType >::iterator iterMap =
+			for (IdSlotMap < UnitTriggerEventType >::iterator iterMap =
 				UnitTriggerEventList.begin();
 				iterMap != UnitTriggerEventList.end(); ++iterMap) {
 				XmlNode *
@@ -6390,8 +6807,32 @@ namespace
 				CellTriggerEvent
 					event;
 				event.loadGame(node);
-				CellTriggerEventList[node->getAttribute("key")->getIntValue()] =
-					event;
+				int
+					eventId = node->getAttribute("key")->getIntValue();
+				if ((event.type == ctet_Unit || event.type == ctet_UnitPos ||
+					event.type == ctet_UnitAreaPos) &&
+					world->isUnitIdInRange(event.sourceId) == false) {
+					SystemFlags::OutputDebug(SystemFlags::debugError,
+						"In [%s::%s Line: %d] skipping cell trigger %d for invalid unit id: %d\n",
+						extractFileFromDirectoryPath(__FILE__).c_str(),
+						__FUNCTION__, __LINE__, eventId, event.sourceId);
+					continue;
+				}
+				for (std::map < int, string >::iterator iterMap =
+					event.eventStateInfo.begin();
+					iterMap != event.eventStateInfo.end();) {
+					if (world->isUnitIdInRange(iterMap->first) == false) {
+						SystemFlags::OutputDebug(SystemFlags::debugError,
+							"In [%s::%s Line: %d] dropping cell trigger %d state for invalid unit id: %d\n",
+							extractFileFromDirectoryPath(__FILE__).c_str(),
+							__FUNCTION__, __LINE__, eventId, iterMap->first);
+						event.eventStateInfo.erase(iterMap++);
+					} else {
+						++iterMap;
+					}
+				}
+				CellTriggerEventList[eventId] = event;
+				cellTriggerEventIndex.addEvent(eventId, event);
 			}
 
 			//      std::map<int,TimerTriggerEvent> TimerTriggerEventList;
@@ -6455,6 +6896,13 @@ namespace
 						static_cast <UnitTriggerEventType>
 						(node->getAttribute("evenType")->getIntValue());
 				}
+				if (world->isUnitIdInRange(unitId) == false) {
+					SystemFlags::OutputDebug(SystemFlags::debugError,
+						"In [%s::%s Line: %d] skipping unit trigger for invalid unit id: %d\n",
+						extractFileFromDirectoryPath(__FILE__).c_str(),
+						__FUNCTION__, __LINE__, unitId);
+					continue;
+				}
 				UnitTriggerEventList[unitId] = eventType;
 			}
 			if (scriptManagerNode->hasAttribute("lastUnitTriggerEventUnitId") ==
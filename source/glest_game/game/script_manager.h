@@ -25,6 +25,7 @@
 #   include <map>
 #   include "xml_parser.h"
 #   include "randomgen.h"
+#   include "id_slot_map.h"
 #   include "leak_dumper.h"
 #   include "platform_util.h"
 
@@ -42,6 +43,8 @@ using
 Shared::Xml::XmlNode;
 using
 Shared::Util::RandomGen;
+using
+Shared::Util::IdSlotMap;
 
 
 namespace
@@ -53,6 +56,8 @@ namespace
 			World;
 		class
 			Unit;
+		class
+			UnitType;
 		class
 			GameCamera;
 
@@ -185,6 +190,22 @@ namespace
 			utet_SkillChanged
 		};
 
+		// Lua event handlers looked up once the scenario code has run
+		enum LuaEventHandlerType {
+			leht_ResourceHarvested,
+			leht_UnitCreated,
+			leht_UnitDied,
+			leht_UnitAttacked,
+			leht_UnitAttacking,
+			leht_GameOver,
+			leht_TimerTriggerEvent,
+			leht_CellTriggerEvent,
+			leht_UnitTriggerEvent,
+			leht_DayNightTriggerEvent,
+
+			leht_Count
+		};
+
 		enum CellTriggerEventType {
 			ctet_Unit,
 			ctet_UnitPos,
@@ -229,6 +250,56 @@ namespace
 				loadGame(const XmlNode * rootNode);
 		};
 
+		// =====================================================
+		//      class CellTriggerEventIndex
+		//
+		///     Finds the cell trigger events a moving unit can possibly fire:
+		///     events bound to the unit or its faction, location events in
+		///     grid buckets under the unit, and area events the unit is in
+		// =====================================================
+
+		class
+			CellTriggerEventIndex {
+		private:
+			static const int
+				bucketCellSize = 16;
+
+			int
+				bucketsW;
+			int
+				bucketsH;
+			std::vector < std::vector < int > >
+				buckets;
+			IdSlotMap < std::vector < int > >
+				unitEvents;
+			std::map < int,
+				std::vector < int > >
+				factionEvents;
+			IdSlotMap < std::vector < int > >
+				unitInsideAreaEvents;
+
+			bool
+				getBucketRange(const CellTriggerEvent & event, Vec2i & bucketStart,
+					Vec2i & bucketEnd) const;
+
+		public:
+			CellTriggerEventIndex();
+
+			void
+				init(int mapW, int mapH);
+			void
+				clear();
+			void
+				addEvent(int eventId, const CellTriggerEvent & event);
+			void
+				removeEvent(int eventId, const CellTriggerEvent & event);
+			void
+				setUnitInsideArea(int unitId, int eventId, bool inside);
+			void
+				getCandidateEvents(int unitId, int factionIndex, const Vec2i & pos,
+					int unitSize, std::vector < int > &eventIdList) const;
+		};
+
 		class
 			TimerTriggerEvent {
 		public:
@@ -340,6 +411,8 @@ namespace
 			std::map < int,
 				CellTriggerEvent >
 				CellTriggerEventList;
+			CellTriggerEventIndex
+				cellTriggerEventIndex;
 			std::map < int,
 				TimerTriggerEvent >
 				TimerTriggerEventList;
@@ -353,8 +426,7 @@ namespace
 			int
 				lastDayNightTriggerStatus;
 
-			std::map < int,
-				UnitTriggerEventType >
+			IdSlotMap < UnitTriggerEventType >
 				UnitTriggerEventList;
 			int
 				lastUnitTriggerEventUnitId;
@@ -371,9 +443,19 @@ namespace
 				string >
 				luaSavedGameData;
 
+			bool
+				luaEventHandlersResolved;
+			int
+				luaEventHandlerRefs[leht_Count];
+			std::map < const UnitType *,
+				int >
+				unitCreatedOfTypeHandlerRefs;
+
 		private:
 			static ScriptManager *
 				thisScriptManager;
+			static const char *
+				luaEventHandlerNames[leht_Count];
 
 		private:
 			static const int
@@ -451,6 +533,17 @@ namespace
 		private:
 			string wrapString(const string & str, int wrapCount);
 
+			void
+				resolveLuaEventHandlers();
+			void
+				releaseLuaEventHandlers();
+			void
+				callLuaEventHandler(LuaEventHandlerType handlerType);
+			void
+				checkTriggerArea(const Vec2i & posStart, const Vec2i & posEnd) const;
+			void
+				checkTriggerUnitId(int unitId) const;
+
 			//wrappers, commands
 			void
 				networkShowMessageForFaction(const string & text,
@@ -119,6 +119,18 @@ namespace Glest {
 
 		map < string, string > Config::customRuntimeProperties;
 
+		std::atomic < int64 > Config::stringLookupCount(0);
+
+		static vector < ConfigHandleBase * >&getConfigHandleList() {
+			static vector < ConfigHandleBase * >configHandleList;
+			return configHandleList;
+		}
+
+		static Mutex & getConfigHandleListMutex() {
+			static Mutex configHandleListMutex(CODE_AT_LINE);
+			return configHandleListMutex;
+		}
+
 		// =====================================================
 		//      class Config
 		// =====================================================
@@ -436,6 +448,7 @@ namespace Glest {
 
 			Config & oldconfig = configList.find(type.first)->second;
 			CopyAll(&newconfig, &oldconfig);
+			oldconfig.refreshConfigHandles();
 
 			if (SystemFlags::VERBOSE_MODE_ENABLED)
 				if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).
@@ -467,6 +480,7 @@ namespace Glest {
 		}
 
 		int Config::getInt(const char *key, const char *defaultValueIfNotFound) const {
+			stringLookupCount.fetch_add(1, std::memory_order_relaxed);
 			if (tempProperties.hasString(key)) {
 				return tempProperties.getInt(key, defaultValueIfNotFound);
 			}
@@ -477,6 +491,7 @@ namespace Glest {
 		}
 
 		bool Config::getBool(const char *key, const char *defaultValueIfNotFound) const {
+			stringLookupCount.fetch_add(1, std::memory_order_relaxed);
 			if (tempProperties.hasString(key)) {
 				return tempProperties.getBool(key, defaultValueIfNotFound);
 			}
@@ -490,6 +505,7 @@ namespace Glest {
 
 		float Config::getFloat(const char *key,
 			const char *defaultValueIfNotFound) const {
+			stringLookupCount.fetch_add(1, std::memory_order_relaxed);
 			if (tempProperties.hasString(key)) {
 				return tempProperties.getFloat(key, defaultValueIfNotFound);
 			}
@@ -502,6 +518,7 @@ namespace Glest {
 		}
 
 		const string Config::getString(const char *key,	const char *defaultValueIfNotFound) const {
+			stringLookupCount.fetch_add(1, std::memory_order_relaxed);
 			if (tempProperties.hasString(key)) {
 				return tempProperties.getString(key, defaultValueIfNotFound);
 			}
@@ -515,6 +532,7 @@ namespace Glest {
 
 		int Config::getInt(const string & key,
 			const char *defaultValueIfNotFound) const {
+			stringLookupCount.fetch_add(1, std::memory_order_relaxed);
 			if (tempProperties.hasString(key)) {
 				return tempProperties.getInt(key, defaultValueIfNotFound);
 			}
@@ -528,6 +546,7 @@ namespace Glest {
 
 		bool Config::getBool(const string & key,
 			const char *defaultValueIfNotFound) const {
+			stringLookupCount.fetch_add(1, std::memory_order_relaxed);
 			if (tempProperties.hasString(key)) {
 				return tempProperties.getBool(key, defaultValueIfNotFound);
 			}
@@ -542,6 +561,7 @@ namespace Glest {
 
 		float Config::getFloat(const string & key,
 			const char *defaultValueIfNotFound) const {
+			stringLookupCount.fetch_add(1, std::memory_order_relaxed);
 			if (tempProperties.hasString(key)) {
 				return tempProperties.getFloat(key, defaultValueIfNotFound);
 			}
@@ -555,6 +575,7 @@ namespace Glest {
 
 		const string Config::getString(const string & key,
 			const char *defaultValueIfNotFound) const {
+			stringLookupCount.fetch_add(1, std::memory_order_relaxed);
 			if (tempProperties.hasString(key)) {
 				return tempProperties.getString(key, defaultValueIfNotFound);
 			}
@@ -673,56 +694,97 @@ namespace Glest {
 		void Config::setInt(const string & key, int value, bool tempBuffer) {
 			if (tempBuffer == true) {
 				tempProperties.setInt(key, value);
-				return;
-			}
-			if (fileLoaded.second == true) {
+			} else if (fileLoaded.second == true) {
 				properties.second.setInt(key, value);
-				return;
+			} else {
+				properties.first.setInt(key, value);
 			}
-			properties.first.setInt(key, value);
+			refreshConfigHandles(key);
 		}
 
 		void Config::setBool(const string & key, bool value, bool tempBuffer) {
 			if (tempBuffer == true) {
 				tempProperties.setBool(key, value);
-				return;
-			}
-
-			if (fileLoaded.second == true) {
+			} else if (fileLoaded.second == true) {
 				properties.second.setBool(key, value);
-				return;
+			} else {
+				properties.first.setBool(key, value);
 			}
-
-			properties.first.setBool(key, value);
+			refreshConfigHandles(key);
 		}
 
 		void Config::setFloat(const string & key, float value, bool tempBuffer) {
 			if (tempBuffer == true) {
 				tempProperties.setFloat(key, value);
-				return;
-			}
-
-			if (fileLoaded.second == true) {
+			} else if (fileLoaded.second == true) {
 				properties.second.setFloat(key, value);
-				return;
+			} else {
+				properties.first.setFloat(key, value);
 			}
-
-			properties.first.setFloat(key, value);
+			refreshConfigHandles(key);
 		}
 
 		void Config::setString(const string & key, const string & value,
 			bool tempBuffer) {
 			if (tempBuffer == true) {
 				tempProperties.setString(key, value);
+			} else if (fileLoaded.second == true) {
+				properties.second.setString(key, value);
+			} else {
+				properties.first.setString(key, value);
+			}
+			refreshConfigHandles(key);
+		}
+
+		void Config::refreshConfigHandles(const string & key) {
+			// Handles only track the main game configuration
+			if (cfgType.first != cfgMainGame) {
 				return;
 			}
+			MutexSafeWrapper safeMutex(&getConfigHandleListMutex(), CODE_AT_LINE);
+			vector < ConfigHandleBase * >&configHandleList = getConfigHandleList();
+			for (unsigned int index = 0; index < configHandleList.size(); ++index) {
+				ConfigHandleBase *handle = configHandleList[index];
+				if (key == "" || key == handle->getKey()) {
+					handle->refresh(*this);
+				}
+			}
+		}
 
-			if (fileLoaded.second == true) {
-				properties.second.setString(key, value);
+		// =====================================================
+		//      class ConfigHandleBase
+		// =====================================================
+
+		ConfigHandleBase::ConfigHandleBase(const char *key,
+			const char *defaultValueIfNotFound) {
+			this->key = key;
+			this->defaultValueIfNotFound = defaultValueIfNotFound;
+			this->resolved = false;
+		}
+
+		// Threads can reach a handle first at the same time, only one of
+		// them registers it
+		void ConfigHandleBase::resolve() {
+			Config & config = Config::getInstance();
+			MutexSafeWrapper safeMutex(&getConfigHandleListMutex(), CODE_AT_LINE);
+			if (resolved == true) {
 				return;
 			}
+			refresh(config);
+			getConfigHandleList().push_back(this);
+			resolved = true;
+		}
+
+		template <> void ConfigHandle < int >::refresh(const Config & config) {
+			value = config.getInt(key, defaultValueIfNotFound);
+		}
+
+		template <> void ConfigHandle < bool >::refresh(const Config & config) {
+			value = config.getBool(key, defaultValueIfNotFound);
+		}
 
-			properties.first.setString(key, value);
+		template <> void ConfigHandle < float >::refresh(const Config & config) {
+			value = config.getFloat(key, defaultValueIfNotFound);
 		}
 
 		vector < pair < string,
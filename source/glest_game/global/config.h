@@ -30,6 +30,7 @@
 
 #   include "properties.h"
 #   include <vector>
+#   include <atomic>
 #   include "game_constants.h"
 #   include <SDL.h>
 #   include "leak_dumper.h"
@@ -38,6 +39,9 @@ namespace Glest {
 	namespace Game {
 
 		using Shared::Util::Properties;
+		using Shared::Platform::int64;
+
+		class ConfigHandleBase;
 
 		// =====================================================
 		//      class Config
@@ -72,6 +76,8 @@ namespace Glest {
 
 			static map < string, string > customRuntimeProperties;
 
+			static std::atomic < int64 > stringLookupCount;
+
 		public:
 
 			static const char *glestkeys_ini_filename;
@@ -167,8 +173,72 @@ namespace Glest {
 
 			static string getMapPath(const string & mapName, string scenarioDir =
 				"", bool errorOnNotFound = true);
+
+			// Number of string keyed get calls made so far, used to find hot
+			// code that should be using a ConfigHandle instead
+			static int64 getStringLookupCount() {
+				return stringLookupCount.load(std::memory_order_relaxed);
+			}
+
+			void refreshConfigHandles(const string & key = "");
+		};
+
+		// =====================================================
+		//      class ConfigHandleBase
+		//
+		//      Typed handle to a main game setting. The value is
+		//      resolved once on first use and refreshed when the
+		//      configuration is reloaded or the setting changes, so
+		//      hot code reads a cached value instead of doing string
+		//      keyed property lookups. Handles must have static
+		//      storage duration.
+		// =====================================================
+
+		class ConfigHandleBase {
+		protected:
+			const char *key;
+			const char *defaultValueIfNotFound;
+			std::atomic < bool > resolved;
+
+			void resolve();
+
+		public:
+			ConfigHandleBase(const char *key, const char *defaultValueIfNotFound);
+			virtual ~ConfigHandleBase() {
+			}
+
+			const char *getKey() const {
+				return key;
+			}
+			virtual void refresh(const Config & config) = 0;
+		};
+
+		template < typename T > class ConfigHandle : public ConfigHandleBase {
+		private:
+			T value;
+
+		public:
+			ConfigHandle(const char *key, const char *defaultValueIfNotFound = NULL) :
+				ConfigHandleBase(key, defaultValueIfNotFound), value() {
+			}
+
+			inline T get() {
+				if (resolved == false) {
+					resolve();
+				}
+				return value;
+			}
+			virtual void refresh(const Config & config);
 		};
 
+		template <> void ConfigHandle < int >::refresh(const Config & config);
+		template <> void ConfigHandle < bool >::refresh(const Config & config);
+		template <> void ConfigHandle < float >::refresh(const Config & config);
+
+		typedef ConfigHandle < int > ConfigIntHandle;
+		typedef ConfigHandle < bool > ConfigBoolHandle;
+		typedef ConfigHandle < float > ConfigFloatHandle;
+
 	}
 }                              //end namespace
 
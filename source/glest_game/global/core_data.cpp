@@ -1133,6 +1133,10 @@ namespace Glest {
 		}
 		void CoreData::triggerFontChangedCallbacks(std::string fontUniqueId,
 			Font * font) {
+			// Measurements cached for the previous face are no longer valid
+			if (font != NULL) {
+				font->getMetrics()->clearTextCache();
+			}
 			for (std::map < std::string,
 				std::vector <
 				FontChangedCallbackInterface * > >::const_iterator iterMap =
@@ -24,6 +24,7 @@
 #include "core_data.h"
 #include "renderer.h"
 #include <algorithm>
+#include <functional>
 #include "config.h"
 #include "window.h"
 #include "leak_dumper.h"
@@ -37,6 +38,31 @@ namespace Glest {
 
 		const char *DEFAULT_LANGUAGE = "english";
 
+		// =====================================================
+		//      class LangStringTable
+		// =====================================================
+
+		LangStringTable::LangStringTable() {
+			for (int i = 0; i < maxPages; ++i) {
+				pages[i] = NULL;
+			}
+		}
+
+		LangStringTable::~LangStringTable() {
+			for (int i = 0; i < maxPages; ++i) {
+				delete[] pages[i].load();
+				pages[i] = NULL;
+			}
+		}
+
+		LangStringTable::Slot & LangStringTable::getSlot(int handle) {
+			std::atomic < Slot * >&page = pages[handle / pageSize];
+			if (page.load(std::memory_order_relaxed) == NULL) {
+				page.store(new Slot[pageSize], std::memory_order_release);
+			}
+			return page.load(std::memory_order_relaxed)[handle % pageSize];
+		}
+
 		// =====================================================
 		//      class Lang
 		// =====================================================
@@ -46,6 +72,29 @@ namespace Glest {
 			is_utf8_language = false;
 			allowNativeLanguageTechtree = true;
 			techNameLoaded = "";
+			techTreeStrings = NULL;
+			techTreeStringsDefault = NULL;
+			mutexStringHandles = new Mutex(CODE_AT_LINE);
+			stringHandleSlots = new StringHandleSlot[stringHandleSlotCount];
+			for (int i = 0; i < stringHandleSlotCount; ++i) {
+				stringHandleSlots[i].key = NULL;
+				stringHandleSlots[i].handle = -1;
+			}
+			stringTables.push_back(new LangStringTable());
+			stringTable = stringTables.back();
+			updateTechTreeStrings();
+		}
+
+		Lang::~Lang() {
+			for (unsigned int i = 0; i < stringTables.size(); ++i) {
+				delete stringTables[i];
+			}
+			stringTables.clear();
+			stringTable = NULL;
+			delete[] stringHandleSlots;
+			stringHandleSlots = NULL;
+			delete mutexStringHandles;
+			mutexStringHandles = NULL;
 		}
 
 		Lang & Lang::getInstance() {
@@ -68,6 +117,13 @@ namespace Glest {
 			loadGameStringProperties(uselanguage,
 				gameStringsAllLanguages[this->language], true,
 				fallbackToDefault);
+			updateTechTreeStrings();
+
+			// Strings of existing handles are resolved again into a new table
+			MutexSafeWrapper safeMutex(mutexStringHandles, CODE_AT_LINE);
+			stringTables.push_back(new LangStringTable());
+			stringTable.store(stringTables.back(), std::memory_order_release);
+			safeMutex.ReleaseLock();
 
 			if (languageChanged == true) {
 				Font::resetToDefaults();
@@ -462,9 +518,17 @@ namespace Glest {
 				}
 			}
 
+			updateTechTreeStrings();
 			return foundTranslation;
 		}
 
+		void Lang::updateTechTreeStrings() {
+			std::map < string, Properties > &techTreeLanguages =
+				techTreeStringsAllLanguages[techNameLoaded];
+			techTreeStrings = &techTreeLanguages[this->language];
+			techTreeStringsDefault = &techTreeLanguages["default"];
+		}
+
 		void Lang::loadTilesetStrings(string tileset) {
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).
 				enabled)
@@ -567,6 +631,71 @@ namespace Glest {
 		}
 
 		string Lang::getString(const string & s, string uselanguage) {
+			if (uselanguage == "") {
+				int handle = getStringHandle(s);
+				if (handle >= 0) {
+					return getStringByHandle(handle);
+				}
+			}
+			return lookupString(s, uselanguage);
+		}
+
+		int Lang::findStringHandle(const string & s) const {
+			unsigned int index = (unsigned int) std::hash < string > ()(s) & (stringHandleSlotCount - 1);
+			for (;;) {
+				const StringHandleSlot & slot = stringHandleSlots[index];
+				const string *key = slot.key.load(std::memory_order_acquire);
+				if (key == NULL) {
+					return -1;
+				}
+				if (*key == s) {
+					return slot.handle;
+				}
+				index = (index + 1) & (stringHandleSlotCount - 1);
+			}
+		}
+
+		int Lang::getStringHandle(const string & s) {
+			int handle = findStringHandle(s);
+			if (handle >= 0) {
+				return handle;
+			}
+
+			MutexSafeWrapper safeMutex(mutexStringHandles, CODE_AT_LINE);
+			handle = findStringHandle(s);
+			if (handle >= 0 || (int) stringHandleKeys.size() >= maxStringHandles) {
+				return handle;
+			}
+			handle = (int) stringHandleKeys.size();
+			stringHandleKeys.push_back(s);
+
+			// The table stays at most three quarters full, so a free slot
+			// is always found. The handle is set before the key publishes it.
+			unsigned int index = (unsigned int) std::hash < string > ()(s) & (stringHandleSlotCount - 1);
+			while (stringHandleSlots[index].key.load(std::memory_order_relaxed) != NULL) {
+				index = (index + 1) & (stringHandleSlotCount - 1);
+			}
+			stringHandleSlots[index].handle = handle;
+			stringHandleSlots[index].key.store(&stringHandleKeys.back(), std::memory_order_release);
+			return handle;
+		}
+
+		const string & Lang::resolveStringHandle(int handle) {
+			MutexSafeWrapper safeMutex(mutexStringHandles, CODE_AT_LINE);
+			if (handle < 0 || handle >= (int) stringHandleKeys.size()) {
+				throw megaglest_runtime_error("Invalid string handle: " +
+					intToStr(handle));
+			}
+			LangStringTable::Slot & slot =
+				stringTable.load(std::memory_order_relaxed)->getSlot(handle);
+			if (slot.resolved.load(std::memory_order_relaxed) == false) {
+				slot.value = lookupString(stringHandleKeys[handle], "");
+				slot.resolved.store(true, std::memory_order_release);
+			}
+			return slot.value;
+		}
+
+		string Lang::lookupString(const string & s, string uselanguage) {
 			string result = "";
 
 			if (uselanguage != "") {
@@ -587,7 +716,7 @@ namespace Glest {
 
 			if (uselanguage != DEFAULT_LANGUAGE
 				&& this->language != DEFAULT_LANGUAGE) {
-				return getString(s, DEFAULT_LANGUAGE);
+				return lookupString(s, DEFAULT_LANGUAGE);
 			}
 
 			return s;
@@ -607,27 +736,26 @@ namespace Glest {
 
 		string Lang::getTechTreeString(const string & s, const char *defaultValue) {
 			string result = "";
-			string default_language = "default";
 
 			//printf("Line: %d techNameLoaded = %s s = %s this->language = %s\n",__LINE__,techNameLoaded.c_str(),s.c_str(),this->language.c_str());
 
 			if (allowNativeLanguageTechtree == true && 
-				(techTreeStringsAllLanguages[techNameLoaded][this->language].hasString(s) == true || defaultValue == NULL)) {
-				if (techTreeStringsAllLanguages[techNameLoaded][this->language].hasString(s) == false && 
-					techTreeStringsAllLanguages[techNameLoaded][default_language].hasString(s) == true) {
+				(techTreeStrings->hasString(s) == true || defaultValue == NULL)) {
+				if (techTreeStrings->hasString(s) == false && 
+					techTreeStringsDefault->hasString(s) == true) {
 
 					//printf("Line: %d techNameLoaded = %s s = %s this->language = %s\n",__LINE__,techNameLoaded.c_str(),s.c_str(),this->language.c_str());
 
-					result = techTreeStringsAllLanguages[techNameLoaded][default_language].getString(s);
+					result = techTreeStringsDefault->getString(s);
 				} else {
 					//printf("Line: %d techNameLoaded = %s s = %s this->language = %s\n",__LINE__,techNameLoaded.c_str(),s.c_str(),this->language.c_str());
-					result = techTreeStringsAllLanguages[techNameLoaded][this->language].getString(s);
+					result = techTreeStrings->getString(s);
 				}
-			} else if (allowNativeLanguageTechtree == true && techTreeStringsAllLanguages[techNameLoaded][default_language].hasString(s) == true) {
+			} else if (allowNativeLanguageTechtree == true && techTreeStringsDefault->hasString(s) == true) {
 
 				//printf("Line: %d techNameLoaded = %s s = %s this->language = %s\n",__LINE__,techNameLoaded.c_str(),s.c_str(),this->language.c_str());
 
-				result = techTreeStringsAllLanguages[techNameLoaded][default_language].getString(s);
+				result = techTreeStringsDefault->getString(s);
 			} else if (defaultValue != NULL) {
 				result = defaultValue;
 			}
@@ -17,13 +17,65 @@
 #      include <winsock.h>
 #   endif
 
+#   include <atomic>
+#   include <deque>
 #   include "properties.h"
+#   include "thread.h"
 #   include "leak_dumper.h"
 
 namespace Glest {
 	namespace Game {
 
 		using Shared::Util::Properties;
+		using Shared::Platform::Mutex;
+
+		// =====================================================
+		//      class LangStringTable
+		//
+		//      Processed strings of one loaded language by handle.
+		//      A slot is written once under the Lang handle mutex
+		//      and never changes after that, so readers need no lock
+		//      and references to the strings stay valid.
+		// =====================================================
+
+		class LangStringTable {
+		public:
+			static const int pageSize = 256;
+			static const int maxPages = 96;
+
+			class Slot {
+			public:
+				std::atomic < bool > resolved;
+				string value;
+
+				Slot() : resolved(false) {
+				}
+			};
+
+		private:
+			std::atomic < Slot * > pages[maxPages];
+
+			LangStringTable(LangStringTable &);
+			void operator =(LangStringTable &);
+
+		public:
+			LangStringTable();
+			~LangStringTable();
+
+			inline const string *findString(int handle) const {
+				if (handle < 0 || handle >= pageSize * maxPages) {
+					return NULL;
+				}
+				const Slot *page = pages[handle / pageSize].load(std::memory_order_acquire);
+				if (page == NULL) {
+					return NULL;
+				}
+				const Slot & slot = page[handle % pageSize];
+				return (slot.resolved.load(std::memory_order_acquire) == true ? &slot.value : NULL);
+			}
+			// Only with the Lang handle mutex held
+			Slot & getSlot(int handle);
+		};
 
 		// =====================================================
 		//      class Lang
@@ -47,9 +99,36 @@ namespace Glest {
 				Properties > >techTreeStringsAllLanguages;
 			string techNameLoaded;
 			bool allowNativeLanguageTechtree;
+			Properties *techTreeStrings;
+			Properties *techTreeStringsDefault;
+
+			// Keys are interned to handles through an open addressing
+			// table that is read without the lock, slots are only ever
+			// added. Each loadGameStrings starts a new string table,
+			// earlier ones stay alive for the references handed out.
+			static const int maxStringHandles =
+				LangStringTable::pageSize * LangStringTable::maxPages;
+			static const int stringHandleSlotCount = 32768;
+
+			class StringHandleSlot {
+			public:
+				std::atomic < const string *>key;
+				int handle;
+			};
+
+			Mutex *mutexStringHandles;
+			std::deque < string > stringHandleKeys;
+			StringHandleSlot *stringHandleSlots;
+			std::atomic < LangStringTable * >stringTable;
+			vector < LangStringTable * >stringTables;
 
 		private:
 			Lang();
+			~Lang();
+			void updateTechTreeStrings();
+			string lookupString(const string & s, string uselanguage);
+			int findStringHandle(const string & s) const;
+			const string & resolveStringHandle(int handle);
 			void loadGameStringProperties(string language, Properties & properties,
 				bool fileMustExist,
 				bool fallbackToDefault = false);
@@ -81,6 +160,13 @@ namespace Glest {
 			void loadTilesetStrings(string tileset);
 
 			string getString(const string & s, string uselanguage = "");
+			// Returns -1 once the handle table is full
+			int getStringHandle(const string & s);
+			inline const string & getStringByHandle(int handle) {
+				const string *result =
+					stringTable.load(std::memory_order_acquire)->findString(handle);
+				return (result != NULL ? *result : resolveStringHandle(handle));
+			}
 			bool hasString(const string & s, string uselanguage =
 				"", bool fallbackToDefault = false);
 
@@ -26,6 +26,7 @@
 #include "factory_repository.h"
 #include <cstdlib>
 #include "cache_manager.h"
+#include "residency_manager.h"
 #include "network_manager.h"
 #include <algorithm>
 #include <iterator>
@@ -42,6 +43,8 @@ namespace Glest {
 		uint32 Renderer::SurfaceData::nextUniqueId = 1;
 		bool Renderer::renderText3DEnabled = true;
 
+		static ConfigBoolHandle configBatchedObjectRendering("BatchedObjectRendering", "true");
+
 		//const float SKIP_INTERPOLATION_DISTANCE = 20.0f;
 		const string DEFAULT_CHAR_FOR_WIDTH_CALC = "V";
 
@@ -122,6 +125,11 @@ namespace Glest {
 			maxLights = 0;
 			waterAnim = 0;
 
+			previousRenderSnapshot = NULL;
+			currentRenderSnapshot = NULL;
+			renderSnapshotBlend = 1.0f;
+			uploadedFowTexHandle = 0;
+
 			this->allowRenderUnitTitles = false;
 			this->menu = NULL;
 			this->game = NULL;
@@ -275,6 +283,10 @@ namespace Glest {
 				quadCache = VisibleQuadContainerCache();
 				quadCache.clearFrustumData();
 
+				delete previousRenderSnapshot;
+				previousRenderSnapshot = NULL;
+				currentRenderSnapshot = NULL;
+
 				if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
 
 				this->menu = NULL;
@@ -697,6 +709,7 @@ namespace Glest {
 		void Renderer::endGame(bool isFinalEnd) {
 			this->game = NULL;
 			this->gameCamera = NULL;
+			currentRenderSnapshot = NULL;
 			Config &config = Config::getInstance();
 
 			try {
@@ -711,6 +724,9 @@ namespace Glest {
 				abort();
 			}
 
+			// cached terrain chunks reference this game's map and textures
+			mapRenderer.destroy();
+
 			if (isFinalEnd) {
 				//delete resources
 				if (modelManager[rsGame] != NULL) {
@@ -952,6 +968,7 @@ namespace Glest {
 			//glFlush();
 
 			GraphicsInterface::getInstance().getCurrentContext()->swapBuffers();
+			ResidencyManager::nextFrame();
 		}
 
 		// ==================== lighting ====================
@@ -1811,6 +1828,8 @@ namespace Glest {
 
 			Vec4f fontColor;
 			Lang &lang = Lang::getInstance();
+			static const int teamHandle = lang.getStringHandle("Team");
+			static const int systemUserHandle = lang.getStringHandle("SystemUser");
 			//const Metrics &metrics= Metrics::getInstance();
 			FontMetrics *fontMetrics = font->getMetrics();
 
@@ -1837,7 +1856,7 @@ namespace Glest {
 						playerName = lineInfo->originalPlayerName;
 					}
 					if (playerName == GameConstants::NETWORK_SLOT_UNCONNECTED_SLOTNAME) {
-						playerName = lang.getString("SystemUser");
+						playerName = lang.getStringByHandle(systemUserHandle);
 					}
 					//printf("playerName [%s], line [%s]\n",playerName.c_str(),line.c_str());
 
@@ -1845,7 +1864,7 @@ namespace Glest {
 					//string headerLine = playerName + ": ";
 					string headerLine = playerName;
 					if (lineInfo->teamMode == true) {
-						headerLine += " (" + lang.getString("Team") + ")";
+						headerLine += " (" + lang.getStringByHandle(teamHandle) + ")";
 					}
 					headerLine += ": ";
 
@@ -1871,7 +1890,7 @@ namespace Glest {
 				//string headerLine = playerName + ": ";
 				string headerLine = playerName;
 				if (lineInfo->teamMode == true) {
-					headerLine += " (" + lang.getString("Team") + ")";
+					headerLine += " (" + lang.getStringByHandle(teamHandle) + ")";
 				}
 				headerLine += ": ";
 
@@ -1912,6 +1931,7 @@ namespace Glest {
 
 			Vec4f fontColor;
 			Lang &lang = Lang::getInstance();
+			static const int teamHandle = lang.getStringHandle("Team");
 
 			const Metrics &metrics = Metrics::getInstance();
 			FontMetrics *fontMetrics = font->getMetrics();
@@ -1944,7 +1964,7 @@ namespace Glest {
 					//string headerLine = playerName + ": ";
 					string headerLine = playerName;
 					if (lineInfo->teamMode == true) {
-						headerLine += " (" + lang.getString("Team") + ")";
+						headerLine += " (" + lang.getStringByHandle(teamHandle) + ")";
 					}
 					headerLine += ": ";
 
@@ -1968,7 +1988,7 @@ namespace Glest {
 				//string headerLine = playerName + ": ";
 				string headerLine = playerName;
 				if (lineInfo->teamMode == true) {
-					headerLine += " (" + lang.getString("Team") + ")";
+					headerLine += " (" + lang.getStringByHandle(teamHandle) + ")";
 				}
 				headerLine += ": ";
 
@@ -2108,19 +2128,23 @@ namespace Glest {
 
 			Vec4f fontColor;
 			Lang &lang = Lang::getInstance();
+			static const int cellHintHandle = lang.getStringHandle("CellHint");
+			static const int chatHandle = lang.getStringHandle("Chat");
+			static const int teamHandle = lang.getStringHandle("Team");
+			static const int allHandle = lang.getStringHandle("All");
 
 			if (chatManager->getEditEnabled()) {
 				Vec4f color = Vec4f(0.0f, 0.0f, 0.0f, 0.6f);
 				string text = "";
 
 				if (chatManager->isInCustomInputMode() == true) {
-					text += lang.getString("CellHint");
+					text += lang.getStringByHandle(cellHintHandle);
 				} else if (chatManager->getInMenu()) {
-					text += lang.getString("Chat");
+					text += lang.getStringByHandle(chatHandle);
 				} else if (chatManager->getTeamMode()) {
-					text += lang.getString("Team");
+					text += lang.getStringByHandle(teamHandle);
 				} else {
-					text += lang.getString("All");
+					text += lang.getStringByHandle(allHandle);
 				}
 				text += ": " + chatManager->getText() + "_";
 
@@ -2235,13 +2259,14 @@ namespace Glest {
 
 			if (config.getBool("InGameClock", "true") == true) {
 				Lang &lang = Lang::getInstance();
+				static const int gameDurationTimeHandle = lang.getStringHandle("GameDurationTime");
 				char szBuf[501] = "";
 
 				//int hours = world->getTimeFlow()->getTime();
 				//int minutes = (world->getTimeFlow()->getTime() - hours) * 100 * 0.6; // scale 100 to 60
 				//snprintf(szBuf,200,"%s %.2d:%.2d",lang.getString("GameTime","",true).c_str(),hours,minutes);
 				// string header2 = lang.getString("GameDurationTime","",true) + ": " + getTimeString(stats.getFramesToCalculatePlaytime());
-				snprintf(szBuf, 500, "%s %s", lang.getString("GameDurationTime", "").c_str(), getTimeDuationString(world->getFrameCount(), GameConstants::updateFps).c_str());
+				snprintf(szBuf, 500, "%s %s", lang.getStringByHandle(gameDurationTimeHandle).c_str(), getTimeDuationString(world->getFrameCount(), GameConstants::updateFps).c_str());
 				if (str != "") {
 					str += " ";
 				}
@@ -2256,8 +2281,9 @@ namespace Glest {
 				strftime(szBuf2, 100, "%H:%M", &loctime);
 
 				Lang &lang = Lang::getInstance();
+				static const int localTimeHandle = lang.getStringHandle("LocalTime");
 				char szBuf[200] = "";
-				snprintf(szBuf, 200, "%s %s", lang.getString("LocalTime", "").c_str(), szBuf2);
+				snprintf(szBuf, 200, "%s %s", lang.getStringByHandle(localTimeHandle).c_str(), szBuf2);
 				if (str != "") {
 					str += " ";
 				}
@@ -3939,21 +3965,19 @@ namespace Glest {
 
 		}
 
-		template<typename T> void _loadVBO(GLuint &vbo, std::vector<T> buf, int target = GL_ARRAY_BUFFER_ARB) {
+		template<typename T> void _loadVBO(GLuint &vbo, const std::vector<T> &buf, int target = GL_ARRAY_BUFFER_ARB) {
 			assert(buf.size());
-			if (true /* vbo enabled? */) {
-				glGenBuffersARB(1, &vbo);
-				assert(vbo);
-				glBindBufferARB(target, vbo);
-				glBufferDataARB(target, sizeof(T)*buf.size(), &buf[0], GL_STATIC_DRAW_ARB);
-				glBindBufferARB(target, 0);
-				assertGl();
-				buf.clear();
-			}
+			glGenBuffersARB(1, &vbo);
+			assert(vbo);
+			glBindBufferARB(target, vbo);
+			glBufferDataARB(target, sizeof(T)*buf.size(), &buf[0], GL_STATIC_DRAW_ARB);
+			glBindBufferARB(target, 0);
+			assertGl();
 		}
 
 		void Renderer::MapRenderer::Layer::load_vbos(bool vboEnabled) {
 			indexCount = (int) indices.size();
+			vertexCount = (int) vertices.size();
 			if (vboEnabled) {
 				_loadVBO(vbo_vertices, vertices);
 				_loadVBO(vbo_normals, normals);
@@ -3961,6 +3985,13 @@ namespace Glest {
 				_loadVBO(vbo_surfTexCoords, surfTexCoords);
 
 				_loadVBO(vbo_indices, indices, GL_ELEMENT_ARRAY_BUFFER_ARB);
+
+				// the data lives in the buffers now
+				std::vector<Vec3f>().swap(vertices);
+				std::vector<Vec3f>().swap(normals);
+				std::vector<Vec2f>().swap(fowTexCoords);
+				std::vector<Vec2f>().swap(surfTexCoords);
+				std::vector<GLuint>().swap(indices);
 			} else {
 				vbo_vertices = 0;
 				vbo_normals = 0;
@@ -3970,118 +4001,48 @@ namespace Glest {
 			}
 		}
 
-		void Renderer::MapRenderer::loadVisibleLayers(float coordStep, VisibleQuadContainerCache &qCache) {
-			int totalCellCount = 0;
-			// we create a layer for each visible texture in the map
-			for (int visibleIndex = 0;
-				visibleIndex < (int) qCache.visibleScaledCellList.size(); ++visibleIndex) {
-				Vec2i &pos = qCache.visibleScaledCellList[visibleIndex];
-
-				totalCellCount++;
-
-				SurfaceCell *tc00 = map->getSurfaceCell(pos.x, pos.y);
-				SurfaceCell *tc10 = map->getSurfaceCell(pos.x + 1, pos.y);
-				SurfaceCell *tc01 = map->getSurfaceCell(pos.x, pos.y + 1);
-				SurfaceCell *tc11 = map->getSurfaceCell(pos.x + 1, pos.y + 1);
-
-				const Vec2f &surfCoord = tc00->getSurfTexCoord();
-
-				SurfaceCell *tc[4] = {
-						tc00,
-						tc10,
-						tc01,
-						tc11
-				};
-				int textureHandle = static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture())->getHandle();
-				string texturePath = static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture())->getPath();
-				//int32 textureCRC = CalculatePixelsCRC(static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture()));
-				Layer* layer = NULL;
-				for (Layers::iterator it = layers.begin(); it != layers.end(); ++it) {
-					if ((*it)->textureHandle == textureHandle) {
-						//if((*it)->texturePath == texturePath) {
-						//if((*it)->textureCRC == textureCRC) {
-						layer = *it;
-						break;
-					}
-				}
-				if (!layer) {
-					layer = new Layer(textureHandle);
-					layer->texturePath = texturePath;
-					//layer->textureCRC = textureCRC;
-					layers.push_back(layer);
-
-					//printf("Ading new unique texture [%s]\n",texturePath.c_str());
-				}
-				// we'll be super-lazy and re-emit all four corners just because its easier
-				int index[4];
-				int loopIndexes[4] = { 2,0,3,1 };
-				for (int i = 0; i < 4; i++) {
-					index[i] = (int) layer->vertices.size();
-					SurfaceCell *corner = tc[loopIndexes[i]];
-
-					layer->vertices.push_back(corner->getVertex());
-					layer->normals.push_back(corner->getNormal());
-					layer->fowTexCoords.push_back(corner->getFowTexCoord());
-				}
-
-				layer->surfTexCoords.push_back(Vec2f(surfCoord.x, surfCoord.y + coordStep));
-				layer->surfTexCoords.push_back(Vec2f(surfCoord.x, surfCoord.y));
-				layer->surfTexCoords.push_back(Vec2f(surfCoord.x + coordStep, surfCoord.y + coordStep));
-				layer->surfTexCoords.push_back(Vec2f(surfCoord.x + coordStep, surfCoord.y));
-
-				// and make two triangles (no strip, we may be disjoint)
-				layer->indices.push_back(index[0]);
-				layer->indices.push_back(index[1]);
-				layer->indices.push_back(index[2]);
-				layer->indices.push_back(index[1]);
-				layer->indices.push_back(index[3]);
-				layer->indices.push_back(index[2]);
-
-			}
-			// turn them into vbos (actually this method will just calc the index count)
-			for (Layers::iterator layer = layers.begin(); layer != layers.end(); ++layer) {
-				(*layer)->load_vbos(false);
+		Renderer::MapRenderer::Chunk::~Chunk() {
+			while (layers.empty() == false) {
+				delete layers.back();
+				layers.pop_back();
 			}
-
-			//printf("Total # of layers for this map = %d totalCellCount = %d overall render reduction ratio = %d times\n",layers.size(),totalCellCount,(totalCellCount / layers.size()));
 		}
 
-		void Renderer::MapRenderer::load(float coordStep) {
-			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
-				return;
+		void Renderer::MapRenderer::loadChunk(Chunk *chunk, int chunkX, int chunkY) {
+			while (chunk->layers.empty() == false) {
+				delete chunk->layers.back();
+				chunk->layers.pop_back();
 			}
 
-			int totalCellCount = 0;
-			// we create a layer for each texture in the map
-			for (int y = 0; y < map->getSurfaceH() - 1; y++) {
-				for (int x = 0; x < map->getSurfaceW() - 1; x++) {
-					totalCellCount++;
+			int fromX = chunkX * Map::surfaceChunkSize;
+			int fromY = chunkY * Map::surfaceChunkSize;
+			int toX = min(fromX + Map::surfaceChunkSize, map->getSurfaceW() - 1);
+			int toY = min(fromY + Map::surfaceChunkSize, map->getSurfaceH() - 1);
 
+			// we create a layer for each texture in the chunk
+			for (int y = fromY; y < toY; y++) {
+				for (int x = fromX; x < toX; x++) {
 					SurfaceCell *tc[4] = {
 						map->getSurfaceCell(x,y),
 						map->getSurfaceCell(x + 1,y),
 						map->getSurfaceCell(x,y + 1),
 						map->getSurfaceCell(x + 1,y + 1)
 					};
+					if (tc[0]->getSurfaceTexture() == NULL) {
+						throw megaglest_runtime_error("tc00->getSurfaceTexture() == NULL");
+					}
 					int textureHandle = static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture())->getHandle();
-					string texturePath = static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture())->getPath();
-					//int32 textureCRC = CalculatePixelsCRC(static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture()));
 					Layer* layer = NULL;
-					for (Layers::iterator it = layers.begin(); it != layers.end(); ++it) {
+					for (Layers::iterator it = chunk->layers.begin(); it != chunk->layers.end(); ++it) {
 						if ((*it)->textureHandle == textureHandle) {
-							//if((*it)->texturePath == texturePath) {
-							//if((*it)->textureCRC == textureCRC) {
 							layer = *it;
 							break;
 						}
 					}
 					if (!layer) {
 						layer = new Layer(textureHandle);
-						layer->texturePath = texturePath;
-						//layer->textureCRC = textureCRC;
-						layers.push_back(layer);
-
-						//printf("Ading new unique texture [%s]\n",texturePath.c_str());
+						layer->texturePath = static_cast<const Texture2DGl*>(tc[0]->getSurfaceTexture())->getPath();
+						chunk->layers.push_back(layer);
 					}
 					// we'll be super-lazy and re-emit all four corners just because its easier
 					int index[4];
@@ -4091,21 +4052,15 @@ namespace Glest {
 						SurfaceCell *corner = tc[loopIndexes[i]];
 						layer->vertices.push_back(corner->getVertex());
 						layer->normals.push_back(corner->getNormal());
+						layer->fowTexCoords.push_back(corner->getFowTexCoord());
 					}
 
 					// the texture coords are all on the current texture obviously
-					layer->fowTexCoords.push_back(tc[loopIndexes[0]]->getFowTexCoord());
-					layer->fowTexCoords.push_back(tc[loopIndexes[1]]->getFowTexCoord());
-					layer->fowTexCoords.push_back(tc[loopIndexes[2]]->getFowTexCoord());
-					layer->fowTexCoords.push_back(tc[loopIndexes[3]]->getFowTexCoord());
-
 					layer->surfTexCoords.push_back(tc[0]->getSurfTexCoord() + Vec2f(0, coordStep));
 					layer->surfTexCoords.push_back(tc[0]->getSurfTexCoord() + Vec2f(0, 0));
 					layer->surfTexCoords.push_back(tc[0]->getSurfTexCoord() + Vec2f(coordStep, coordStep));
 					layer->surfTexCoords.push_back(tc[0]->getSurfTexCoord() + Vec2f(coordStep, 0));
 
-					layer->cellToIndicesMap[Vec2i(x, y)] = (int) layer->indices.size();
-
 					// and make two triangles (no strip, we may be disjoint)
 					layer->indices.push_back(index[0]);
 					layer->indices.push_back(index[1]);
@@ -4116,11 +4071,29 @@ namespace Glest {
 				}
 			}
 			// turn them into vbos
-			for (Layers::iterator layer = layers.begin(); layer != layers.end(); ++layer) {
-				(*layer)->load_vbos(true);
+			for (Layers::iterator layer = chunk->layers.begin(); layer != chunk->layers.end(); ++layer) {
+				(*layer)->load_vbos(vboEnabled);
 			}
+		}
+
+		void Renderer::MapRenderer::updateVisibleChunks(VisibleQuadContainerCache &qCache) {
+			int chunkW = map->getSurfaceChunkW();
+			std::vector<bool> chunkVisible(chunks.size(), false);
 
-			//printf("Total # of layers for this map = %d totalCellCount = %d overall render reduction ratio = %d times\n",layers.size(),totalCellCount,(totalCellCount / layers.size()));
+			visibleChunks.clear();
+			for (int visibleIndex = 0;
+				visibleIndex < (int) qCache.visibleScaledCellList.size(); ++visibleIndex) {
+				const Vec2i &pos = qCache.visibleScaledCellList[visibleIndex];
+				int chunkIndex = (pos.y / Map::surfaceChunkSize) * chunkW + (pos.x / Map::surfaceChunkSize);
+				if (chunkIndex >= 0 && chunkIndex < (int) chunks.size() && chunkVisible[chunkIndex] == false) {
+					chunkVisible[chunkIndex] = true;
+					visibleChunks.push_back(chunkIndex);
+				}
+			}
+			std::sort(visibleChunks.begin(), visibleChunks.end());
+
+			lastVisibleQuad = qCache.lastVisibleQuad;
+			visibleChunksValid = true;
 		}
 
 		template<typename T> void* _bindVBO(GLuint vbo, std::vector<T> &buf, int target = GL_ARRAY_BUFFER_ARB) {
@@ -4133,131 +4106,39 @@ namespace Glest {
 			return result;
 		}
 
-		void Renderer::MapRenderer::Layer::renderVisibleLayer() {
-			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+		void Renderer::MapRenderer::Layer::render() {
+			if (indexCount == 0) {
 				return;
 			}
 
-			//glBindTexture(GL_TEXTURE_2D, static_cast<const Texture2DGl*>(fowTex)->getHandle());
-			glClientActiveTexture(Renderer::fowTexUnit);
-			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-			glTexCoordPointer(2, GL_FLOAT, 0, &fowTexCoords[0]);
-
-			glBindTexture(GL_TEXTURE_2D, textureHandle);
-			glClientActiveTexture(Renderer::baseTexUnit);
-			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-			glTexCoordPointer(2, GL_FLOAT, 0, &surfTexCoords[0]);
-
-			glVertexPointer(3, GL_FLOAT, 0, &vertices[0]);
-			glNormalPointer(GL_FLOAT, 0, &normals[0]);
-
-			//glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices.size());
-			//unsigned short faceIndices[4] = {0, 1, 2, 3};
-			//glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, &faceIndices[0]);
-			glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, &indices[0]);
+			glVertexPointer(3, GL_FLOAT, 0, _bindVBO(vbo_vertices, vertices));
+			glNormalPointer(GL_FLOAT, 0, _bindVBO(vbo_normals, normals));
 
 			glClientActiveTexture(Renderer::fowTexUnit);
-			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-			glClientActiveTexture(Renderer::baseTexUnit);
-			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-		}
-
-		void Renderer::MapRenderer::Layer::render(VisibleQuadContainerCache &qCache) {
-			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
-				return;
-			}
-
-			//	const bool renderOnlyVisibleQuad = true;
-			//
-			//	if(renderOnlyVisibleQuad == true) {
-			vector<pair<int, int> > rowsToRender;
-
-			if (rowsToRenderCache.find(qCache.lastVisibleQuad) != rowsToRenderCache.end()) {
-				rowsToRender = rowsToRenderCache[qCache.lastVisibleQuad];
-			} else {
-				int startIndex = -1;
-				int lastValidIndex = -1;
+			glTexCoordPointer(2, GL_FLOAT, 0, _bindVBO(vbo_fowTexCoords, fowTexCoords));
 
-				for (int visibleIndex = 0;
-					visibleIndex < (int) qCache.visibleScaledCellList.size(); ++visibleIndex) {
-					Vec2i &pos = qCache.visibleScaledCellList[visibleIndex];
-
-					if (cellToIndicesMap.find(pos) != cellToIndicesMap.end()) {
-						//printf("Layer Render, visibleindex = %d pos [%s] cellToIndicesMap[pos] = %d lastValidIndex = %d\n",visibleIndex,pos.getString().c_str(),cellToIndicesMap[pos],lastValidIndex);
-
-						if (startIndex < 0 || cellToIndicesMap[pos] == lastValidIndex + 6) {
-							lastValidIndex = cellToIndicesMap[pos];
-							if (startIndex < 0) {
-								startIndex = lastValidIndex;
-							}
-						} else if (startIndex >= 0) {
-							rowsToRender.push_back(make_pair(startIndex, lastValidIndex));
-
-							lastValidIndex = cellToIndicesMap[pos];
-							startIndex = lastValidIndex;
-						}
-					}
-				}
-				if (startIndex >= 0) {
-					rowsToRender.push_back(make_pair(startIndex, lastValidIndex));
-				}
-
-				rowsToRenderCache[qCache.lastVisibleQuad] = rowsToRender;
-			}
-
-			if (rowsToRender.empty() == false) {
-				//printf("Layer has %d rows in visible quad, visible quad has %d cells\n",rowsToRender.size(),qCache.visibleScaledCellList.size());
-
-				glVertexPointer(3, GL_FLOAT, 0, _bindVBO(vbo_vertices, vertices));
-				glNormalPointer(GL_FLOAT, 0, _bindVBO(vbo_normals, normals));
-
-				glClientActiveTexture(Renderer::fowTexUnit);
-				glTexCoordPointer(2, GL_FLOAT, 0, _bindVBO(vbo_fowTexCoords, fowTexCoords));
-
-				glClientActiveTexture(Renderer::baseTexUnit);
-				glBindTexture(GL_TEXTURE_2D, textureHandle);
-				glTexCoordPointer(2, GL_FLOAT, 0, _bindVBO(vbo_surfTexCoords, surfTexCoords));
+			glClientActiveTexture(Renderer::baseTexUnit);
+			glBindTexture(GL_TEXTURE_2D, textureHandle);
+			glTexCoordPointer(2, GL_FLOAT, 0, _bindVBO(vbo_surfTexCoords, surfTexCoords));
 
-				for (unsigned int i = 0; i < rowsToRender.size(); ++i) {
-					//glDrawElements(GL_TRIANGLES,indexCount,GL_UNSIGNED_INT,_bindVBO(vbo_indices,indices,GL_ELEMENT_ARRAY_BUFFER_ARB));
-					glDrawRangeElements(GL_TRIANGLES, rowsToRender[i].first, rowsToRender[i].second, indexCount, GL_UNSIGNED_INT, _bindVBO(vbo_indices, indices, GL_ELEMENT_ARRAY_BUFFER_ARB));
-				}
-			}
-			//	}
-			//	else {
-			//		glVertexPointer(3,GL_FLOAT,0,_bindVBO(vbo_vertices,vertices));
-			//		glNormalPointer(GL_FLOAT,0,_bindVBO(vbo_normals,normals));
-			//
-			//		glClientActiveTexture(Renderer::fowTexUnit);
-			//		glTexCoordPointer(2,GL_FLOAT,0,_bindVBO(vbo_fowTexCoords,fowTexCoords));
-			//
-			//		glClientActiveTexture(Renderer::baseTexUnit);
-			//		glBindTexture(GL_TEXTURE_2D,textureHandle);
-			//		glTexCoordPointer(2,GL_FLOAT,0,_bindVBO(vbo_surfTexCoords,surfTexCoords));
-			//
-			//		glDrawElements(GL_TRIANGLES,indexCount,GL_UNSIGNED_INT,_bindVBO(vbo_indices,indices,GL_ELEMENT_ARRAY_BUFFER_ARB));
-			//	}
+			glDrawRangeElements(GL_TRIANGLES, 0, vertexCount - 1, indexCount, GL_UNSIGNED_INT, _bindVBO(vbo_indices, indices, GL_ELEMENT_ARRAY_BUFFER_ARB));
 		}
 
-		void Renderer::MapRenderer::renderVisibleLayers(const Map* map, float coordStep, VisibleQuadContainerCache &qCache) {
+		void Renderer::MapRenderer::render(const Map* map, float coordStep, VisibleQuadContainerCache &qCache, bool vboEnabled, int &triangleCount, int &pointCount) {
 			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
 				return;
 			}
 
-			if (map != this->map) {
-				//printf("New Map loading\n");
+			if (map != this->map || vboEnabled != this->vboEnabled || coordStep != this->coordStep) {
 				destroy(); // clear any previous map data
 				this->map = map;
-				loadVisibleLayers(coordStep, qCache);
-			} else if (lastVisibleQuad != qCache.lastVisibleQuad) {
-				//printf("New Visible Quad loading\n");
-				destroy(); // clear any previous map data
-				this->map = map;
-				loadVisibleLayers(coordStep, qCache);
+				this->vboEnabled = vboEnabled;
+				this->coordStep = coordStep;
+				chunks.resize(map->getSurfaceChunkW() * map->getSurfaceChunkH(), NULL);
+			}
+			if (visibleChunksValid == false || lastVisibleQuad != qCache.lastVisibleQuad) {
+				updateVisibleChunks(qCache);
 			}
-
-			lastVisibleQuad = qCache.lastVisibleQuad;
-			//printf("About to render %d layers\n",layers.size());
 
 			glClientActiveTexture(fowTexUnit);
 			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -4265,42 +4146,31 @@ namespace Glest {
 			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 			glEnableClientState(GL_VERTEX_ARRAY);
 			glEnableClientState(GL_NORMAL_ARRAY);
-			for (Layers::iterator layer = layers.begin(); layer != layers.end(); ++layer)
-				(*layer)->renderVisibleLayer();
-			glDisableClientState(GL_VERTEX_ARRAY);
-			glBindBuffer(GL_ARRAY_BUFFER_ARB, 0);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
-			glDisableClientState(GL_NORMAL_ARRAY);
-			glClientActiveTexture(fowTexUnit);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-			glClientActiveTexture(baseTexUnit);
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-			assertGl();
-		}
 
-		void Renderer::MapRenderer::render(const Map* map, float coordStep, VisibleQuadContainerCache &qCache) {
-			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
-				return;
-			}
+			int chunkW = map->getSurfaceChunkW();
+			for (unsigned int visibleIndex = 0; visibleIndex < visibleChunks.size(); ++visibleIndex) {
+				int chunkIndex = visibleChunks[visibleIndex];
+				int chunkX = chunkIndex % chunkW;
+				int chunkY = chunkIndex / chunkW;
 
-			if (map != this->map) {
-				destroy(); // clear any previous map data
-				this->map = map;
-				load(coordStep);
-			}
+				Chunk *&chunk = chunks[chunkIndex];
+				if (chunk == NULL) {
+					chunk = new Chunk();
+				}
+				uint32 version = map->getSurfaceChunkVersion(chunkX, chunkY);
+				if (chunk->built == false || chunk->version != version) {
+					loadChunk(chunk, chunkX, chunkY);
+					chunk->version = version;
+					chunk->built = true;
+				}
 
-			//printf("About to render %d layers\n",layers.size());
+				for (Layers::iterator layer = chunk->layers.begin(); layer != chunk->layers.end(); ++layer) {
+					(*layer)->render();
+					triangleCount += (*layer)->indexCount / 3;
+					pointCount += (*layer)->vertexCount;
+				}
+			}
 
-			glClientActiveTexture(fowTexUnit);
-			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-			glClientActiveTexture(baseTexUnit);
-			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-			glEnableClientState(GL_VERTEX_ARRAY);
-			glEnableClientState(GL_NORMAL_ARRAY);
-			for (Layers::iterator layer = layers.begin(); layer != layers.end(); ++layer)
-				(*layer)->render(qCache);
 			glDisableClientState(GL_VERTEX_ARRAY);
 			glBindBuffer(GL_ARRAY_BUFFER_ARB, 0);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
@@ -4315,10 +4185,12 @@ namespace Glest {
 		}
 
 		void Renderer::MapRenderer::destroy() {
-			while (layers.empty() == false) {
-				delete layers.back();
-				layers.pop_back();
+			for (unsigned int index = 0; index < chunks.size(); ++index) {
+				delete chunks[index];
 			}
+			chunks.clear();
+			visibleChunks.clear();
+			visibleChunksValid = false;
 			map = NULL;
 		}
 
@@ -4355,10 +4227,25 @@ namespace Glest {
 					glEnable(GL_TEXTURE_2D);
 					glBindTexture(GL_TEXTURE_2D, static_cast<const Texture2DGl*>(fowTex)->getHandle());
 
-					glTexSubImage2D(
-						GL_TEXTURE_2D, 0, 0, 0,
-						fowTex->getPixmapConst()->getW(), fowTex->getPixmapConst()->getH(),
-						GL_ALPHA, GL_UNSIGNED_BYTE, fowTex->getPixmapConst()->getPixels());
+					// Only rows changed by fog of war blending are uploaded,
+					// a texture created since the last frame gets all of them
+					const Pixmap2D *fowPixmap = fowTex->getPixmapConst();
+					int fowRowStart = 0;
+					int fowRowCount = 0;
+					bool fowRowsChanged = world->getMinimap()->takeFowTexUploadRows(fowRowStart, fowRowCount);
+					GLuint fowTexHandle = static_cast<const Texture2DGl*>(fowTex)->getHandle();
+					if (fowTexHandle != uploadedFowTexHandle) {
+						uploadedFowTexHandle = fowTexHandle;
+						fowRowsChanged = true;
+						fowRowStart = 0;
+						fowRowCount = fowPixmap->getH();
+					}
+					if (fowRowsChanged == true) {
+						glTexSubImage2D(
+							GL_TEXTURE_2D, 0, 0, fowRowStart,
+							fowPixmap->getW(), fowRowCount,
+							GL_ALPHA, GL_UNSIGNED_BYTE, fowPixmap->getPixels() + fowRowStart * fowPixmap->getW());
+					}
 
 					if (shadowsOffDueToMinRender == false) {
 						//shadow texture
@@ -4373,357 +4260,11 @@ namespace Glest {
 						}
 					}
 
-					const Rect2i mapBounds(0, 0, map->getSurfaceW() - 1, map->getSurfaceH() - 1);
-
 					glActiveTexture(baseTexUnit);
 
 					VisibleQuadContainerCache &qCache = getQuadCache();
 
-					bool useVBORendering = getVBOSupported();
-					if (useVBORendering == true) {
-						VisibleQuadContainerCache &qCache = getQuadCache();
-						//mapRenderer.render(map,coordStep,qCache);
-						mapRenderer.renderVisibleLayers(map, coordStep, qCache);
-					} else if (qCache.visibleScaledCellList.empty() == false) {
-
-						int lastTex = -1;
-						//int currTex=-1;
-
-						//Quad2i snapshotOfvisibleQuad = visibleQuad;
-
-						//bool useVertexArrayRendering = getVBOSupported();
-						//bool useVertexArrayRendering = false;
-						//if(useVertexArrayRendering == false) {
-							//printf("\LEGACY qCache.visibleScaledCellList.size() = %d \n",qCache.visibleScaledCellList.size());
-
-						Vec2f texCoords[4];
-						Vec2f texCoordsSurface[4];
-						Vec3f vertices[4];
-						Vec3f normals[4];
-						glEnableClientState(GL_VERTEX_ARRAY);
-						glEnableClientState(GL_NORMAL_ARRAY);
-
-						std::map<int, int> uniqueVisibleTextures;
-						for (int visibleIndex = 0;
-							visibleIndex < (int) qCache.visibleScaledCellList.size(); ++visibleIndex) {
-							Vec2i &pos = qCache.visibleScaledCellList[visibleIndex];
-							SurfaceCell *tc00 = map->getSurfaceCell(pos.x, pos.y);
-							int cellTex = static_cast<const Texture2DGl*>(tc00->getSurfaceTexture())->getHandle();
-
-							uniqueVisibleTextures[cellTex]++;
-						}
-
-						//printf("Current renders = %d possible = %d\n",qCache.visibleScaledCellList.size(),uniqueVisibleTextures.size());
-
-						for (int visibleIndex = 0;
-							visibleIndex < (int) qCache.visibleScaledCellList.size(); ++visibleIndex) {
-							Vec2i &pos = qCache.visibleScaledCellList[visibleIndex];
-
-							SurfaceCell *tc00 = map->getSurfaceCell(pos.x, pos.y);
-							SurfaceCell *tc10 = map->getSurfaceCell(pos.x + 1, pos.y);
-							SurfaceCell *tc01 = map->getSurfaceCell(pos.x, pos.y + 1);
-							SurfaceCell *tc11 = map->getSurfaceCell(pos.x + 1, pos.y + 1);
-
-							if (tc00 == NULL) {
-								throw megaglest_runtime_error("tc00 == NULL");
-							}
-							if (tc10 == NULL) {
-								throw megaglest_runtime_error("tc10 == NULL");
-							}
-							if (tc01 == NULL) {
-								throw megaglest_runtime_error("tc01 == NULL");
-							}
-							if (tc11 == NULL) {
-								throw megaglest_runtime_error("tc11 == NULL");
-							}
-
-							triangleCount += 2;
-							pointCount += 4;
-
-							//set texture
-							if (tc00->getSurfaceTexture() == NULL) {
-								throw megaglest_runtime_error("tc00->getSurfaceTexture() == NULL");
-							}
-							int currTex = static_cast<const Texture2DGl*>(tc00->getSurfaceTexture())->getHandle();
-							if (currTex != lastTex) {
-								lastTex = currTex;
-								//glBindTexture(GL_TEXTURE_2D, lastTex);
-							}
-
-							const Vec2f &surfCoord = tc00->getSurfTexCoord();
-
-							texCoords[0] = tc01->getFowTexCoord();
-							texCoordsSurface[0] = Vec2f(surfCoord.x, surfCoord.y + coordStep);
-							vertices[0] = tc01->getVertex();
-							normals[0] = tc01->getNormal();;
-
-							texCoords[1] = tc00->getFowTexCoord();
-							texCoordsSurface[1] = Vec2f(surfCoord.x, surfCoord.y);
-							vertices[1] = tc00->getVertex();
-							normals[1] = tc00->getNormal();
-
-							texCoords[2] = tc11->getFowTexCoord();
-							texCoordsSurface[2] = Vec2f(surfCoord.x + coordStep, surfCoord.y + coordStep);
-							vertices[2] = tc11->getVertex();
-							normals[2] = tc11->getNormal();
-
-							texCoords[3] = tc10->getFowTexCoord();
-							texCoordsSurface[3] = Vec2f(surfCoord.x + coordStep, surfCoord.y);
-							vertices[3] = tc10->getVertex();
-							normals[3] = tc10->getNormal();
-
-							//glBindTexture(GL_TEXTURE_2D, static_cast<const Texture2DGl*>(fowTex)->getHandle());
-							glClientActiveTexture(fowTexUnit);
-							glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-							glTexCoordPointer(2, GL_FLOAT, 0, &texCoords[0]);
-
-							glBindTexture(GL_TEXTURE_2D, lastTex);
-							glClientActiveTexture(baseTexUnit);
-							glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-							glTexCoordPointer(2, GL_FLOAT, 0, &texCoordsSurface[0]);
-
-							glVertexPointer(3, GL_FLOAT, 0, &vertices[0]);
-							glNormalPointer(GL_FLOAT, 0, &normals[0]);
-
-							glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-							//unsigned short faceIndices[4] = {0, 1, 2, 3};
-							//glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, &faceIndices[0]);
-
-							glClientActiveTexture(fowTexUnit);
-							glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-							glClientActiveTexture(baseTexUnit);
-							glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-							/*
-											glBegin(GL_TRIANGLE_STRIP);
-
-											//draw quad using immediate mode
-											glMultiTexCoord2fv(fowTexUnit, tc01->getFowTexCoord().ptr());
-											glMultiTexCoord2f(baseTexUnit, surfCoord.x, surfCoord.y + coordStep);
-											glNormal3fv(tc01->getNormal().ptr());
-											glVertex3fv(tc01->getVertex().ptr());
-
-											glMultiTexCoord2fv(fowTexUnit, tc00->getFowTexCoord().ptr());
-											glMultiTexCoord2f(baseTexUnit, surfCoord.x, surfCoord.y);
-											glNormal3fv(tc00->getNormal().ptr());
-											glVertex3fv(tc00->getVertex().ptr());
-
-											glMultiTexCoord2fv(fowTexUnit, tc11->getFowTexCoord().ptr());
-											glMultiTexCoord2f(baseTexUnit, surfCoord.x+coordStep, surfCoord.y+coordStep);
-											glNormal3fv(tc11->getNormal().ptr());
-											glVertex3fv(tc11->getVertex().ptr());
-
-											glMultiTexCoord2fv(fowTexUnit, tc10->getFowTexCoord().ptr());
-											glMultiTexCoord2f(baseTexUnit, surfCoord.x + coordStep, surfCoord.y);
-											glNormal3fv(tc10->getNormal().ptr());
-											glVertex3fv(tc10->getVertex().ptr());
-
-											glEnd();
-							*/
-						}
-
-						glDisableClientState(GL_NORMAL_ARRAY);
-						glDisableClientState(GL_VERTEX_ARRAY);
-
-						//		}
-						//		else {
-						//		    const bool useVBOs = false;
-						//		    const bool useSurfaceCache = false;
-						//
-						//		    std::vector<SurfaceData> surfaceData;
-						//		    bool recalcSurface = false;
-						//
-						//		    if(useSurfaceCache == true) {
-						//				std::map<string,std::pair<Chrono, std::vector<SurfaceData> > >::iterator iterFind = mapSurfaceData.find(snapshotOfvisibleQuad.getString());
-						//				if(iterFind == mapSurfaceData.end()) {
-						//					recalcSurface = true;
-						//					//printf("#1 Calculating surface for Rendering using VA's [%s]\n",snapshotOfvisibleQuad.getString().c_str());
-						//				}
-						///*
-						//				else if(iterFind->second.first.getMillis() >= 250) {
-						//					recalcSurface = true;
-						//					mapSurfaceData.erase(snapshotOfvisibleQuad.getString());
-						//					//printf("#2 RE-Calculating surface for Rendering using VA's [%s]\n",snapshotOfvisibleQuad.getString().c_str());
-						//				}
-						//*/
-						//		    }
-						//		    else {
-						//		    	recalcSurface = true;
-						//		    }
-						//
-						//		    if(recalcSurface == true) {
-						//				//printf("Calculating surface for Rendering using VA's [%s]\n",snapshotOfvisibleQuad.getString().c_str());
-						//
-						//		    	std::vector<SurfaceData> *surface = &surfaceData;
-						//		    	if(useSurfaceCache == true) {
-						//					std::pair<Chrono, std::vector<SurfaceData> > &surfaceCacheEntity = mapSurfaceData[snapshotOfvisibleQuad.getString()];
-						//					surface = &surfaceCacheEntity.second;
-						//					//surface.reserve(qCache.visibleScaledCellList.size());
-						//		    	}
-						//		    	surface->reserve(qCache.visibleScaledCellList.size());
-						//
-						//		    	int lastSurfaceDataIndex = -1;
-						//				for(int visibleIndex = 0;
-						//						visibleIndex < (int)qCache.visibleScaledCellList.size(); ++visibleIndex) {
-						//					Vec2i &pos = qCache.visibleScaledCellList[visibleIndex];
-						//
-						//					SurfaceCell *tc00= map->getSurfaceCell(pos.x, pos.y);
-						//					SurfaceCell *tc10= map->getSurfaceCell(pos.x+1, pos.y);
-						//					SurfaceCell *tc01= map->getSurfaceCell(pos.x, pos.y+1);
-						//					SurfaceCell *tc11= map->getSurfaceCell(pos.x+1, pos.y+1);
-						//
-						//					if(tc00 == NULL) {
-						//						throw megaglest_runtime_error("tc00 == NULL");
-						//					}
-						//					if(tc10 == NULL) {
-						//						throw megaglest_runtime_error("tc10 == NULL");
-						//					}
-						//					if(tc01 == NULL) {
-						//						throw megaglest_runtime_error("tc01 == NULL");
-						//					}
-						//					if(tc11 == NULL) {
-						//						throw megaglest_runtime_error("tc11 == NULL");
-						//					}
-						//
-						//					triangleCount+= 2;
-						//					pointCount+= 4;
-						//
-						//					//set texture
-						//					if(tc00->getSurfaceTexture() == NULL) {
-						//						throw megaglest_runtime_error("tc00->getSurfaceTexture() == NULL");
-						//					}
-						//
-						//					int surfaceDataIndex = -1;
-						//					currTex= static_cast<const Texture2DGl*>(tc00->getSurfaceTexture())->getHandle();
-						//					if(currTex != lastTex) {
-						//						lastTex = currTex;
-						//					}
-						//					else {
-						//						surfaceDataIndex = lastSurfaceDataIndex;
-						//					}
-						//
-						//					if(surfaceDataIndex < 0) {
-						//						SurfaceData newData;
-						//						newData.uniqueId = SurfaceData::nextUniqueId;
-						//						SurfaceData::nextUniqueId++;
-						//						newData.bufferCount=0;
-						//						newData.textureHandle = currTex;
-						//						surface->push_back(newData);
-						//
-						//						surfaceDataIndex = (int)surface->size() - 1;
-						//					}
-						//
-						//					lastSurfaceDataIndex = surfaceDataIndex;
-						//
-						//					SurfaceData *cellData = &(*surface)[surfaceDataIndex];
-						//
-						//					const Vec2f &surfCoord= tc00->getSurfTexCoord();
-						//
-						//					cellData->texCoords.push_back(tc01->getFowTexCoord());
-						//					cellData->texCoordsSurface.push_back(Vec2f(surfCoord.x, surfCoord.y + coordStep));
-						//					cellData->vertices.push_back(tc01->getVertex());
-						//					cellData->normals.push_back(tc01->getNormal());
-						//					cellData->bufferCount++;
-						//
-						//					cellData->texCoords.push_back(tc00->getFowTexCoord());
-						//					cellData->texCoordsSurface.push_back(Vec2f(surfCoord.x, surfCoord.y));
-						//					cellData->vertices.push_back(tc00->getVertex());
-						//					cellData->normals.push_back(tc00->getNormal());
-						//					cellData->bufferCount++;
-						//
-						//					cellData->texCoords.push_back(tc11->getFowTexCoord());
-						//					cellData->texCoordsSurface.push_back(Vec2f(surfCoord.x+coordStep, surfCoord.y+coordStep));
-						//					cellData->vertices.push_back(tc11->getVertex());
-						//					cellData->normals.push_back(tc11->getNormal());
-						//					cellData->bufferCount++;
-						//
-						//					cellData->texCoords.push_back(tc10->getFowTexCoord());
-						//					cellData->texCoordsSurface.push_back(Vec2f(surfCoord.x+coordStep, surfCoord.y));
-						//					cellData->vertices.push_back(tc10->getVertex());
-						//					cellData->normals.push_back(tc10->getNormal());
-						//					cellData->bufferCount++;
-						//				}
-						//			}
-						//
-						//		    std::vector<SurfaceData> *surface = &surfaceData;
-						//		    if(useSurfaceCache == true) {
-						//		    	std::pair<Chrono, std::vector<SurfaceData> > &surfaceCacheEntity = mapSurfaceData[snapshotOfvisibleQuad.getString()];
-						//		    	surface = &surfaceCacheEntity.second;
-						//		    }
-						//
-						//		    glEnableClientState(GL_VERTEX_ARRAY);
-						//		    glEnableClientState(GL_NORMAL_ARRAY);
-						//
-						//			for(int i = 0; i < (int)surface->size(); ++i) {
-						//				SurfaceData &data = (*surface)[i];
-						//
-						//				if(useVBOs == true) {
-						//					VisibleQuadContainerVBOCache *vboCache = GetSurfaceVBOs(&data);
-						//
-						//					//glBindTexture(GL_TEXTURE_2D, static_cast<const Texture2DGl*>(fowTex)->getHandle());
-						//					glClientActiveTexture(fowTexUnit);
-						//					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-						//
-						//					glBindBufferARB( GL_ARRAY_BUFFER_ARB, vboCache->m_nVBOFowTexCoords);
-						//					glTexCoordPointer(2, GL_FLOAT, 0,(char *) NULL);
-						//
-						//					glBindTexture(GL_TEXTURE_2D, data.textureHandle);
-						//					glClientActiveTexture(baseTexUnit);
-						//					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-						//
-						//					glBindBufferARB( GL_ARRAY_BUFFER_ARB, vboCache->m_nVBOSurfaceTexCoords);
-						//					glTexCoordPointer(2, GL_FLOAT, 0, (char *) NULL);
-						//
-						//					glBindBufferARB( GL_ARRAY_BUFFER_ARB, vboCache->m_nVBOVertices);
-						//					glVertexPointer(3, GL_FLOAT, 0, (char *) NULL);
-						//
-						//					glBindBufferARB( GL_ARRAY_BUFFER_ARB, vboCache->m_nVBONormals);
-						//					glNormalPointer(GL_FLOAT, 0, (char *) NULL);
-						//
-						//					glDrawArrays(GL_TRIANGLE_STRIP, 0, data.bufferCount);
-						//
-						//					glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
-						//
-						//					glClientActiveTexture(fowTexUnit);
-						//					glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-						//					glClientActiveTexture(baseTexUnit);
-						//					glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-						//
-						//				}
-						//				else {
-						//					Vec2f *texCoords		= &data.texCoords[0];
-						//					Vec2f *texCoordsSurface	= &data.texCoordsSurface[0];
-						//					Vec3f *vertices			= &data.vertices[0];
-						//					Vec3f *normals			= &data.normals[0];
-						//
-						//					//glBindTexture(GL_TEXTURE_2D, static_cast<const Texture2DGl*>(fowTex)->getHandle());
-						//					glClientActiveTexture(fowTexUnit);
-						//					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-						//					glTexCoordPointer(2, GL_FLOAT, 0,texCoords);
-						//
-						//					glBindTexture(GL_TEXTURE_2D, data.textureHandle);
-						//					glClientActiveTexture(baseTexUnit);
-						//					glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-						//					glTexCoordPointer(2, GL_FLOAT, 0, texCoordsSurface);
-						//
-						//					glVertexPointer(3, GL_FLOAT, 0, vertices);
-						//					glNormalPointer(GL_FLOAT, 0, normals);
-						//
-						//					glDrawArrays(GL_TRIANGLE_STRIP, 0, data.bufferCount);
-						//
-						//					glClientActiveTexture(fowTexUnit);
-						//					glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-						//					glClientActiveTexture(baseTexUnit);
-						//					glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-						//				}
-						//			}
-						//
-						//			glDisableClientState(GL_NORMAL_ARRAY);
-						//			glDisableClientState(GL_VERTEX_ARRAY);
-						//
-						//			//printf("Surface Render before [%d] after [%d]\n",qCache.visibleScaledCellList.size(),surface.size());
-						//		}
-					}
+					mapRenderer.render(map, coordStep, qCache, getVBOSupported(), triangleCount, pointCount);
 
 					//Restore
 					static_cast<ModelRendererGl*>(modelRenderer)->setDuplicateTexCoords(false);
@@ -4745,6 +4286,24 @@ namespace Glest {
 			)
 		}
 
+		// Per object fog of war shading for batched tileset objects
+		class ObjectInstanceCallback : public ModelInstanceCallback {
+		private:
+			Vec3f baseFogColor;
+			float ambFactor;
+
+		public:
+			ObjectInstanceCallback(const Vec3f &baseFogColor, float ambFactor) :
+				baseFogColor(baseFogColor), ambFactor(ambFactor) {
+			}
+
+			virtual void execute(const ModelInstance &instance) {
+				float fowFactor = instance.color.x;
+				glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, (instance.color * ambFactor).ptr());
+				glFogfv(GL_FOG_COLOR, Vec4f(baseFogColor * fowFactor, 1.f).ptr());
+			}
+		};
+
 		void Renderer::renderObjects(const int renderFps) {
 			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
 				return;
@@ -4755,6 +4314,7 @@ namespace Glest {
 
 			Config &config = Config::getInstance();
 			int tilesetObjectsToAnimate = config.getInt("AnimatedTilesetObjects", "-1");
+			bool batchedObjects = configBatchedObjectRendering.get();
 
 			assertGl();
 
@@ -4765,6 +4325,7 @@ namespace Glest {
 			bool modelRenderStarted = false;
 
 			VisibleQuadContainerCache &qCache = getQuadCache();
+			objectBatchList.clear();
 
 			//	for(int visibleIndex = 0;
 			//			visibleIndex < qCache.visibleObjectList.size(); ++visibleIndex) {
@@ -4804,6 +4365,25 @@ namespace Glest {
 
 				float fowFactor = fowTexPixmap->getPixelf(o->getMapPos().x / Map::cellScale, o->getMapPos().y / Map::cellScale);
 				Vec4f color = Vec4f(Vec3f(fowFactor), 1.f);
+
+				float animProgress = 0;
+				if (tilesetObjectsToAnimate == -1) {
+					animProgress = o->getAnimProgress();
+				} else if (tilesetObjectsToAnimate > 0 && o->isAnimated()) {
+					tilesetObjectsToAnimate--;
+					animProgress = o->getAnimProgress();
+				}
+
+				// Objects are collected here and drawn grouped by model below
+				if (batchedObjects == true) {
+					ModelInstance instance;
+					instance.setTransform(v, o->getRotation());
+					instance.color = color;
+					instance.animProgress = animProgress;
+					objectBatchList.add(objModel, instance);
+					continue;
+				}
+
 				glColor4fv(color.ptr());
 				glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, (color * ambFactor).ptr());
 				glFogfv(GL_FOG_COLOR, (baseFogColor * fowFactor).ptr());
@@ -4822,14 +4402,7 @@ namespace Glest {
 				//if(this->gameCamera->getPos().dist(o->getPos()) <= SKIP_INTERPOLATION_DISTANCE) {
 
 
-				if (tilesetObjectsToAnimate == -1) {
-					objModel->updateInterpolationData(o->getAnimProgress(), true);
-				} else if (tilesetObjectsToAnimate > 0 && o->isAnimated()) {
-					tilesetObjectsToAnimate--;
-					objModel->updateInterpolationData(o->getAnimProgress(), true);
-				} else {
-					objModel->updateInterpolationData(0, true);
-				}
+				objModel->updateInterpolationData(animProgress, true);
 
 				//		objModel->updateInterpolationData(o->getAnimProgress(), true);
 						//}
@@ -4841,6 +4414,25 @@ namespace Glest {
 				glPopMatrix();
 			}
 
+			if (objectBatchList.getInstanceCount() > 0) {
+				objectBatchList.build();
+
+				ObjectInstanceCallback instanceCallback(baseFogColor, ambFactor);
+				const vector<ModelBatch> &batches = objectBatchList.getBatches();
+				const vector<ModelInstance> &instances = objectBatchList.getInstances();
+
+				glMatrixMode(GL_MODELVIEW);
+				for (unsigned int batchIndex = 0; batchIndex < batches.size(); ++batchIndex) {
+					const ModelBatch &batch = batches[batchIndex];
+					batch.model->updateInterpolationData(batch.animProgress, true);
+					static_cast<ModelRendererGl*>(modelRenderer)->renderInstances(batch.model,
+						&instances[batch.firstInstance], batch.instanceCount, &instanceCallback);
+
+					triangleCount += batch.model->getTriangleCount() * batch.instanceCount;
+					pointCount += batch.model->getVertexCount() * batch.instanceCount;
+				}
+			}
+
 			if (modelRenderStarted == true) {
 				modelRenderer->end();
 				glPopAttrib();
@@ -5018,7 +4610,7 @@ namespace Glest {
 				for (int visibleUnitIndex = 0;
 					visibleUnitIndex < (int) qCache.visibleQuadUnitList.size(); ++visibleUnitIndex) {
 					Unit *unit = qCache.visibleQuadUnitList[visibleUnitIndex];
-					Vec3f currVec = unit->getCurrVectorFlat();
+					Vec3f currVec = getUnitRenderPosition(unit);
 					Vec4f color = unit->getFaction()->getTexture()->getPixmapConst()->getPixel4f(0, 0);
 					glColor4f(color.x, color.y, color.z, color.w * 0.7f);
 					renderSelectionCircle(currVec, unit->getType()->getSize(), 0.8f, 0.05f);
@@ -5067,7 +4659,7 @@ namespace Glest {
 
 						glColor4f(color.x, color.y, color.z, color.w);
 
-						Vec3f currVec = unit->getCurrVectorFlat();
+						Vec3f currVec = getUnitRenderPosition(unit);
 						renderSelectionCircle(currVec, unit->getType()->getSize(), radius, thickness);
 					}
 				}
@@ -5092,7 +4684,7 @@ namespace Glest {
 					visibleUnitIndex < (int) qCache.visibleQuadUnitList.size(); ++visibleUnitIndex) {
 					Unit *unit = qCache.visibleQuadUnitList[visibleUnitIndex];
 					if (unit->isAlive()) {
-						Vec3f currVec = unit->getCurrVectorFlat();
+						Vec3f currVec = getUnitRenderPosition(unit);
 						renderTeamColorEffect(currVec, visibleUnitIndex, unit->getType()->getSize(),
 							unit->getFaction()->getTexture()->getPixmapConst()->getPixel4f(0, 0), texture);
 					}
@@ -5153,6 +4745,95 @@ namespace Glest {
 			glPopMatrix();
 		}
 
+		// Keeps units with the same model and animation phase next to each
+		// other so they share interpolated poses and render state
+		static bool compareUnitRenderOrder(const std::pair<Model *, Unit *> &left, const std::pair<Model *, Unit *> &right) {
+			if (left.first != right.first) {
+				return left.first < right.first;
+			}
+			float leftProgress = left.second->getAnimProgressAsFloat();
+			float rightProgress = right.second->getAnimProgressAsFloat();
+			if (leftProgress != rightProgress) {
+				return leftProgress < rightProgress;
+			}
+			return left.second->getId() < right.second->getId();
+		}
+
+		void Renderer::updateRenderSnapshot(World *world) {
+			currentRenderSnapshot = NULL;
+			if (world->isRenderSnapshotEnabled() == false) {
+				return;
+			}
+
+			TripleBuffer<WorldRenderSnapshot> &snapshots = world->getRenderSnapshots();
+			if (snapshots.hasUpdate() == true) {
+				if (previousRenderSnapshot == NULL) {
+					previousRenderSnapshot = new WorldRenderSnapshot();
+				}
+				*previousRenderSnapshot = snapshots.getReadBuffer();
+				snapshots.update();
+			}
+
+			const WorldRenderSnapshot &snapshot = snapshots.getReadBuffer();
+			if (previousRenderSnapshot == NULL ||
+				previousRenderSnapshot->frameCount < 0 ||
+				snapshot.frameCount <= previousRenderSnapshot->frameCount ||
+				snapshot.frameCount - previousRenderSnapshot->frameCount > GameConstants::updateFps) {
+				// Nothing sensible to blend from, like after loading a game
+				return;
+			}
+
+			int64 frameMillis = snapshot.publishMillis - previousRenderSnapshot->publishMillis;
+			renderSnapshotBlend = 1.0f;
+			if (frameMillis > 0) {
+				renderSnapshotBlend = (float) (Chrono::getCurMillis() - snapshot.publishMillis) / (float) frameMillis;
+				renderSnapshotBlend = std::max(0.0f, std::min(1.0f, renderSnapshotBlend));
+			}
+			currentRenderSnapshot = &snapshot;
+		}
+
+		static float interpolateAngle(float from, float to, float blend) {
+			float delta = std::fmod(to - from, 360.0f);
+			if (delta > 180.0f) {
+				delta -= 360.0f;
+			} else if (delta < -180.0f) {
+				delta += 360.0f;
+			}
+			return from + delta * blend;
+		}
+
+		// Units missing from either snapshot were just created or are not
+		// in the world any more, they use live values
+		void Renderer::getUnitRenderTransform(const Unit *unit, Vec3f &position,
+			float &rotationZ, float &rotationX, float &rotation) const {
+			if (currentRenderSnapshot != NULL) {
+				const UnitRenderState *currState = currentRenderSnapshot->findUnit(unit->getId());
+				const UnitRenderState *prevState = previousRenderSnapshot->findUnit(unit->getId());
+				if (currState != NULL && prevState != NULL) {
+					position = prevState->position.lerp(renderSnapshotBlend, currState->position);
+					rotationZ = interpolateAngle(prevState->rotationZ, currState->rotationZ, renderSnapshotBlend);
+					rotationX = interpolateAngle(prevState->rotationX, currState->rotationX, renderSnapshotBlend);
+					rotation = interpolateAngle(prevState->rotation, currState->rotation, renderSnapshotBlend);
+					return;
+				}
+			}
+			position = unit->getCurrVectorFlat();
+			rotationZ = unit->getRotationZ();
+			rotationX = unit->getRotationX();
+			rotation = unit->getRotation();
+		}
+
+		Vec3f Renderer::getUnitRenderPosition(const Unit *unit) const {
+			if (currentRenderSnapshot != NULL) {
+				const UnitRenderState *currState = currentRenderSnapshot->findUnit(unit->getId());
+				const UnitRenderState *prevState = previousRenderSnapshot->findUnit(unit->getId());
+				if (currState != NULL && prevState != NULL) {
+					return prevState->position.lerp(renderSnapshotBlend, currState->position);
+				}
+			}
+			return unit->getCurrVectorFlat();
+		}
+
 		void Renderer::renderUnits(bool airUnits, const int renderFps) {
 			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
 				return;
@@ -5175,7 +4856,9 @@ namespace Glest {
 
 			VisibleQuadContainerCache &qCache = getQuadCache();
 			if (qCache.visibleQuadUnitList.empty() == false) {
-				bool modelRenderStarted = false;
+				// getCurrentModelPtr advances random animations, so it is
+				// called once per unit here and the result is reused below
+				unitRenderOrderList.clear();
 				for (int visibleUnitIndex = 0;
 					visibleUnitIndex < (int) qCache.visibleQuadUnitList.size(); ++visibleUnitIndex) {
 					Unit *unit = qCache.visibleQuadUnitList[visibleUnitIndex];
@@ -5183,6 +4866,15 @@ namespace Glest {
 					if ((airUnits == false && unit->getType()->getField() == fAir) || (airUnits == true && unit->getType()->getField() != fAir)) {
 						continue;
 					}
+					unitRenderOrderList.push_back(std::make_pair(unit->getCurrentModelPtr(), unit));
+				}
+				std::sort(unitRenderOrderList.begin(), unitRenderOrderList.end(), compareUnitRenderOrder);
+
+				bool modelRenderStarted = false;
+				for (int renderOrderIndex = 0;
+					renderOrderIndex < (int) unitRenderOrderList.size(); ++renderOrderIndex) {
+					Unit *unit = unitRenderOrderList[renderOrderIndex].second;
+
 					meshCallback.setTeamTexture(unit->getFaction()->getTexture());
 
 					if (modelRenderStarted == false) {
@@ -5211,19 +4903,19 @@ namespace Glest {
 					glPushMatrix();
 
 					//translate
-					Vec3f currVec = unit->getCurrVectorFlat();
+					Vec3f currVec;
+					float zrot, xrot, yrot;
+					getUnitRenderTransform(unit, currVec, zrot, xrot, yrot);
 					glTranslatef(currVec.x, currVec.y, currVec.z);
 
 					//rotate
-					float zrot = unit->getRotationZ();
-					float xrot = unit->getRotationX();
 					if (zrot != .0f) {
 						glRotatef(zrot, 0.f, 0.f, 1.f);
 					}
 					if (xrot != .0f) {
 						glRotatef(xrot, 1.f, 0.f, 0.f);
 					}
-					glRotatef(unit->getRotation(), 0.f, 1.f, 0.f);
+					glRotatef(yrot, 0.f, 1.f, 0.f);
 
 					//dead alpha
 					const SkillType *st = unit->getCurrSkill();
@@ -5239,7 +4931,7 @@ namespace Glest {
 					glAlphaFunc(GL_GREATER, 0.02f);
 
 					//render
-					Model *model = unit->getCurrentModelPtr();
+					Model *model = unitRenderOrderList[renderOrderIndex].first;
 					//printf("Rendering model [%d - %s]\n[%s]\nCamera [%s]\nDistance: %f\n",unit->getId(),unit->getType()->getName().c_str(),unit->getCurrVector().getString().c_str(),this->gameCamera->getPos().getString().c_str(),this->gameCamera->getPos().dist(unit->getCurrVector()));
 
 					//if(this->gameCamera->getPos().dist(unit->getCurrVector()) <= SKIP_INTERPOLATION_DISTANCE) {
@@ -5383,7 +5075,7 @@ namespace Glest {
 									initialized = true;
 								}
 
-								Vec3f currVec = unit->getCurrVectorFlat();
+								Vec3f currVec = getUnitRenderPosition(unit);
 								currVec = Vec3f(currVec.x, currVec.y + 0.3f, currVec.z);
 								if (mType->getField() == fAir && unit->getType()->getField() == fLand) {
 									currVec = Vec3f(currVec.x, currVec.y + game->getWorld()->getTileset()->getAirHeight(), currVec.z);
@@ -5437,7 +5129,7 @@ namespace Glest {
 				const Unit *unit = selection->getUnit(i);
 				if (unit != NULL) {
 					//translate
-					Vec3f currVec = unit->getCurrVectorFlat();
+					Vec3f currVec = getUnitRenderPosition(unit);
 					currVec.y += 0.3f;
 
 					//selection circle
@@ -5514,7 +5206,7 @@ namespace Glest {
 								int findUnitId = effect.currentAttackBoostUnits[i];
 								Unit *affectedUnit = game->getWorld()->findUnitById(findUnitId);
 								if (affectedUnit != NULL) {
-									Vec3f currVecBoost = affectedUnit->getCurrVectorFlat();
+									Vec3f currVecBoost = getUnitRenderPosition(affectedUnit);
 									currVecBoost.y += 0.3f;
 
 									renderSelectionCircle(currVecBoost, affectedUnit->getType()->getSize(), 1.f);
@@ -5529,7 +5221,7 @@ namespace Glest {
 						map->clampPos(pos);
 
 						Vec3f arrowTarget = Vec3f(pos.x, map->getCell(pos)->getHeight(), pos.y);
-						renderArrow(unit->getCurrVectorFlat(), arrowTarget, Vec4f(0.f, 0.f, 1.f, 0.8f), 0.3f);
+						renderArrow(getUnitRenderPosition(unit), arrowTarget, Vec4f(0.f, 0.f, 1.f, 0.8f), 0.3f);
 					}
 				}
 			}
@@ -5569,7 +5261,7 @@ namespace Glest {
 							Vec3f arrowTarget;
 							Command *c = unit->getCurrCommand();
 							if (c->getUnit() != NULL) {
-								arrowTarget = c->getUnit()->getCurrVectorFlat();
+								arrowTarget = getUnitRenderPosition(c->getUnit());
 							} else {
 								Vec2i pos = c->getPos();
 								map->clampPos(pos);
@@ -5577,7 +5269,7 @@ namespace Glest {
 								arrowTarget = Vec3f(pos.x, map->getCell(pos)->getHeight(), pos.y);
 							}
 
-							renderArrow(unit->getCurrVectorFlat(), arrowTarget, arrowColor, 0.3f);
+							renderArrow(getUnitRenderPosition(unit), arrowTarget, arrowColor, 0.3f);
 						}
 					}
 				}
@@ -5595,7 +5287,7 @@ namespace Glest {
 						glColor4f(1.f, 0.f, 0.f, highlight);
 					}
 
-					Vec3f v = unit->getCurrVectorFlat();
+					Vec3f v = getUnitRenderPosition(unit);
 					v.y += 0.3f;
 					renderSelectionCircle(v, unit->getType()->getSize(), 0.5f + 0.4f*highlight);
 				}
@@ -5703,7 +5395,7 @@ namespace Glest {
 							}
 						}
 
-						Vec3f currVec = unit->getCurrVectorFlat();
+						Vec3f currVec = getUnitRenderPosition(unit);
 						if (healthbarheight == -100.0f) {
 							currVec.y += unit->getType()->getHeight();
 						} else {
@@ -6949,7 +6641,8 @@ namespace Glest {
 					visibleUnitIndex < (int) qCache.visibleQuadUnitList.size(); ++visibleUnitIndex) {
 					Unit *unit = qCache.visibleQuadUnitList[visibleUnitIndex];
 					if (unit != NULL && unit->isAlive()) {
-						Vec3f unitPos = unit->getCurrMidHeightVector();
+						Vec3f unitPos = getUnitRenderPosition(unit) +
+							Vec3f(0.f, unit->getType()->getHeight() / 2.f, 0.f);
 						bool insideQuad = CubeInFrustum(quadSelectionCacheItem.frustumData,
 							unitPos.x, unitPos.y, unitPos.z, unit->getType()->getRenderSize());
 						if (insideQuad == true) {
@@ -7502,6 +7195,11 @@ namespace Glest {
 				shadowIntensity = config.getFloat("ShadowIntensity", "1.0");
 			}
 
+			// Pixels of textures already on the GPU beyond this are dropped
+			// from RAM, a negative value keeps them all
+			int textureCpuBudgetMB = config.getInt("TextureCpuBudgetMB", "256");
+			ResidencyManager::setTexturePixelBudget(textureCpuBudgetMB < 0 ? -1 : (int64) textureCpuBudgetMB * 1024 * 1024);
+
 			//load filter settings
 			Texture2D::Filter textureFilter = strToTextureFilter(config.getString("Filter"));
 			int maxAnisotropy = config.getInt("FilterMaxAnisotropy");
@@ -7708,11 +7406,19 @@ namespace Glest {
 						glPushMatrix();
 
 						//translate
-						Vec3f currVec = unit->getCurrVectorFlat();
+						Vec3f currVec;
+						float zrot, xrot, yrot;
+						getUnitRenderTransform(unit, currVec, zrot, xrot, yrot);
 						glTranslatef(currVec.x, currVec.y, currVec.z);
 
 						//rotate
-						glRotatef(unit->getRotation(), 0.f, 1.f, 0.f);
+						if (zrot != .0f) {
+							glRotatef(zrot, 0.f, 0.f, 1.f);
+						}
+						if (xrot != .0f) {
+							glRotatef(xrot, 1.f, 0.f, 0.f);
+						}
+						glRotatef(yrot, 0.f, 1.f, 0.f);
 
 						//render
 						Model *model = unit->getCurrentModelPtr();
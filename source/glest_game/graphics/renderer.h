@@ -30,6 +30,7 @@
 #include "model_manager.h"
 #include "graphics_factory_gl.h"
 #include "model_renderer_gl.h"
+#include "model_batch.h"
 #include "font_manager.h"
 #include "camera.h"
 #include <vector>
@@ -72,6 +73,8 @@ namespace Glest {
 		class ConsoleLineInfo;
 		class SurfaceCell;
 		class Program;
+		class World;
+		class WorldRenderSnapshot;
 
 		// ===========================================================
 		// 	class Renderer
@@ -300,6 +303,23 @@ namespace Glest {
 			//std::vector<std::pair<Unit *,Vec3f> > renderUnitTitleList;
 			std::vector<Unit *> visibleFrameUnitList;
 			string visibleFrameUnitListCameraKey;
+			// Visible units of the current pass ordered by model
+			std::vector<std::pair<Model *, Unit *> > unitRenderOrderList;
+			// Unit motion is blended from the previous world frame to
+			// the current one while snapshots are published
+			WorldRenderSnapshot *previousRenderSnapshot;
+			const WorldRenderSnapshot *currentRenderSnapshot;
+			float renderSnapshotBlend;
+
+			// Where a unit is drawn this frame; every pass that draws or
+			// picks units uses it so they stay on top of the meshes
+			void getUnitRenderTransform(const Unit *unit, Vec3f &position,
+				float &rotationZ, float &rotationX, float &rotation) const;
+			Vec3f getUnitRenderPosition(const Unit *unit) const;
+			// Fog of war texture that got its pixels in a full upload
+			GLuint uploadedFowTexHandle;
+			// Visible tileset objects grouped by model
+			ModelBatchList objectBatchList;
 
 			bool no2DMouseRendering;
 			bool showDebugUI;
@@ -345,24 +365,19 @@ namespace Glest {
 
 			class MapRenderer {
 			public:
-				inline MapRenderer() : map(NULL) {
+				inline MapRenderer() : map(NULL), vboEnabled(false), coordStep(0), visibleChunksValid(false) {
 				}
 				inline ~MapRenderer() {
 					destroy();
 				}
-				void render(const Map* map, float coordStep, VisibleQuadContainerCache &qCache);
-				void renderVisibleLayers(const Map* map, float coordStep, VisibleQuadContainerCache &qCache);
+				void render(const Map* map, float coordStep, VisibleQuadContainerCache &qCache, bool vboEnabled, int &triangleCount, int &pointCount);
 				void destroy();
 			private:
-				void load(float coordStep);
-				void loadVisibleLayers(float coordStep, VisibleQuadContainerCache &qCache);
-
-				const Map* map;
 				struct Layer {
 					inline explicit Layer(int th) :
 						vbo_vertices(0), vbo_normals(0),
 						vbo_fowTexCoords(0), vbo_surfTexCoords(0),
-						vbo_indices(0), indexCount(0),
+						vbo_indices(0), indexCount(0), vertexCount(0),
 						textureHandle(th), textureCRC(0) {
 					}
 
@@ -376,14 +391,13 @@ namespace Glest {
 						this->fowTexCoords = obj.fowTexCoords;
 						this->surfTexCoords = obj.surfTexCoords;
 						this->indices = obj.indices;
-						this->cellToIndicesMap = obj.cellToIndicesMap;
-						this->rowsToRenderCache = obj.rowsToRenderCache;
 						this->vbo_vertices = obj.vbo_vertices;
 						this->vbo_normals = obj.vbo_normals;
 						this->vbo_fowTexCoords = obj.vbo_fowTexCoords;
 						this->vbo_surfTexCoords = obj.vbo_surfTexCoords;
 						this->vbo_indices = obj.vbo_indices;
 						this->indexCount = obj.indexCount;
+						this->vertexCount = obj.vertexCount;
 						this->textureHandle = obj.textureHandle;
 						this->texturePath = obj.texturePath;
 						this->textureCRC = obj.textureCRC;
@@ -393,25 +407,44 @@ namespace Glest {
 
 					~Layer();
 					void load_vbos(bool vboEnabled);
-					void render(VisibleQuadContainerCache &qCache);
-					void renderVisibleLayer();
+					void render();
 
 					std::vector<Vec3f> vertices, normals;
 					std::vector<Vec2f> fowTexCoords, surfTexCoords;
 					std::vector<GLuint> indices;
-					std::map<Vec2i, int> cellToIndicesMap;
-					std::map<Quad2i, vector<pair<int, int> > > rowsToRenderCache;
 
 					GLuint vbo_vertices, vbo_normals,
 						vbo_fowTexCoords, vbo_surfTexCoords,
 						vbo_indices;
 					int indexCount;
+					int vertexCount;
 					int textureHandle;
 					string texturePath;
 					uint32 textureCRC;
 				};
 				typedef std::vector<Layer*> Layers;
-				Layers layers;
+
+				// Map::surfaceChunkSize square of surface cells with one layer
+				// per texture, rebuilt when the map bumps the chunk version
+				struct Chunk {
+					inline Chunk() : version(0), built(false) {
+					}
+					~Chunk();
+
+					Layers layers;
+					uint32 version;
+					bool built;
+				};
+
+				void loadChunk(Chunk *chunk, int chunkX, int chunkY);
+				void updateVisibleChunks(VisibleQuadContainerCache &qCache);
+
+				const Map* map;
+				bool vboEnabled;
+				float coordStep;
+				std::vector<Chunk*> chunks;
+				std::vector<int> visibleChunks;
+				bool visibleChunksValid;
 				Quad2i lastVisibleQuad;
 			} mapRenderer;
 
@@ -554,6 +587,7 @@ namespace Glest {
 			void renderObjects(const int renderFps);
 
 			void renderWater();
+			void updateRenderSnapshot(World *world);
 			void renderUnits(bool airUnits, const int renderFps);
 			void renderUnitsToBuild(const int renderFps);
 
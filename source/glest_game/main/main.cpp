@@ -61,6 +61,7 @@
 #include "interpolation.h"
 #include "common_scoped_ptr.h"
 #include "shared_const.h"
+#include "map_preloader.h"
 
 // To handle signal catching
 #if defined(__GNUC__) && !defined(__MINGW32__) && !defined(__FreeBSD__) && !defined(BSD)
@@ -304,6 +305,7 @@ namespace
 				printf("#4 IRCCLient Cache SHUTDOWN\n");
 
 			cleanupCRCThread();
+			MapPreloader::getInstance().end();
 			if (SystemFlags::VERBOSE_MODE_ENABLED)
 				printf("In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
@@ -6900,6 +6902,7 @@ namespace
 					if (SystemFlags::VERBOSE_MODE_ENABLED)
 						printf("**INFO** Disabling Interpolation\n");
 				}
+				InterpolationData::setPoseQuantizationSteps(config.getInt("VertexInterpolationPoseSteps", "16"));
 
 
 				if (config.getBool("EnableVSynch", "false") == true) {
@@ -43,6 +43,7 @@
 #include <iterator>
 #include "compression_utils.h"
 #include "shared_const.h"
+#include "map_preloader.h"
 
 #include "leak_dumper.h"
 
@@ -7496,10 +7497,13 @@ namespace Glest {
 				if (currentMap != gameSettings->getMap()) {                       // load the setup again
 					currentMap = gameSettings->getMap();
 				}
+				string mapPath = Config::getMapPath(currentMap, scenarioDir, false);
 				bool
 					mapLoaded =
-					loadMapInfo(Config::getMapPath(currentMap, scenarioDir, false),
-						&mapInfo, true);
+					loadMapInfo(mapPath, &mapInfo, true);
+				if (mapLoaded == true) {
+					MapPreloader::getInstance().request(mapPath);
+				}
 				if (mapLoaded == false) {
 					// try to get the map via ftp
 					if (ftpClientThread != NULL
@@ -254,6 +254,7 @@ namespace Glest {
 				last_Forced_CheckedCRCTilesetName = "";
 				last_Forced_CheckedCRCTechtreeName = "";
 				last_Forced_CheckedCRCMapName = "";
+				preloadedMapFile = "";
 
 				lastCheckedCRCTilesetValue = 0;
 				lastCheckedCRCTechtreeValue = 0;
@@ -255,6 +255,7 @@ namespace Glest {
 			string last_Forced_CheckedCRCTilesetName;
 			string last_Forced_CheckedCRCTechtreeName;
 			string last_Forced_CheckedCRCMapName;
+			string preloadedMapFile;
 
 			uint32 lastCheckedCRCTilesetValue;
 			uint32 lastCheckedCRCTechtreeValue;
@@ -26,6 +26,7 @@
 #include "core_data.h"
 #include "server_interface.h"
 #include "network_manager.h"
+#include "map_preloader.h"
 
 namespace Glest {
 	namespace Game {
@@ -782,6 +783,12 @@ namespace Glest {
 					lastPlayerDisconnected();
 				}
 
+				// Let the map load in the background while players set up
+				if (preloadedMapFile != getCurrentMapFile()) {
+					preloadedMapFile = getCurrentMapFile();
+					MapPreloader::getInstance().request(Config::getMapPath(preloadedMapFile, "", false));
+				}
+
 				//call the chat manager
 				chatManager.updateNetwork();
 
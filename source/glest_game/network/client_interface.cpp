@@ -55,6 +55,7 @@ namespace Glest {
 		const int ClientInterface::messageWaitTimeout = 10000;	//10 seconds
 		const int ClientInterface::waitSleepTime = 10;
 		const int ClientInterface::maxNetworkCommandListSendTimeWait = 5;
+		const int ClientInterface::pendingFrameWaitMilliseconds = 10;
 
 		// =====================================================
 		//	class ClientInterfaceThread
@@ -199,6 +200,8 @@ namespace Glest {
 			cachedPendingCommandsIndex = 0;
 			cachedLastPendingFrameCount = 0;
 			timeClientWaitedForLastMessage = 0;
+			lastReadPendingFrameCount = -1;
+			pendingFrameWaiting = false;
 
 			flagAccessor = new Mutex(CODE_AT_LINE);
 
@@ -206,6 +209,7 @@ namespace Glest {
 			sessionKey = 0;
 			launchGame = false;
 			introDone = false;
+			gameSetupSequence = 0;
 
 			this->joinGameInProgress = false;
 			this->joinGameInProgressLaunch = false;
@@ -930,45 +934,41 @@ namespace Glest {
 							//throw megaglest_runtime_error(szBuf);
 						}
 
-						networkMessageLaunch.buildGameSettings(&gameSettings);
+						if (networkMessageLaunch.getMessageType() == nmtBroadCastSetup) {
+							gameSetupSnapshot = networkMessageLaunch.getSnapshot();
+							gameSetupSequence = 0;
+						}
+						applyGameSetup(networkMessageLaunch);
 
 						if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance, "In [%s::%s Line: %d] took msecs: %lld\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, chrono.getMillis());
 						if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) chrono.start();
+					}
+				}
+				break;
+				case nmtBroadCastSetupDelta:
+				{
+					NetworkMessageLaunchDelta networkMessageLaunchDelta;
+					if (receiveMessage(&networkMessageLaunchDelta)) {
+						this->setLastPingInfoToNow();
 
-						//printf("Client got game settings playerIndex = %d lookingfor match...\n",playerIndex);
-
-						if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Lined: %d] got networkMessageLaunch.getMessageType() = %d\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, networkMessageLaunch.getMessageType());
-						//replace server player by network
-						for (int factionIndex = 0; factionIndex < gameSettings.getFactionCount(); ++factionIndex) {
-
-							//printf("Faction = %d start location = %d faction name = %s\n",i,gameSettings.getStartLocationIndex(factionIndex),gameSettings.getFactionTypeName(factionIndex).c_str());
-
-							//replace by network
-							if (gameSettings.getFactionControl(factionIndex) == ctHuman) {
-								gameSettings.setFactionControl(factionIndex, ctNetwork);
-							}
-
-							//printf("factionIndex = %d gameSettings.getStartLocationIndex(factionIndex) = %d playerIndex = %d, gameSettings.getFactionControl(factionIndex) = %d\n",factionIndex,gameSettings.getStartLocationIndex(factionIndex),playerIndex,gameSettings.getFactionControl(i));
+						if (gameSetupSnapshot.empty() == false &&
+							networkMessageLaunchDelta.getBaseSequence() == gameSetupSequence &&
+							networkMessageLaunchDelta.apply(gameSetupSnapshot) == true) {
 
-							//set the faction index
-							if (gameSettings.getStartLocationIndex(factionIndex) == playerIndex) {
-								//printf("Setting my factionindex to: %d for playerIndex: %d\n",i,playerIndex);
+							gameSetupSequence = networkMessageLaunchDelta.getSequence();
 
-								gameSettings.setThisFactionIndex(factionIndex);
+							NetworkMessageLaunch networkMessageLaunch;
+							networkMessageLaunch.setSnapshot(gameSetupSnapshot, nmtBroadCastSetup);
+							applyGameSetup(networkMessageLaunch);
+						} else {
+							if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] setup delta %u does not apply to %u, requesting resync\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, networkMessageLaunchDelta.getBaseSequence(), gameSetupSequence);
 
-								//printf("Client got game settings playerIndex = %d factionIndex = %d control = %d name = %s\n",playerIndex,factionIndex,gameSettings.getFactionControl(factionIndex),gameSettings.getFactionTypeName(i).c_str());
-								if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] gameSettings.getThisFactionIndex(factionIndex) = %d, playerIndex = %d, factionIndex = %d\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, gameSettings.getThisFactionIndex(), playerIndex, factionIndex);
-							}
-						}
+							gameSetupSnapshot.clear();
+							gameSetupSequence = 0;
 
-						if (networkMessageLaunch.getMessageType() == nmtLaunch) {
-							launchGame = true;
-						} else if (networkMessageLaunch.getMessageType() == nmtBroadCastSetup) {
-							setGameSettingsReceived(true);
+							NetworkMessageLaunchDelta resyncRequest;
+							sendMessage(&resyncRequest);
 						}
-
-						if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance, "In [%s::%s Line: %d] took msecs: %lld\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, chrono.getMillis());
-						if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) chrono.start();
 					}
 				}
 				break;
@@ -1174,7 +1174,8 @@ namespace Glest {
 								}
 							}
 
-							cachedPendingCommands[networkMessageCommandList.getFrameCount()].reserve(networkMessageCommandList.getCommandCount());
+							PendingFrameCommands *pendingFrame = storePendingFrame(networkMessageCommandList.getFrameCount());
+							pendingFrame->commands.reserve(pendingFrame->commands.size() + networkMessageCommandList.getCommandCount());
 
 							// give all commands
 							for (int i = 0; i < networkMessageCommandList.getCommandCount(); ++i) {
@@ -1184,17 +1185,25 @@ namespace Glest {
 									//printf("Network cmd type: %d [%d] frame: %d\n",networkMessageCommandList.getCommand(i)->getNetworkCommandType(),nctPauseResume,networkMessageCommandList.getFrameCount());
 								//}
 
-								cachedPendingCommands[networkMessageCommandList.getFrameCount()].push_back(*networkMessageCommandList.getCommand(i));
+								pendingFrame->commands.push_back(*networkMessageCommandList.getCommand(i));
 
-								if (cachedPendingCommandCRCs.find(networkMessageCommandList.getFrameCount()) == cachedPendingCommandCRCs.end()) {
-									cachedPendingCommandCRCs[networkMessageCommandList.getFrameCount()].reserve(GameConstants::maxPlayers);
+								if (pendingFrame->factionCRCs.empty() == true) {
+									pendingFrame->factionCRCs.reserve(GameConstants::maxPlayers);
 									for (int index = 0; index < GameConstants::maxPlayers; ++index) {
-										cachedPendingCommandCRCs[networkMessageCommandList.getFrameCount()].push_back(networkMessageCommandList.getNetworkPlayerFactionCRC(index));
+										pendingFrame->factionCRCs.push_back(networkMessageCommandList.getNetworkPlayerFactionCRC(index));
 									}
 								}
 							}
+							bool wakeGameThread = pendingFrameWaiting;
+							pendingFrameWaiting = false;
 							safeMutex.ReleaseLock();
 
+							// Only signal a waiting game thread, so tokens don't
+							// pile up while nobody waits
+							if (wakeGameThread == true) {
+								pendingFrameArrived.signal();
+							}
+
 							done = true;
 						}
 						break;
@@ -1207,6 +1216,11 @@ namespace Glest {
 							if (receiveMessage(&networkMessagePing)) {
 								if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
 								this->setLastPingInfo(networkMessagePing);
+
+								// Answer the server's round trip pings so it can time them
+								if (networkMessagePing.getPingType() == nptRoundTrip) {
+									sendPingMessage(networkMessagePing.getPingFrequency(), time(NULL), nptRoundTripReply, networkMessagePing.getPingTime());
+								}
 							}
 						}
 						break;
@@ -1340,6 +1354,13 @@ namespace Glest {
 						}
 						break;
 
+						// Lobby setup deltas still in flight when the game launched
+						case nmtBroadCastSetupDelta:
+						{
+							NetworkMessageLaunchDelta networkMessageLaunchDelta;
+							receiveMessage(&networkMessageLaunchDelta);
+						}
+						break;
 
 						case nmtLoadingStatusMessage:
 							break;
@@ -1396,6 +1417,50 @@ namespace Glest {
 			return result;
 		}
 
+		// Both called with networkCommandListThreadAccessor locked
+		ClientInterface::PendingFrameCommands * ClientInterface::storePendingFrame(int frameCount) {
+			PendingFrameCommands &slot = pendingFrameRing[((frameCount % pendingFrameRingSize) + pendingFrameRingSize) % pendingFrameRingSize];
+			if (slot.used == true && slot.frameCount != frameCount) {
+				// Frames the game thread already went past are never read
+				if (slot.frameCount > lastReadPendingFrameCount) {
+					PendingFrameCommands &overflow = pendingFrameOverflow[frameCount];
+					overflow.frameCount = frameCount;
+					overflow.used = true;
+					return &overflow;
+				}
+				slot.release();
+			}
+			if (slot.used == false) {
+				slot.frameCount = frameCount;
+				slot.used = true;
+				// Messages of this frame that arrived while the slot was busy
+				// come first
+				if (pendingFrameOverflow.empty() == false) {
+					std::map<int, PendingFrameCommands>::iterator iterFind = pendingFrameOverflow.find(frameCount);
+					if (iterFind != pendingFrameOverflow.end()) {
+						slot.commands.swap(iterFind->second.commands);
+						slot.factionCRCs.swap(iterFind->second.factionCRCs);
+						pendingFrameOverflow.erase(iterFind);
+					}
+				}
+			}
+			return &slot;
+		}
+
+		ClientInterface::PendingFrameCommands * ClientInterface::findPendingFrame(int frameCount) {
+			PendingFrameCommands &slot = pendingFrameRing[((frameCount % pendingFrameRingSize) + pendingFrameRingSize) % pendingFrameRingSize];
+			if (slot.used == true && slot.frameCount == frameCount) {
+				return &slot;
+			}
+			if (pendingFrameOverflow.empty() == false) {
+				std::map<int, PendingFrameCommands>::iterator iterFind = pendingFrameOverflow.find(frameCount);
+				if (iterFind != pendingFrameOverflow.end()) {
+					return &iterFind->second;
+				}
+			}
+			return NULL;
+		}
+
 		bool ClientInterface::getNetworkCommand(int frameCount, int currentCachedPendingCommandsIndex) {
 			bool result = false;
 			bool waitForData = false;
@@ -1420,9 +1485,10 @@ namespace Glest {
 					}
 					copyCachedLastPendingFrameCount = cachedLastPendingFrameCount;
 
-					if (cachedPendingCommands.find(frameCount) != cachedPendingCommands.end()) {
+					PendingFrameCommands *pendingFrame = findPendingFrame(frameCount);
+					if (pendingFrame != NULL) {
 
-						Commands &frameCmdList = cachedPendingCommands[frameCount];
+						Commands &frameCmdList = pendingFrame->commands;
 
 						//printf("In getNetworkCommand frameCmdList.size(): %d\n",(int)frameCmdList.size());
 
@@ -1430,19 +1496,18 @@ namespace Glest {
 							for (int index = 0; index < (int) frameCmdList.size(); ++index) {
 								pendingCommands.push_back(frameCmdList[index]);
 							}
-							cachedPendingCommands[frameCount].clear();
 
 							if (frameCount >= 0) {
 								for (int index = 0; index < GameConstants::maxPlayers; ++index) {
-									//printf("X**X Frame: %d faction: %d local CRC: %u Remote CRC: %u\n",frameCount,index,getNetworkPlayerFactionCRC(index),cachedPendingCommandCRCs[frameCount][index]);
+									//printf("X**X Frame: %d faction: %d local CRC: %u Remote CRC: %u\n",frameCount,index,getNetworkPlayerFactionCRC(index),pendingFrame->factionCRCs[index]);
 
-									if (cachedPendingCommandCRCs[frameCount][index] != getNetworkPlayerFactionCRC(index)) {
+									if (pendingFrame->factionCRCs[index] != getNetworkPlayerFactionCRC(index)) {
 
-										printf("X**X Frame: %d faction: %d local CRC: %u Remote CRC: %u\n", frameCount, index, getNetworkPlayerFactionCRC(index), cachedPendingCommandCRCs[frameCount][index]);
+										printf("X**X Frame: %d faction: %d local CRC: %u Remote CRC: %u\n", frameCount, index, getNetworkPlayerFactionCRC(index), pendingFrame->factionCRCs[index]);
 
 										string sErr = "Player: " + getHumanPlayerName() +
 											" got a Network CRC error, CRC's do not match, server CRC = " +
-											uIntToStr(cachedPendingCommandCRCs[frameCount][index]) + ", local CRC = " +
+											uIntToStr(pendingFrame->factionCRCs[index]) + ", local CRC = " +
 											uIntToStr(getNetworkPlayerFactionCRC(index));
 										sendTextMessage(sErr, -1, true, "");
 										DisplayErrorMessage(sErr);
@@ -1453,8 +1518,13 @@ namespace Glest {
 									}
 								}
 							}
-							cachedPendingCommandCRCs.erase(frameCount);
 						}
+						pendingFrame->release();
+						if (pendingFrameOverflow.empty() == false) {
+							pendingFrameOverflow.erase(frameCount);
+						}
+						lastReadPendingFrameCount = frameCount;
+						pendingFrameWaiting = false;
 						if (waitForData == true) {
 							timeClientWaitedForLastMessage = chrono.getMillis();
 							chrono.stop();
@@ -1464,6 +1534,11 @@ namespace Glest {
 						result = true;
 						break;
 					} else {
+						// Drop wake ups left over from an earlier wait that
+						// timed out, then flag this one
+						for (; pendingFrameArrived.tryDecrement() == true;) {
+						}
+						pendingFrameWaiting = true;
 						safeMutex.ReleaseLock(true);
 						// No data for this frame
 						if (waitForData == false) {
@@ -1471,13 +1546,16 @@ namespace Glest {
 							chrono.start();
 						}
 						if (copyCachedLastPendingFrameCount > frameCountAsUInt64) {
+							safeMutex.Lock();
+							pendingFrameWaiting = false;
+							safeMutex.ReleaseLock(true);
 							break;
 						}
 
-						if (waitForData == false) {
-							waitForData = true;
-							sleep(0);
-						}
+						// Sleep until the network thread stores a frame instead of
+						// polling the lock
+						waitForData = true;
+						pendingFrameArrived.waitTillSignalled(pendingFrameWaitMilliseconds);
 
 						waitCount++;
 						//printf("Client waiting for packet for frame: %d, currentCachedPendingCommandsIndex = %d, cachedPendingCommandsIndex = %lld\n",frameCount,currentCachedPendingCommandsIndex,(long long int)cachedPendingCommandsIndex);
@@ -1922,8 +2000,9 @@ namespace Glest {
 			sendMessage(&networkMessageMarkCell);
 		}
 
-		void ClientInterface::sendPingMessage(int32 pingFrequency, int64 pingTime) {
-			NetworkMessagePing networkMessagePing(pingFrequency, pingTime);
+		void ClientInterface::sendPingMessage(int32 pingFrequency, int64 pingTime,
+			NetworkPingType pingType, int64 pingEchoTime) {
+			NetworkMessagePing networkMessagePing(pingFrequency, pingTime, pingType, pingEchoTime);
 			sendMessage(&networkMessagePing);
 		}
 
@@ -2098,6 +2177,42 @@ namespace Glest {
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
 		}
 
+		void ClientInterface::applyGameSetup(const NetworkMessageLaunch &networkMessageLaunch) {
+			networkMessageLaunch.buildGameSettings(&gameSettings);
+
+			//printf("Client got game settings playerIndex = %d lookingfor match...\n",playerIndex);
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Lined: %d] got networkMessageLaunch.getMessageType() = %d\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, networkMessageLaunch.getMessageType());
+			//replace server player by network
+			for (int factionIndex = 0; factionIndex < gameSettings.getFactionCount(); ++factionIndex) {
+
+				//printf("Faction = %d start location = %d faction name = %s\n",i,gameSettings.getStartLocationIndex(factionIndex),gameSettings.getFactionTypeName(factionIndex).c_str());
+
+				//replace by network
+				if (gameSettings.getFactionControl(factionIndex) == ctHuman) {
+					gameSettings.setFactionControl(factionIndex, ctNetwork);
+				}
+
+				//printf("factionIndex = %d gameSettings.getStartLocationIndex(factionIndex) = %d playerIndex = %d, gameSettings.getFactionControl(factionIndex) = %d\n",factionIndex,gameSettings.getStartLocationIndex(factionIndex),playerIndex,gameSettings.getFactionControl(i));
+
+				//set the faction index
+				if (gameSettings.getStartLocationIndex(factionIndex) == playerIndex) {
+					//printf("Setting my factionindex to: %d for playerIndex: %d\n",i,playerIndex);
+
+					gameSettings.setThisFactionIndex(factionIndex);
+
+					//printf("Client got game settings playerIndex = %d factionIndex = %d control = %d name = %s\n",playerIndex,factionIndex,gameSettings.getFactionControl(factionIndex),gameSettings.getFactionTypeName(i).c_str());
+					if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] gameSettings.getThisFactionIndex(factionIndex) = %d, playerIndex = %d, factionIndex = %d\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, gameSettings.getThisFactionIndex(), playerIndex, factionIndex);
+				}
+			}
+
+			if (networkMessageLaunch.getMessageType() == nmtLaunch) {
+				launchGame = true;
+			} else if (networkMessageLaunch.getMessageType() == nmtBroadCastSetup) {
+				setGameSettingsReceived(true);
+			}
+		}
+
 		bool ClientInterface::shouldDiscardNetworkMessage(NetworkMessageType networkMessageType) {
 			bool discard = false;
 
@@ -2115,6 +2230,9 @@ namespace Glest {
 					NetworkMessagePing msg = NetworkMessagePing();
 					this->receiveMessage(&msg);
 					this->setLastPingInfo(msg);
+					if (msg.getPingType() == nptRoundTrip) {
+						sendPingMessage(msg.getPingFrequency(), time(NULL), nptRoundTripReply, msg.getPingTime());
+					}
 				}
 				break;
 				case nmtLaunch:
@@ -2124,6 +2242,13 @@ namespace Glest {
 					this->receiveMessage(&msg);
 				}
 				break;
+				case nmtBroadCastSetupDelta:
+				{
+					discard = true;
+					NetworkMessageLaunchDelta msg = NetworkMessageLaunchDelta();
+					this->receiveMessage(&msg);
+				}
+				break;
 				case nmtText:
 				{
 					if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] got nmtText\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
@@ -71,6 +71,26 @@ namespace Glest {
 			static const int messageWaitTimeout;
 			static const int waitSleepTime;
 			static const int maxNetworkCommandListSendTimeWait;
+			static const int pendingFrameRingSize = 128;
+			static const int pendingFrameWaitMilliseconds;
+
+			// Commands the server sent for one frame, handed from the network
+			// thread to the game thread
+			class PendingFrameCommands {
+			public:
+				int frameCount;
+				bool used;
+				Commands commands;
+				vector<uint32> factionCRCs;
+
+				PendingFrameCommands() : frameCount(0), used(false) {
+				}
+				void release() {
+					used = false;
+					commands.clear();
+					factionCRCs.clear();
+				}
+			};
 
 		private:
 			ClientSocket * clientSocket;
@@ -101,8 +121,13 @@ namespace Glest {
 			ClientInterfaceThread *networkCommandListThread;
 
 			Mutex *networkCommandListThreadAccessor;
-			std::map<int, Commands> cachedPendingCommands;	//commands ready to be given
-			std::map<int, vector<uint32> > cachedPendingCommandCRCs;	//commands ready to be given
+			// Ring of frames indexed by frame count, frames that collide with
+			// one still waiting to be read go to the overflow map
+			PendingFrameCommands pendingFrameRing[pendingFrameRingSize];
+			std::map<int, PendingFrameCommands> pendingFrameOverflow;
+			int lastReadPendingFrameCount;
+			Semaphore pendingFrameArrived;
+			bool pendingFrameWaiting;
 			uint64 cachedPendingCommandsIndex;
 			uint64 cachedLastPendingFrameCount;
 			int64 timeClientWaitedForLastMessage;
@@ -116,6 +141,15 @@ namespace Glest {
 			Mutex *quitThreadAccessor;
 			bool quitThread;
 
+			// Lobby settings last received from the server, the base for setup deltas
+			vector<unsigned char> gameSetupSnapshot;
+			uint32 gameSetupSequence;
+
+			void applyGameSetup(const NetworkMessageLaunch &networkMessageLaunch);
+
+			PendingFrameCommands * storePendingFrame(int frameCount);
+			PendingFrameCommands * findPendingFrame(int frameCount);
+
 			bool getQuitThread();
 			void setQuitThread(bool value);
 			bool getQuit();
@@ -204,7 +238,8 @@ namespace Glest {
 				return currentFrameCount;
 			}
 
-			virtual void sendPingMessage(int32 pingFrequency, int64 pingTime);
+			virtual void sendPingMessage(int32 pingFrequency, int64 pingTime,
+				NetworkPingType pingType = nptKeepAlive, int64 pingEchoTime = 0);
 
 			const string &getVersionString() const {
 				return versionString;
@@ -369,6 +369,10 @@ namespace Glest {
 			this->socket = NULL;
 			this->mutexCloseConnection = new Mutex(CODE_AT_LINE);
 			this->mutexPendingNetworkCommandList = new Mutex(CODE_AT_LINE);
+			this->mutexRoundTrip = new Mutex(CODE_AT_LINE);
+			this->mutexGameSetup = new Mutex(CODE_AT_LINE);
+			this->gameSetupSequence = 0;
+			this->gameSetupResyncRequested = false;
 			this->socketSynchAccessor = new Mutex(CODE_AT_LINE);
 			this->connectedRemoteIPAddress = 0;
 			this->sessionKey = 0;
@@ -386,6 +390,7 @@ namespace Glest {
 			this->receivedNetworkGameStatus = false;
 
 			this->autoPauseGameCountForLag = 0;
+			resetRoundTrip();
 			this->skipLagCheck = false;
 			this->joinGameInProgress = false;
 			this->canAcceptConnections = true;
@@ -462,6 +467,12 @@ namespace Glest {
 			delete mutexPendingNetworkCommandList;
 			mutexPendingNetworkCommandList = NULL;
 
+			delete mutexRoundTrip;
+			mutexRoundTrip = NULL;
+
+			delete mutexGameSetup;
+			mutexGameSetup = NULL;
+
 			delete mutexCloseConnection;
 			mutexCloseConnection = NULL;
 
@@ -479,6 +490,89 @@ namespace Glest {
 			autoPauseGameCountForLag++;
 		}
 
+		void ConnectionSlot::resetRoundTrip() {
+			MutexSafeWrapper safeMutex(mutexRoundTrip, CODE_AT_LINE);
+			roundTripMillis = 0;
+			roundTripJitterMillis = 0;
+			roundTripSampleCount = 0;
+		}
+
+		int ConnectionSlot::getRoundTripEstimate(double &roundTripMillis, double &roundTripJitterMillis) {
+			MutexSafeWrapper safeMutex(mutexRoundTrip, CODE_AT_LINE);
+			roundTripMillis = this->roundTripMillis;
+			roundTripJitterMillis = this->roundTripJitterMillis;
+			return roundTripSampleCount;
+		}
+
+		void ConnectionSlot::addRoundTripSample(const NetworkMessagePing &ping) {
+			// Only replies to the server's own round trip pings carry our send time
+			if (ping.getPingType() != nptRoundTripReply) {
+				return;
+			}
+			double sample = (double) (Chrono::getCurMillis() - ping.getPingEchoTime());
+			if (sample < 0) {
+				return;
+			}
+
+			MutexSafeWrapper safeMutex(mutexRoundTrip, CODE_AT_LINE);
+
+			// Smoothed round trip and mean deviation, weighted like TCP's estimator
+			if (roundTripSampleCount == 0) {
+				roundTripMillis = sample;
+				roundTripJitterMillis = sample / 2.0;
+			} else {
+				roundTripJitterMillis += (std::fabs(sample - roundTripMillis) - roundTripJitterMillis) / 4.0;
+				roundTripMillis += (sample - roundTripMillis) / 8.0;
+			}
+			roundTripSampleCount++;
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] playerIndex = %d sample = %f roundTripMillis = %f roundTripJitterMillis = %f\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, playerIndex, sample, roundTripMillis, roundTripJitterMillis);
+		}
+
+		void ConnectionSlot::sendGameSetup(const NetworkMessageLaunch &networkMessageLaunch, bool forceFull) {
+			vector<unsigned char> snapshot = networkMessageLaunch.getSnapshot();
+
+			MutexSafeWrapper safeMutex(mutexGameSetup, CODE_AT_LINE);
+			gameSetupResyncRequested = false;
+			if (forceFull == false && gameSetupSnapshot.size() == snapshot.size()) {
+				if (gameSetupSnapshot == snapshot) {
+					return;
+				}
+
+				NetworkMessageLaunchDelta networkMessageLaunchDelta(gameSetupSequence, gameSetupSnapshot, snapshot);
+				if (networkMessageLaunchDelta.getDataSize() <= (size_t) maxGameSetupDeltaBytes) {
+					sendMessage(&networkMessageLaunchDelta);
+					gameSetupSequence = networkMessageLaunchDelta.getSequence();
+					gameSetupSnapshot.swap(snapshot);
+					return;
+				}
+			}
+
+			NetworkMessageLaunch fullMessage(networkMessageLaunch);
+			sendMessage(&fullMessage);
+			gameSetupSequence = 0;
+			gameSetupSnapshot.swap(snapshot);
+		}
+
+		void ConnectionSlot::resetGameSetup() {
+			MutexSafeWrapper safeMutex(mutexGameSetup, CODE_AT_LINE);
+			gameSetupSnapshot.clear();
+			gameSetupSequence = 0;
+			gameSetupResyncRequested = false;
+		}
+
+		void ConnectionSlot::requestGameSetupResync() {
+			MutexSafeWrapper safeMutex(mutexGameSetup, CODE_AT_LINE);
+			gameSetupSnapshot.clear();
+			gameSetupSequence = 0;
+			gameSetupResyncRequested = true;
+		}
+
+		bool ConnectionSlot::getGameSetupResyncRequested() {
+			MutexSafeWrapper safeMutex(mutexGameSetup, CODE_AT_LINE);
+			return gameSetupResyncRequested;
+		}
+
 		bool ConnectionSlot::getGameStarted() {
 			bool result = false;
 			if (this->slotThreadWorker != NULL) {
@@ -685,6 +779,7 @@ namespace Glest {
 									if (receiveMessage(&networkMessagePing)) {
 										if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 										lastPingInfo = networkMessagePing;
+										addRoundTripSample(networkMessagePing);
 									} else {
 										if (SystemFlags::getSystemSettingType(SystemFlags::debugError).enabled) SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d]\nInvalid message type before intro handshake [%d]\nDisconnecting socket for slot: %d [%s].\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, networkMessageType, this->playerIndex, this->getIpAddress().c_str());
 										this->serverInterface->notifyBadClientConnectAttempt(this->getIpAddress());
@@ -1318,6 +1413,25 @@ namespace Glest {
 								case nmtLoadingStatusMessage:
 									break;
 
+								case nmtBroadCastSetupDelta:
+								{
+									NetworkMessageLaunchDelta networkMessageLaunchDelta;
+									if (gotIntro == true && receiveMessage(&networkMessageLaunchDelta)) {
+										// The client lost track of the settings, send it a full snapshot
+										if (networkMessageLaunchDelta.isResyncRequest() == true) {
+											if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] setup resync requested by slot: %d\n", __FILE__, __FUNCTION__, __LINE__, this->playerIndex);
+
+											requestGameSetupResync();
+										}
+									} else {
+										if (SystemFlags::getSystemSettingType(SystemFlags::debugError).enabled) SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d]\nInvalid message type before intro handshake [%d]\nDisconnecting socket for slot: %d [%s].\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, networkMessageType, this->playerIndex, this->getIpAddress().c_str());
+										this->serverInterface->notifyBadClientConnectAttempt(this->getIpAddress());
+										close();
+										return;
+									}
+								}
+								break;
+
 								default:
 								{
 									if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] networkMessageType = %d\n", __FILE__, __FUNCTION__, __LINE__, networkMessageType);
@@ -1453,6 +1567,8 @@ namespace Glest {
 			this->unPauseForInGameConnection = false;
 			this->ready = false;
 			this->connectedTime = 0;
+			resetRoundTrip();
+			resetGameSetup();
 
 			if (this->slotThreadWorker != NULL) {
 				if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
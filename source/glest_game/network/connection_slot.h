@@ -181,6 +181,23 @@ namespace Glest {
 
 			int autoPauseGameCountForLag;
 
+			// Written by the slot thread, read by the server's keyframe update
+			Mutex *mutexRoundTrip;
+			double roundTripMillis;
+			double roundTripJitterMillis;
+			int roundTripSampleCount;
+
+			void resetRoundTrip();
+
+			// Larger setup deltas are replaced by the compressed full settings
+			static const int maxGameSetupDeltaBytes = 1024;
+
+			// Settings snapshot this client last received and its sequence
+			Mutex *mutexGameSetup;
+			vector<unsigned char> gameSetupSnapshot;
+			uint32 gameSetupSequence;
+			bool gameSetupResyncRequested;
+
 		public:
 			ConnectionSlot(ServerInterface* serverInterface, int playerIndex);
 			~ConnectionSlot();
@@ -312,6 +329,16 @@ namespace Glest {
 				return lastReceiveCommandListTime;
 			}
 
+			// Sends only the settings that changed since the last setup sent
+			// to this client, or the full settings when there is no base yet
+			void sendGameSetup(const NetworkMessageLaunch &networkMessageLaunch, bool forceFull = false);
+			void resetGameSetup();
+			void requestGameSetupResync();
+			bool getGameSetupResyncRequested();
+
+			void addRoundTripSample(const NetworkMessagePing &ping);
+			int getRoundTripEstimate(double &roundTripMillis, double &roundTripJitterMillis);
+
 			bool getLagCountWarning() const {
 				return gotLagCountWarning;
 			}
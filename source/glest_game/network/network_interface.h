@@ -288,6 +288,9 @@ namespace Glest {
 			GameSettings * getGameSettingsPtr() {
 				return &gameSettings;
 			}
+			virtual void setNetworkFramePeriod(int value) {
+				gameSettings.setNetworkFramePeriod(value);
+			}
 
 			static void setAllowDownloadDataSynch(bool value) {
 				allowDownloadDataSynch = value;
@@ -26,6 +26,7 @@
 #include "util.h"
 #include "game_settings.h"
 #include "checksum.h"
+#include "byte_delta.h"
 #include "platform_util.h"
 #include "config.h"
 #include "network_protocol.h"
@@ -511,18 +512,23 @@ namespace Glest {
 			messageType = nmtPing;
 			data.pingFrequency = 0;
 			data.pingTime = 0;
+			data.pingEchoTime = 0;
+			data.pingType = nptKeepAlive;
 			pingReceivedLocalTime = 0;
 		}
 
-		NetworkMessagePing::NetworkMessagePing(int32 pingFrequency, int64 pingTime) {
+		NetworkMessagePing::NetworkMessagePing(int32 pingFrequency, int64 pingTime,
+			NetworkPingType pingType, int64 pingEchoTime) {
 			messageType = nmtPing;
 			data.pingFrequency = pingFrequency;
 			data.pingTime = pingTime;
+			data.pingEchoTime = pingEchoTime;
+			data.pingType = pingType;
 			pingReceivedLocalTime = 0;
 		}
 
 		const char * NetworkMessagePing::getPackedMessageFormat() const {
-			return "clq";
+			return "clqqc";
 		}
 
 		unsigned int NetworkMessagePing::getPackedSize() {
@@ -532,11 +538,15 @@ namespace Glest {
 				messageType = 0;
 				packedData.pingFrequency = 0;
 				packedData.pingTime = 0;
+				packedData.pingEchoTime = 0;
+				packedData.pingType = 0;
 				unsigned char *buf = new unsigned char[sizeof(packedData) * 3];
 				result = pack(buf, getPackedMessageFormat(),
 					messageType,
 					packedData.pingFrequency,
-					packedData.pingTime);
+					packedData.pingTime,
+					packedData.pingEchoTime,
+					packedData.pingType);
 				delete[] buf;
 			}
 			return result;
@@ -545,7 +555,9 @@ namespace Glest {
 			unpack(buf, getPackedMessageFormat(),
 				&messageType,
 				&data.pingFrequency,
-				&data.pingTime);
+				&data.pingTime,
+				&data.pingEchoTime,
+				&data.pingType);
 		}
 
 		unsigned char * NetworkMessagePing::packMessage() {
@@ -553,7 +565,9 @@ namespace Glest {
 			pack(buf, getPackedMessageFormat(),
 				messageType,
 				data.pingFrequency,
-				data.pingTime);
+				data.pingTime,
+				data.pingEchoTime,
+				data.pingType);
 			return buf;
 		}
 
@@ -600,6 +614,7 @@ namespace Glest {
 				messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
 				data.pingFrequency = Shared::PlatformByteOrder::toCommonEndian(data.pingFrequency);
 				data.pingTime = Shared::PlatformByteOrder::toCommonEndian(data.pingTime);
+				data.pingEchoTime = Shared::PlatformByteOrder::toCommonEndian(data.pingEchoTime);
 			}
 		}
 		void NetworkMessagePing::fromEndian() {
@@ -608,6 +623,7 @@ namespace Glest {
 				messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
 				data.pingFrequency = Shared::PlatformByteOrder::fromCommonEndian(data.pingFrequency);
 				data.pingTime = Shared::PlatformByteOrder::fromCommonEndian(data.pingTime);
+				data.pingEchoTime = Shared::PlatformByteOrder::fromCommonEndian(data.pingEchoTime);
 			}
 		}
 
@@ -1459,6 +1475,18 @@ namespace Glest {
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance, "In [%s::%s Line: %d] took msecs: %lld\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, chrono.getMillis());
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) chrono.start();
 
+			nullTerminateStrings();
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance, "In [%s::%s Line: %d] took msecs: %lld\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, chrono.getMillis());
+
+			//for(int i= 0; i < GameConstants::maxPlayers; ++i){
+			//	printf("Receive index: %d resource multiplier index: %d sizeof(data): %d\n",i,data.resourceMultiplierIndex[i],sizeof(data));
+			//}
+
+			return result;
+		}
+
+		void NetworkMessageLaunch::nullTerminateStrings() {
 			data.description.nullTerminate();
 			data.map.nullTerminate();
 			data.tileset.nullTerminate();
@@ -1478,14 +1506,26 @@ namespace Glest {
 			data.scenario.nullTerminate();
 
 			data.gameUUID.nullTerminate();
+		}
 
-			if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance, "In [%s::%s Line: %d] took msecs: %lld\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, chrono.getMillis());
+		vector<unsigned char> NetworkMessageLaunch::getSnapshot() const {
+			NetworkMessageLaunch commonEndian(*this);
+			commonEndian.toEndian();
 
-			//for(int i= 0; i < GameConstants::maxPlayers; ++i){
-			//	printf("Receive index: %d resource multiplier index: %d sizeof(data): %d\n",i,data.resourceMultiplierIndex[i],sizeof(data));
-			//}
+			const unsigned char *buffer = reinterpret_cast<const unsigned char *>(&commonEndian.data);
+			return vector<unsigned char>(buffer, buffer + sizeof(Data));
+		}
 
-			return result;
+		void NetworkMessageLaunch::setSnapshot(const vector<unsigned char> &snapshot, int8 messageType) {
+			if (snapshot.size() != sizeof(Data)) {
+				char szBuf[1024] = "";
+				snprintf(szBuf, 1023, "Invalid launch snapshot size: %d expected: %d", (int) snapshot.size(), (int) sizeof(Data));
+				throw megaglest_runtime_error(szBuf);
+			}
+			memcpy(&data, &snapshot[0], sizeof(Data));
+			fromEndian();
+			nullTerminateStrings();
+			this->messageType = messageType;
 		}
 
 		unsigned char * NetworkMessageLaunch::getData() {
@@ -1634,6 +1674,110 @@ namespace Glest {
 			}
 		}
 
+		// =====================================================
+		//	class NetworkMessageLaunchDelta
+		// =====================================================
+
+		NetworkMessageLaunchDelta::NetworkMessageLaunchDelta() {
+			data.messageType = nmtBroadCastSetupDelta;
+			data.header.sequence = 0;
+			data.header.baseSequence = 0;
+			data.header.snapshotCRC = 0;
+			data.header.runCount = 0;
+			data.header.payloadSize = 0;
+		}
+
+		NetworkMessageLaunchDelta::NetworkMessageLaunchDelta(uint32 baseSequence,
+			const vector<unsigned char> &baseSnapshot, const vector<unsigned char> &snapshot) {
+			data.messageType = nmtBroadCastSetupDelta;
+			data.header.sequence = baseSequence + 1;
+			data.header.baseSequence = baseSequence;
+			data.header.snapshotCRC = getSnapshotCRC(snapshot);
+			data.header.runCount = 0;
+			data.header.payloadSize = 0;
+
+			if (baseSnapshot.size() != snapshot.size()) {
+				throw megaglest_runtime_error("Launch delta snapshots differ in size");
+			}
+
+			data.header.runCount = (uint16) ByteDelta::encode(baseSnapshot, snapshot, data.payload, maxRunGapBytes);
+			data.header.payloadSize = (uint16) data.payload.size();
+		}
+
+		uint32 NetworkMessageLaunchDelta::getSnapshotCRC(const vector<unsigned char> &snapshot) {
+			Checksum checksum;
+			if (snapshot.empty() == false) {
+				checksum.addBytes(&snapshot[0], snapshot.size());
+			}
+			return checksum.getSum();
+		}
+
+		bool NetworkMessageLaunchDelta::apply(vector<unsigned char> &snapshot) const {
+			vector<unsigned char> result(snapshot);
+			if (ByteDelta::apply(data.payload, data.header.runCount, result) == false) {
+				return false;
+			}
+
+			if (getSnapshotCRC(result) != data.header.snapshotCRC) {
+				return false;
+			}
+			snapshot.swap(result);
+			return true;
+		}
+
+		bool NetworkMessageLaunchDelta::receive(Socket* socket) {
+			bool result = NetworkMessage::receive(socket, &data.header, sizeof(data.header), true);
+			fromEndianHeader();
+			data.payload.clear();
+			if (result == true && data.header.payloadSize > 0) {
+				data.payload.resize(data.header.payloadSize);
+				result = NetworkMessage::receive(socket, &data.payload[0], data.header.payloadSize, true);
+			}
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] sequence = %u, baseSequence = %u, runCount = %u, payloadSize = %u\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, data.header.sequence, data.header.baseSequence, data.header.runCount, data.header.payloadSize);
+			return result;
+		}
+
+		void NetworkMessageLaunchDelta::send(Socket* socket) {
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] sequence = %u, baseSequence = %u, runCount = %u, payloadSize = %u\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, data.header.sequence, data.header.baseSequence, data.header.runCount, data.header.payloadSize);
+
+			DataHeader header = data.header;
+			toEndianHeader();
+
+			int headerSize = sizeof(data.header);
+			int payloadSize = (int) data.payload.size();
+			unsigned char *send_buffer = new unsigned char[headerSize + payloadSize];
+			memcpy(send_buffer, &data.header, headerSize);
+			if (payloadSize > 0) {
+				memcpy(&send_buffer[headerSize], &data.payload[0], payloadSize);
+			}
+			data.header = header;
+
+			NetworkMessage::send(socket, send_buffer, headerSize + payloadSize, data.messageType);
+			delete[] send_buffer;
+		}
+
+		void NetworkMessageLaunchDelta::toEndianHeader() {
+			static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
+			if (bigEndianSystem == true) {
+				data.header.sequence = Shared::PlatformByteOrder::toCommonEndian(data.header.sequence);
+				data.header.baseSequence = Shared::PlatformByteOrder::toCommonEndian(data.header.baseSequence);
+				data.header.snapshotCRC = Shared::PlatformByteOrder::toCommonEndian(data.header.snapshotCRC);
+				data.header.runCount = Shared::PlatformByteOrder::toCommonEndian(data.header.runCount);
+				data.header.payloadSize = Shared::PlatformByteOrder::toCommonEndian(data.header.payloadSize);
+			}
+		}
+
+		void NetworkMessageLaunchDelta::fromEndianHeader() {
+			static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
+			if (bigEndianSystem == true) {
+				data.header.sequence = Shared::PlatformByteOrder::fromCommonEndian(data.header.sequence);
+				data.header.baseSequence = Shared::PlatformByteOrder::fromCommonEndian(data.header.baseSequence);
+				data.header.snapshotCRC = Shared::PlatformByteOrder::fromCommonEndian(data.header.snapshotCRC);
+				data.header.runCount = Shared::PlatformByteOrder::fromCommonEndian(data.header.runCount);
+				data.header.payloadSize = Shared::PlatformByteOrder::fromCommonEndian(data.header.payloadSize);
+			}
+		}
+
 		// =====================================================
 		//	class NetworkMessageLaunch
 		// =====================================================
@@ -61,6 +61,7 @@ namespace Glest {
 			nmtMarkCell,
 			nmtUnMarkCell,
 			nmtHighlightCell,
+			nmtBroadCastSetupDelta,
 			//	nmtCompressedPacket,
 
 			nmtCount
@@ -258,6 +259,13 @@ namespace Glest {
 		//	Message sent at any time
 		// =====================================================
 
+		enum NetworkPingType {
+			nptKeepAlive,
+			// Sent by the server in game, clients answer with a reply
+			nptRoundTrip,
+			nptRoundTripReply
+		};
+
 #pragma pack(push, 1)
 		class NetworkMessagePing : public NetworkMessage {
 		private:
@@ -265,6 +273,8 @@ namespace Glest {
 			struct Data {
 				int32 pingFrequency;
 				int64 pingTime;
+				int64 pingEchoTime;
+				int8 pingType;
 			};
 			void toEndian();
 			void fromEndian();
@@ -281,7 +291,8 @@ namespace Glest {
 
 		public:
 			NetworkMessagePing();
-			NetworkMessagePing(int32 pingFrequency, int64 pingTime);
+			NetworkMessagePing(int32 pingFrequency, int64 pingTime,
+				NetworkPingType pingType = nptKeepAlive, int64 pingEchoTime = 0);
 
 			virtual size_t getDataSize() const {
 				return sizeof(Data);
@@ -297,6 +308,13 @@ namespace Glest {
 			int64 getPingTime() const {
 				return data.pingTime;
 			}
+			// The pingTime of the ping this one answers, 0 if it is not a reply
+			int64 getPingEchoTime() const {
+				return data.pingEchoTime;
+			}
+			NetworkPingType getPingType() const {
+				return static_cast<NetworkPingType>(data.pingType);
+			}
 			int64 getPingReceivedLocalTime() const {
 				return pingReceivedLocalTime;
 			}
@@ -425,6 +443,7 @@ namespace Glest {
 			};
 			void toEndian();
 			void fromEndian();
+			void nullTerminateStrings();
 			std::pair<unsigned char *, unsigned long> getCompressedMessage();
 		private:
 			Data data;
@@ -464,6 +483,10 @@ namespace Glest {
 			}
 			vector<pair<string, uint32> > getFactionCRCList() const;
 
+			// The settings in common byte order, used as base for setup deltas
+			vector<unsigned char> getSnapshot() const;
+			void setSnapshot(const vector<unsigned char> &snapshot, int8 messageType);
+
 			virtual bool receive(Socket* socket);
 			virtual bool receive(Socket* socket, NetworkMessageType type);
 
@@ -471,6 +494,92 @@ namespace Glest {
 		};
 #pragma pack(pop)
 
+		// =====================================================
+		//	class NetworkMessageLaunchDelta
+		//
+		//	Message sent from the server to a client with the
+		//	byte ranges of the lobby settings snapshot that
+		//	changed since the last setup sent to that client.
+		//	A client that can not apply it sends one back with
+		//	sequence 0 to request a full snapshot.
+		// =====================================================
+
+#pragma pack(push, 1)
+		class NetworkMessageLaunchDelta : public NetworkMessage {
+		private:
+			// Unchanged gaps up to this size are sent instead of starting a new run
+			static const int maxRunGapBytes = 4;
+
+			struct DataHeader {
+				uint32 sequence;
+				uint32 baseSequence;
+				uint32 snapshotCRC;
+				uint16 runCount;
+				uint16 payloadSize;
+			};
+
+			struct Data {
+				int8 messageType;
+				DataHeader header;
+				// runs of: uint16 offset, uint16 length, bytes
+				vector<unsigned char> payload;
+			};
+			void toEndianHeader();
+			void fromEndianHeader();
+
+		private:
+			Data data;
+
+		protected:
+			virtual const char * getPackedMessageFormat() const {
+				return NULL;
+			}
+			virtual unsigned int getPackedSize() {
+				return 0;
+			}
+			virtual void unpackMessage(unsigned char *buf) {
+			};
+			virtual unsigned char * packMessage() {
+				return NULL;
+			}
+
+		public:
+			NetworkMessageLaunchDelta();
+			NetworkMessageLaunchDelta(uint32 baseSequence,
+				const vector<unsigned char> &baseSnapshot, const vector<unsigned char> &snapshot);
+
+			static uint32 getSnapshotCRC(const vector<unsigned char> &snapshot);
+
+			virtual size_t getDataSize() const {
+				return sizeof(DataHeader) + data.payload.size();
+			}
+
+			virtual NetworkMessageType getNetworkMessageType() const {
+				return nmtBroadCastSetupDelta;
+			}
+
+			uint32 getSequence() const {
+				return data.header.sequence;
+			}
+			uint32 getBaseSequence() const {
+				return data.header.baseSequence;
+			}
+			int getRunCount() const {
+				return data.header.runCount;
+			}
+			bool isResyncRequest() const {
+				return data.header.sequence == 0;
+			}
+
+			// Applies the runs to the snapshot, fails without touching it when
+			// the runs are out of range or the result does not match the CRC
+			bool apply(vector<unsigned char> &snapshot) const;
+
+			virtual bool receive(Socket* socket);
+			virtual void send(Socket* socket);
+		};
+#pragma pack(pop)
+
 		// =====================================================
 		//	class CommandList
 		//
@@ -83,7 +83,8 @@ namespace Glest {
 			nctSwitchTeamVote,
 			nctPauseResume,
 			nctPlayerStatusChange,
-			nctDisconnectNetworkPlayer
+			nctDisconnectNetworkPlayer,
+			nctNetworkFramePeriod
 			//nctNetworkCommand
 		};
 
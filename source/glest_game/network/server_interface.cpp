@@ -63,6 +63,9 @@ namespace Glest {
 
 			this->clientLagCallbackInterface = clientLagCallbackInterface;
 			this->clientsAutoPausedDueToLag = false;
+			this->adaptiveNetworkFramePeriod = Config::getInstance().getBool("AdaptiveNetworkFramePeriod", "true");
+			this->pendingGameSetupValid = false;
+			this->lastGameSetupValid = false;
 
 			allowInGameConnections = false;
 			gameLaunched = false;
@@ -1481,6 +1484,7 @@ namespace Glest {
 
 				processTextMessageQueue();
 				processBroadCastMessageQueue();
+				processPendingGameSetup();
 
 				checkForAutoResumeForLaggingClients();
 
@@ -1656,10 +1660,104 @@ namespace Glest {
 			}
 		}
 
+		void ServerInterface::setNetworkFramePeriod(int value) {
+			GameNetworkInterface::setNetworkFramePeriod(value);
+			for (int index = 0; index < GameConstants::maxPlayers; ++index) {
+				MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[index], CODE_AT_LINE_X(index));
+				ConnectionSlot *connectionSlot = slots[index];
+				if (connectionSlot != NULL) {
+					connectionSlot->setNetworkFramePeriod(value);
+				}
+			}
+		}
+
+		int ServerInterface::calculateNetworkFramePeriod(double latencyMillis, int currentFramePeriod) {
+			// Commands of a keyframe have to reach the clients before they
+			// simulate that frame, keep two latencies worth of frames in hand
+			double millisPerFrame = 1000.0 / GameConstants::updateFps;
+			int framePeriod = (int) std::ceil((latencyMillis * 2.0) / millisPerFrame);
+			framePeriod = ((framePeriod + NETWORK_FRAME_PERIOD_STEP - 1) / NETWORK_FRAME_PERIOD_STEP) * NETWORK_FRAME_PERIOD_STEP;
+			framePeriod = max(GameConstants::minNetworkFramePeriod, min(GameConstants::maxNetworkFramePeriod, framePeriod));
+
+			// Grow at once when the link gets worse but shrink one step at a time
+			if (framePeriod < currentFramePeriod) {
+				framePeriod = max(framePeriod, currentFramePeriod - NETWORK_FRAME_PERIOD_STEP);
+			}
+			return framePeriod;
+		}
+
+		void ServerInterface::sendRoundTripPing() {
+			if (roundTripPingTimer.isStarted() == true &&
+				roundTripPingTimer.getMillis() < ROUND_TRIP_PING_INTERVAL_MILLISECONDS) {
+				return;
+			}
+			if (roundTripPingTimer.isStarted() == true) {
+				roundTripPingTimer.stop();
+				roundTripPingTimer.reset();
+			}
+			roundTripPingTimer.start();
+
+			// Clients echo the send time back so the slots can time the round trip
+			NetworkMessagePing networkMessagePing(GameConstants::networkPingInterval, Chrono::getCurMillis(), nptRoundTrip);
+			broadcastPing(&networkMessagePing);
+		}
+
+		void ServerInterface::checkForNetworkFramePeriodChange() {
+			if (networkFramePeriodChangeTimer.isStarted() == true &&
+				networkFramePeriodChangeTimer.getMillis() < NETWORK_FRAME_PERIOD_CHANGE_INTERVAL_MILLISECONDS) {
+				return;
+			}
+
+			// Plan for the slowest client and wait until every client was measured
+			double worstLatencyMillis = -1;
+			for (int index = 0; index < GameConstants::maxPlayers; ++index) {
+				MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[index], CODE_AT_LINE_X(index));
+				ConnectionSlot *connectionSlot = slots[index];
+				if (connectionSlot != NULL && connectionSlot->isConnected() == true) {
+					double roundTripMillis = 0;
+					double roundTripJitterMillis = 0;
+					if (connectionSlot->getRoundTripEstimate(roundTripMillis, roundTripJitterMillis) < MIN_ROUND_TRIP_SAMPLES) {
+						return;
+					}
+					double latencyMillis = roundTripMillis + (roundTripJitterMillis * 2.0);
+					worstLatencyMillis = max(worstLatencyMillis, latencyMillis);
+				}
+			}
+			if (worstLatencyMillis < 0) {
+				return;
+			}
+
+			int currentFramePeriod = gameSettings.getNetworkFramePeriod();
+			int newFramePeriod = calculateNetworkFramePeriod(worstLatencyMillis, currentFramePeriod);
+			if (newFramePeriod == currentFramePeriod) {
+				return;
+			}
+
+			if (networkFramePeriodChangeTimer.isStarted() == true) {
+				networkFramePeriodChangeTimer.stop();
+				networkFramePeriodChangeTimer.reset();
+			}
+			networkFramePeriodChangeTimer.start();
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] worstLatencyMillis = %f networkFramePeriod %d -> %d at frame %d\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, worstLatencyMillis, currentFramePeriod, newFramePeriod, currentFrameCount);
+
+			// Sent with this keyframe's commands so every peer applies it on the same frame
+			NetworkCommand networkCommand;
+			networkCommand.networkCommandType = nctNetworkFramePeriod;
+			networkCommand.unitId = newFramePeriod;
+			networkCommand.fromFactionIndex = gameSettings.getThisFactionIndex();
+			requestCommand(&networkCommand);
+		}
+
 		void ServerInterface::updateKeyframe(int frameCount) {
 			currentFrameCount = frameCount;
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] currentFrameCount = %d, requestedCommands.size() = %d\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, currentFrameCount, requestedCommands.size());
 
+			if (adaptiveNetworkFramePeriod == true && gameHasBeenInitiated == true) {
+				sendRoundTripPing();
+				checkForNetworkFramePeriodChange();
+			}
+
 			NetworkMessageCommandList networkMessageCommandList(frameCount);
 			for (int index = 0; index < GameConstants::maxPlayers; ++index) {
 				networkMessageCommandList.setNetworkPlayerFactionCRC(index, this->getNetworkPlayerFactionCRC(index));
@@ -1745,6 +1843,7 @@ namespace Glest {
 						discard = true;
 						NetworkMessagePing msg = NetworkMessagePing();
 						connectionSlot->receiveMessage(&msg);
+						connectionSlot->addRoundTripSample(msg);
 						lastPingInfo = msg;
 					}
 					break;
@@ -1756,6 +1855,13 @@ namespace Glest {
 						connectionSlot->receiveMessage(&msg);
 					}
 					break;
+					case nmtBroadCastSetupDelta:
+					{
+						discard = true;
+						NetworkMessageLaunchDelta msg = NetworkMessageLaunchDelta();
+						connectionSlot->receiveMessage(&msg);
+					}
+					break;
 					case nmtText:
 					{
 						discard = true;
@@ -2371,6 +2477,11 @@ namespace Glest {
 				this->gameSettings = *gameSettings;
 				//printf("#1 Data synch: lmap %u ltile: %d ltech: %u\n",gameSettings->getMapCRC(),gameSettings->getTilesetCRC(),gameSettings->getTechCRC());
 
+				MutexSafeWrapper safeMutexGameSetup(serverSynchAccessor, CODE_AT_LINE);
+				pendingGameSetupValid = false;
+				lastGameSetupValid = false;
+				safeMutexGameSetup.ReleaseLock();
+
 				NetworkMessageLaunch networkMessageLaunch(gameSettings, nmtLaunch);
 				broadcastMessage(&networkMessageLaunch);
 
@@ -2494,12 +2605,81 @@ namespace Glest {
 				gameSettingsUpdateCount++;
 			}
 
-			NetworkMessageLaunch networkMessageLaunch(gameSettingsBuffer, nmtBroadCastSetup);
-			broadcastMessage(&networkMessageLaunch);
+			if (gameHasBeenInitiated == true) {
+				NetworkMessageLaunch networkMessageLaunch(gameSettingsBuffer, nmtBroadCastSetup);
+				broadcastMessage(&networkMessageLaunch);
+			} else {
+				// In the lobby only the latest settings of a burst of changes go
+				// out, the rest is picked up by processPendingGameSetup
+				pendingGameSetup = *gameSettingsBuffer;
+				pendingGameSetupValid = true;
+				if (gameSetupBroadcastTimer.isStarted() == false ||
+					gameSetupBroadcastTimer.getMillis() >= GAME_SETUP_BROADCAST_COALESCE_MILLISECONDS) {
+					sendPendingGameSetup();
+				}
+			}
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s] Line: %d\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
 		}
 
+		// Caller must hold serverSynchAccessor
+		void ServerInterface::sendPendingGameSetup() {
+			NetworkMessageLaunch networkMessageLaunch(&pendingGameSetup, nmtBroadCastSetup);
+			for (int slotIndex = 0; exitServer == false && slotIndex < GameConstants::maxPlayers; ++slotIndex) {
+				MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[slotIndex], CODE_AT_LINE_X(slotIndex));
+				ConnectionSlot *connectionSlot = slots[slotIndex];
+				if (connectionSlot != NULL && connectionSlot->isConnected() == true) {
+					connectionSlot->sendGameSetup(networkMessageLaunch);
+				}
+			}
+
+			lastGameSetup = pendingGameSetup;
+			lastGameSetupValid = true;
+			pendingGameSetupValid = false;
+
+			if (gameSetupBroadcastTimer.isStarted() == true) {
+				gameSetupBroadcastTimer.stop();
+				gameSetupBroadcastTimer.reset();
+			}
+			gameSetupBroadcastTimer.start();
+		}
+
+		void ServerInterface::processPendingGameSetup() {
+			if (gameHasBeenInitiated == true) {
+				return;
+			}
+
+			MutexSafeWrapper safeMutex(serverSynchAccessor, CODE_AT_LINE);
+			if (pendingGameSetupValid == true &&
+				gameSetupBroadcastTimer.getMillis() >= GAME_SETUP_BROADCAST_COALESCE_MILLISECONDS) {
+				sendPendingGameSetup();
+			}
+
+			// Clients whose settings got out of step get a full snapshot
+			if (lastGameSetupValid == true) {
+				std::vector<int> resyncSlots;
+				for (int slotIndex = 0; exitServer == false && slotIndex < GameConstants::maxPlayers; ++slotIndex) {
+					MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[slotIndex], CODE_AT_LINE_X(slotIndex));
+					ConnectionSlot *connectionSlot = slots[slotIndex];
+					if (connectionSlot != NULL && connectionSlot->isConnected() == true &&
+						connectionSlot->getGameSetupResyncRequested() == true) {
+						resyncSlots.push_back(slotIndex);
+					}
+				}
+				if (resyncSlots.empty() == false) {
+					NetworkMessageLaunch networkMessageLaunch(&lastGameSetup, nmtBroadCastSetup);
+					for (unsigned int index = 0; index < resyncSlots.size(); ++index) {
+						int slotIndex = resyncSlots[index];
+						MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[slotIndex], CODE_AT_LINE_X(slotIndex));
+						ConnectionSlot *connectionSlot = slots[slotIndex];
+						if (connectionSlot != NULL && connectionSlot->isConnected() == true) {
+							connectionSlot->sendGameSetup(networkMessageLaunch, true);
+						}
+					}
+				}
+			}
+		}
+
 		void ServerInterface::broadcastMessage(NetworkMessage *networkMessage, int excludeSlot, int lockedSlotIndex) {
 			try {
 				if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
@@ -2714,6 +2894,12 @@ namespace Glest {
 
 			gameSettings = *serverGameSettings;
 
+			// Let clients missing content download only the files that differ
+			if (ftpServer != NULL) {
+				ftpServer->publishTilesetManifest(gameSettings.getTileset(), gameSettings.getTilesetCRC());
+				ftpServer->publishTechtreeManifest(gameSettings.getTech(), gameSettings.getTechCRC());
+			}
+
 			if (getAllowGameDataSynchCheck() == true) {
 				if (waitForClientAck == true && gameSettingsUpdateCount > 0) {
 					if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s] Waiting for client acks #1\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__);
@@ -63,6 +63,13 @@ namespace Glest {
 
 		const int MAX_EMPTY_NETWORK_COMMAND_LIST_BROADCAST_INTERVAL_MILLISECONDS = 4000;
 
+		const int ROUND_TRIP_PING_INTERVAL_MILLISECONDS = 1000;
+		const int NETWORK_FRAME_PERIOD_CHANGE_INTERVAL_MILLISECONDS = 10000;
+		const int NETWORK_FRAME_PERIOD_STEP = 5;
+		const int MIN_ROUND_TRIP_SAMPLES = 3;
+
+		const int GAME_SETUP_BROADCAST_COALESCE_MILLISECONDS = 150;
+
 		class Stats;
 		// =====================================================
 		//	class ServerInterface
@@ -145,6 +152,17 @@ namespace Glest {
 			Chrono lastBroadcastCommandsTimer;
 			ClientLagCallbackInterface *clientLagCallbackInterface;
 
+			bool adaptiveNetworkFramePeriod;
+			Chrono roundTripPingTimer;
+			Chrono networkFramePeriodChangeTimer;
+
+			// Lobby settings changes inside the coalesce window are sent once
+			GameSettings pendingGameSetup;
+			bool pendingGameSetupValid;
+			GameSettings lastGameSetup;
+			bool lastGameSetupValid;
+			Chrono gameSetupBroadcastTimer;
+
 		public:
 			ServerInterface(bool publishEnabled, ClientLagCallbackInterface *clientLagCallbackInterface);
 			virtual ~ServerInterface();
@@ -183,6 +201,9 @@ namespace Glest {
 			virtual void setKeyframe(int frameCount) {
 				currentFrameCount = frameCount;
 			}
+			virtual void setNetworkFramePeriod(int value);
+
+			static int calculateNetworkFramePeriod(double latencyMillis, int currentFramePeriod);
 
 			virtual void waitUntilReady(Checksum *checksum);
 			virtual void sendTextMessage(const string & text, int teamIndex, bool echoLocal, string targetLanguage);
@@ -324,6 +345,10 @@ namespace Glest {
 			void checkForAutoPauseForLaggingClient(int index,
 				ConnectionSlot* connectionSlot);
 			void checkForAutoResumeForLaggingClients();
+			void sendRoundTripPing();
+			void checkForNetworkFramePeriodChange();
+			void sendPendingGameSetup();
+			void processPendingGameSetup();
 
 		protected:
 			void signalClientsToRecieveData(std::map<PLATFORM_SOCKET, bool> & socketTriggeredList, std::map<int, ConnectionSlotEvent> & eventList, std::map<int, bool> & mapSlotSignalledList);
@@ -13,6 +13,7 @@
 #include "core_data.h"
 #include "config.h"
 #include "sound_interface.h"
+#include "sound_sample_cache.h"
 #include "factory_repository.h"
 #include "util.h"
 #include "leak_dumper.h"
@@ -40,6 +41,11 @@ namespace Glest {
 			Config &config = Config::getInstance();
 			runThreadSafe = config.getBool("ThreadedSoundStream", "true");
 
+			// Created here so the cache outlives this singleton
+			SoundSampleCache &sampleCache = SoundSampleCache::getInstance();
+			sampleCache.setLazyLoading(config.getBool("SoundLazyLoading", "true"));
+			sampleCache.setMemoryLimit((uint64) config.getInt("SoundSampleCacheMegabytes", "64") * 1024 * 1024);
+
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d] runThreadSafe = %d\n", __FILE__, __FUNCTION__, __LINE__, runThreadSafe);
 		}
 
@@ -70,6 +76,11 @@ namespace Glest {
 			}
 			safeMutex.ReleaseLock();
 
+			// Nothing is decoded without a sound player
+			if (soundPlayer != NULL) {
+				SoundSampleCache::getInstance().startDecodeThreads(config.getInt("SoundDecodeThreads", "1"));
+			}
+
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
 			return wasInitOk();
@@ -79,6 +90,7 @@ namespace Glest {
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
 			stopAllSounds();
+			SoundSampleCache::getInstance().stopDecodeThreads();
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
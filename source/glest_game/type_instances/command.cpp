@@ -17,6 +17,7 @@
 #include "unit_type.h"
 #include "faction.h"
 #include "world.h"
+#include "object_pool.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
@@ -27,6 +28,20 @@ namespace Glest {
 		// =====================================================
 		//      class Command
 		// =====================================================
+
+		// Orders are given and finished all the time in big battles
+		static ObjectPool<Command> commandPool("Command");
+
+#ifndef SL_LEAK_DUMP
+		void *Command::operator new(size_t size) {
+			return commandPool.allocate(size);
+		}
+
+		void Command::operator delete(void *ptr, size_t size) {
+			commandPool.release(ptr, size);
+		}
+#endif
+
 		Command::Command() :unitRef() {
 			this->commandType = NULL;
 			unitType = NULL;
@@ -66,6 +66,10 @@ namespace Glest {
 
 			virtual ~Command() {
 			}
+#ifndef SL_LEAK_DUMP
+			static void *operator new(size_t size);
+			static void operator delete(void *ptr, size_t size);
+#endif
 			//get
 			inline const CommandType *getCommandType() const {
 				return commandType;
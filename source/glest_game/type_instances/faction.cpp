@@ -2530,17 +2530,17 @@ namespace Glest {
 				iterMap1 != cachedCloseResourceTargetLookupList.end(); ++iterMap1) {
 				cache2Count++;
 			}
-			for (std::map < int, const Unit * >::iterator iterMap1 =
+			for (IdSlotMap < const Unit * >::iterator iterMap1 =
 				aliveUnitListCache.begin(); iterMap1 != aliveUnitListCache.end();
 				++iterMap1) {
 				cache3Count++;
 			}
-			for (std::map < int, const Unit * >::iterator iterMap1 =
+			for (IdSlotMap < const Unit * >::iterator iterMap1 =
 				mobileUnitListCache.begin();
 				iterMap1 != mobileUnitListCache.end(); ++iterMap1) {
 				cache4Count++;
 			}
-			for (std::map < int, const Unit * >::iterator iterMap1 =
+			for (IdSlotMap < const Unit * >::iterator iterMap1 =
 				beingBuiltUnitListCache.begin();
 				iterMap1 != beingBuiltUnitListCache.end(); ++iterMap1) {
 				cache5Count++;
@@ -2743,7 +2743,7 @@ namespace Glest {
 					mapTagReplacements);
 			}
 
-			for (std::map < int, int >::iterator iterMap = unitsMovingList.begin();
+			for (IdSlotMap < int >::iterator iterMap = unitsMovingList.begin();
 				iterMap != unitsMovingList.end(); ++iterMap) {
 				XmlNode *unitsMovingListNode =
 					factionNode->addChild("unitsMovingList");
@@ -2755,7 +2755,7 @@ namespace Glest {
 					mapTagReplacements);
 			}
 
-			for (std::map < int, int >::iterator iterMap =
+			for (IdSlotMap < int >::iterator iterMap =
 				unitsPathfindingList.begin();
 				iterMap != unitsPathfindingList.end(); ++iterMap) {
 				XmlNode *unitsPathfindingListNode =
@@ -27,6 +27,7 @@
 #   include "base_thread.h"
 #   include <set>
 #   include "faction_type.h"
+#   include "id_slot_map.h"
 #   include "leak_dumper.h"
 
 using std::map;
@@ -34,6 +35,7 @@ using std::vector;
 using std::set;
 
 using Shared::Graphics::Texture2D;
+using Shared::Util::IdSlotMap;
 using namespace Shared::PlatformCommon;
 
 namespace Glest {
@@ -134,7 +136,7 @@ namespace Glest {
 			typedef vector < Resource > Store;
 			typedef vector < Faction * >Allies;
 			typedef vector < Unit * >Units;
-			typedef map < int, Unit * >UnitMap;
+			typedef IdSlotMap < Unit * >UnitMap;
 
 		private:
 			UpgradeManager upgradeManager;
@@ -177,8 +179,8 @@ namespace Glest {
 			set < int >livingUnits;
 			set < Unit * >livingUnitsp;
 
-			std::map < int, int >unitsMovingList;
-			std::map < int, int >unitsPathfindingList;
+			IdSlotMap < int >unitsMovingList;
+			IdSlotMap < int >unitsPathfindingList;
 
 			std::set < const UnitType *>lockedUnits;
 
@@ -189,9 +191,9 @@ namespace Glest {
 
 			std::map < int, string > crcWorldFrameDetails;
 
-			std::map < int, const Unit *>aliveUnitListCache;
-			std::map < int, const Unit *>mobileUnitListCache;
-			std::map < int, const Unit *>beingBuiltUnitListCache;
+			IdSlotMap < const Unit *>aliveUnitListCache;
+			IdSlotMap < const Unit *>mobileUnitListCache;
+			IdSlotMap < const Unit *>beingBuiltUnitListCache;
 
 			std::map < std::string, bool > resourceTypeCostCache;
 
@@ -26,6 +26,7 @@
 #include "game.h"
 #include "socket.h"
 #include "sound_renderer.h"
+#include "object_pool.h"
 
 #include "leak_dumper.h"
 
@@ -50,19 +51,22 @@ namespace Glest {
 		std::map < UnitPathInterface *, int >Unit::mapMemoryList2;
 #endif
 
+		static ObjectPool<UnitPathBasic> unitPathPool("UnitPath");
+		static BufferPool<vector<Vec2i> > pathQueueBufferPool("UnitPath queue");
+
 		UnitPathBasic::UnitPathBasic() :UnitPathInterface() {
 #ifdef LEAK_CHECK_UNITS
 			UnitPathBasic::mapMemoryList[this] = true;
 #endif
 
 			this->blockCount = 0;
-			this->pathQueue.clear();
+			pathQueueBufferPool.acquire(this->pathQueue);
 			this->map = NULL;
 		}
 
 		UnitPathBasic::~UnitPathBasic() {
 			this->blockCount = 0;
-			this->pathQueue.clear();
+			pathQueueBufferPool.release(this->pathQueue);
 			this->map = NULL;
 
 #ifdef LEAK_CHECK_UNITS
@@ -70,6 +74,16 @@ namespace Glest {
 #endif
 		}
 
+#ifndef SL_LEAK_DUMP
+		void *UnitPathBasic::operator new(size_t size) {
+			return unitPathPool.allocate(size);
+		}
+
+		void UnitPathBasic::operator delete(void *ptr, size_t size) {
+			unitPathPool.release(ptr, size);
+		}
+#endif
+
 #ifdef LEAK_CHECK_UNITS
 		void UnitPathBasic::dumpMemoryList() {
 			printf("===== START report of Unfreed UnitPathBasic pointers =====\n");
@@ -682,7 +696,7 @@ namespace Glest {
 			random.init(id);
 			random.setDisableLastCallerTracking(isNetworkCRCEnabled() == false);
 			pathFindRefreshCellCount =
-				random.randRange(10, 20, intToStr(__LINE__));
+				random.randRange(10, 20, TOSTRING(__LINE__));
 
 			if (map->isInside(pos) == false
 				|| map->isInsideSurface(map->toSurfCoords(pos)) == false) {
@@ -747,7 +761,7 @@ namespace Glest {
 			if (type->hasSkillClass(scBeBuilt) == false) {
 				float rot = 0.f;
 				random.init(id);
-				rot += random.randRange(-5, 5, intToStr(__LINE__));
+				rot += random.randRange(-5, 5, TOSTRING(__LINE__));
 				rotation = rot;
 				lastRotation = rot;
 				targetRotation = rot;
@@ -5693,14 +5707,14 @@ namespace Glest {
 					MIN_FRAME_ELAPSED_RETRY = 4;
 				} else {
 					MIN_FRAME_ELAPSED_RETRY =
-						random.randRange(2, 6, intToStr(__LINE__));
+						random.randRange(2, 6, TOSTRING(__LINE__));
 				}
 			} else {
 				if (evalMode == true) {
 					MIN_FRAME_ELAPSED_RETRY = 7;
 				} else {
 					MIN_FRAME_ELAPSED_RETRY =
-						random.randRange(6, 8, intToStr(__LINE__));
+						random.randRange(6, 8, TOSTRING(__LINE__));
 				}
 			}
 			bool result(getFrameCount() - lastStuckFrame <=
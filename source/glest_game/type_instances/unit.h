@@ -192,6 +192,10 @@ namespace Glest {
 		public:
 			UnitPathBasic();
 			virtual ~UnitPathBasic();
+#ifndef SL_LEAK_DUMP
+			static void *operator new(size_t size);
+			static void operator delete(void *ptr, size_t size);
+#endif
 
 #   ifdef LEAK_CHECK_UNITS
 			static void dumpMemoryList();
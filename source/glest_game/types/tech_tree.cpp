@@ -18,6 +18,8 @@
 #include "faction_type.h"
 #include "logger.h"
 #include "xml_parser.h"
+#include "xml_tree_cache.h"
+#include "config.h"
 #include "platform_util.h"
 #include "game_util.h"
 #include "window.h"
@@ -236,6 +238,15 @@ namespace Glest {
 			treePath = currentPath;
 			name = lastDir(currentPath);
 
+			// Reuse the parsed XML files while the techtree is unchanged
+			auto_ptr < XmlTreeCache > xmlTreeCache;
+			if (Config::getInstance().getBool("XmlTreeCache", "true") == true) {
+				uint32 techCRC =
+					getFolderTreeContentsCheckSumRecursively(currentPath + "*", ".xml", NULL);
+				xmlTreeCache.reset(new XmlTreeCache(currentPath, techCRC,
+					XmlTreeCache::getCacheFileName(currentPath)));
+			}
+
 			Lang & lang = Lang::getInstance();
 			lang.loadTechTreeStrings(name, true);
 			languageUsedForCache = lang.getLanguage();
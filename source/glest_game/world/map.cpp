@@ -345,6 +345,7 @@ namespace Glest {
 
 		const int Map::cellScale = 2;
 		const int Map::mapScale = 2;
+		const int Map::surfaceChunkSize = 16;
 
 		Map::Map() {
 			cells = NULL;
@@ -361,12 +362,18 @@ namespace Glest {
 			surfaceW = 0;
 			surfaceH = 0;
 			surfaceSize = (surfaceW * surfaceH);
+			surfaceChunkW = 0;
+			surfaceChunkH = 0;
 			maxPlayers = 0;
 			maxMapHeight = 0;
+			terrainInitialized = false;
+			logUnload = true;
 		}
 
 		Map::~Map() {
-			Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameUnLoadingMapCells", ""), true);
+			if (logUnload == true) {
+				Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameUnLoadingMapCells", ""), true);
+			}
 
 			delete[] cells;
 			cells = NULL;
@@ -406,6 +413,14 @@ namespace Glest {
 		}
 
 		Checksum Map::load(const string &path, TechTree *techTree, Tileset *tileset) {
+			Checksum mapChecksum = loadTerrain(path);
+			loadObjects(techTree, tileset);
+			return mapChecksum;
+		}
+
+		// Reads everything of the map file that doesn't need the tileset or
+		// techtree, the objects are kept as numbers for loadObjects
+		Checksum Map::loadTerrain(const string &path) {
 			Checksum mapChecksum;
 			try {
 #ifdef WIN32
@@ -495,6 +510,10 @@ namespace Glest {
 					cells = new Cell[getCellArraySize()];
 					surfaceCells = new SurfaceCell[getSurfaceCellArraySize()];
 
+					surfaceChunkW = (surfaceW - 1 + surfaceChunkSize - 1) / surfaceChunkSize;
+					surfaceChunkH = (surfaceH - 1 + surfaceChunkSize - 1) / surfaceChunkSize;
+					surfaceChunkVersions.assign(surfaceChunkW * surfaceChunkH, 0);
+
 					//read heightmap
 					for (int j = 0; j < surfaceH; ++j) {
 						for (int i = 0; i < surfaceW; ++i) {
@@ -529,9 +548,9 @@ namespace Glest {
 					}
 
 					//read objects and resources
-					for (int j = 0; j < h; j += cellScale) {
-						for (int i = 0; i < w; i += cellScale) {
-
+					loadedObjects.resize(getSurfaceCellArraySize());
+					for (int j = 0; j < surfaceH; ++j) {
+						for (int i = 0; i < surfaceW; ++i) {
 							int8 objNumber = 0;
 							readBytes = fread(&objNumber, sizeof(int8), 1, f);
 							if (readBytes != 1) {
@@ -539,26 +558,7 @@ namespace Glest {
 								snprintf(szBuf, 8096, "fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.", readBytes, __LINE__);
 								throw megaglest_runtime_error(szBuf);
 							}
-							objNumber = ::Shared::PlatformByteOrder::fromCommonEndian(objNumber);
-
-							SurfaceCell *sc = getSurfaceCell(toSurfCoords(Vec2i(i, j)));
-							if (objNumber <= 0) {
-								sc->setObject(NULL);
-							} else if (objNumber <= Tileset::objCount) {
-								Object *o = new Object(tileset->getObjectType(objNumber - 1), sc->getVertex(), Vec2i(i, j));
-								sc->setObject(o);
-								for (int k = 0; k < techTree->getResourceTypeCount(); ++k) {
-									const ResourceType *rt = techTree->getResourceType(k);
-									if (rt->getClass() == rcTileset && rt->getTilesetObject() == objNumber) {
-										o->setResource(rt, Vec2i(i, j));
-									}
-								}
-							} else {
-								const ResourceType *rt = techTree->getTechResourceType(objNumber - Tileset::objCount);
-								Object *o = new Object(NULL, sc->getVertex(), Vec2i(i, j));
-								o->setResource(rt, Vec2i(i, j));
-								sc->setObject(o);
-							}
+							loadedObjects[j * surfaceW + i] = ::Shared::PlatformByteOrder::fromCommonEndian(objNumber);
 						}
 					}
 					if (f) fclose(f);
@@ -573,14 +573,96 @@ namespace Glest {
 			return mapChecksum;
 		}
 
+		void Map::loadObjects(TechTree *techTree, Tileset *tileset) {
+			if ((int) loadedObjects.size() != getSurfaceCellArraySize()) {
+				throw megaglest_runtime_error("Error loading map: " + mapFile + "\nThe terrain was not loaded");
+			}
+			try {
+				for (int j = 0; j < surfaceH; ++j) {
+					for (int i = 0; i < surfaceW; ++i) {
+						int8 objNumber = loadedObjects[j * surfaceW + i];
+						Vec2i pos = Vec2i(i, j) * cellScale;
+
+						SurfaceCell *sc = getSurfaceCell(i, j);
+						if (objNumber <= 0) {
+							sc->setObject(NULL);
+						} else if (objNumber <= Tileset::objCount) {
+							Object *o = new Object(tileset->getObjectType(objNumber - 1), sc->getVertex(), pos);
+							sc->setObject(o);
+							for (int k = 0; k < techTree->getResourceTypeCount(); ++k) {
+								const ResourceType *rt = techTree->getResourceType(k);
+								if (rt->getClass() == rcTileset && rt->getTilesetObject() == objNumber) {
+									o->setResource(rt, pos);
+								}
+							}
+						} else {
+							const ResourceType *rt = techTree->getTechResourceType(objNumber - Tileset::objCount);
+							Object *o = new Object(NULL, sc->getVertex(), pos);
+							o->setResource(rt, pos);
+							sc->setObject(o);
+						}
+					}
+				}
+			} catch (const exception &e) {
+				SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] Error [%s]\n", __FILE__, __FUNCTION__, __LINE__, e.what());
+				throw megaglest_runtime_error("Error loading map: " + mapFile + "\n" + e.what());
+			}
+			vector<int8>().swap(loadedObjects);
+		}
+
+		// Takes over the cells of a map that went through loadTerrain and
+		// maybe initTerrain already, this map must not be loaded yet
+		Checksum Map::adoptTerrain(Map &preparedMap) {
+			if (cells != NULL || surfaceCells != NULL) {
+				throw megaglest_runtime_error("Map::adoptTerrain called on a loaded map");
+			}
+			std::swap(title, preparedMap.title);
+			std::swap(waterLevel, preparedMap.waterLevel);
+			std::swap(heightFactor, preparedMap.heightFactor);
+			std::swap(cliffLevel, preparedMap.cliffLevel);
+			std::swap(cameraHeight, preparedMap.cameraHeight);
+			std::swap(w, preparedMap.w);
+			std::swap(h, preparedMap.h);
+			std::swap(surfaceW, preparedMap.surfaceW);
+			std::swap(surfaceH, preparedMap.surfaceH);
+			std::swap(surfaceSize, preparedMap.surfaceSize);
+			std::swap(hardMaxPlayers, preparedMap.hardMaxPlayers);
+			std::swap(maxPlayers, preparedMap.maxPlayers);
+			std::swap(cells, preparedMap.cells);
+			std::swap(surfaceCells, preparedMap.surfaceCells);
+			std::swap(startLocations, preparedMap.startLocations);
+			std::swap(maxMapHeight, preparedMap.maxMapHeight);
+			std::swap(mapFile, preparedMap.mapFile);
+			std::swap(surfaceChunkW, preparedMap.surfaceChunkW);
+			std::swap(surfaceChunkH, preparedMap.surfaceChunkH);
+			surfaceChunkVersions.swap(preparedMap.surfaceChunkVersions);
+			std::swap(terrainInitialized, preparedMap.terrainInitialized);
+			loadedObjects.swap(preparedMap.loadedObjects);
+			smoothedHeights.swap(preparedMap.smoothedHeights);
+			cliffCells.swap(preparedMap.cliffCells);
+
+			Checksum mapChecksum;
+			mapChecksum.addFile(mapFile);
+			checksumValue.addFile(mapFile);
+			return mapChecksum;
+		}
+
 		void Map::init(Tileset *tileset) {
 			Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameUnLoadingMap", ""), true);
+			if (terrainInitialized == false) {
+				initTerrain();
+			}
+			initObjects(tileset);
+		}
+
+		void Map::initTerrain() {
 			maxMapHeight = 0.0f;
-			smoothSurface(tileset);
+			smoothSurface();
 			computeNormals();
 			computeInterpolatedHeights();
 			computeNearSubmerged();
 			computeCellColors();
+			terrainInitialized = true;
 		}
 
 
@@ -1619,6 +1701,28 @@ namespace Glest {
 					}
 				}
 			}
+
+			Vec2i fromSurfPos = toSurfCoords(unit->getPosNotThreadSafe() + Vec2i(-1, -1));
+			Vec2i toSurfPos = toSurfCoords(unit->getPosNotThreadSafe() + Vec2i(unit->getType()->getSize()));
+			markSurfaceChanged(fromSurfPos.x, fromSurfPos.y, toSurfPos.x, toSurfPos.y);
+		}
+
+		// A surface cell is a corner of the quads left and above it and its
+		// height also changes the normals of its neighbours, so chunks
+		// touching the two cells around the changed area are bumped too
+		void Map::markSurfaceChanged(int fromSurfX, int fromSurfY, int toSurfX, int toSurfY) {
+			if (surfaceChunkVersions.empty() == true) {
+				return;
+			}
+			int fromChunkX = max(fromSurfX - 2, 0) / surfaceChunkSize;
+			int fromChunkY = max(fromSurfY - 2, 0) / surfaceChunkSize;
+			int toChunkX = min(max(toSurfX + 1, 0) / surfaceChunkSize, surfaceChunkW - 1);
+			int toChunkY = min(max(toSurfY + 1, 0) / surfaceChunkSize, surfaceChunkH - 1);
+			for (int chunkY = fromChunkY; chunkY <= toChunkY; ++chunkY) {
+				for (int chunkX = fromChunkX; chunkX <= toChunkX; ++chunkX) {
+					surfaceChunkVersions[chunkY * surfaceChunkW + chunkX]++;
+				}
+			}
 		}
 
 		//compute normals
@@ -1670,13 +1774,15 @@ namespace Glest {
 			}
 		}
 
-		void Map::smoothSurface(Tileset *tileset) {
+		void Map::smoothSurface() {
 			float *oldHeights = new float[getSurfaceCellArraySize()];
 			//int arraySize=getSurfaceCellArraySize();
 
 			for (int i = 0; i < getSurfaceCellArraySize(); ++i) {
 				oldHeights[i] = surfaceCells[i].getHeight();
 			}
+			smoothedHeights.assign(getSurfaceCellArraySize(), 0.f);
+			cliffCells.assign(getSurfaceCellArraySize(), false);
 
 			for (int i = 1; i < surfaceW - 1; ++i) {
 				for (int j = 1; j < surfaceH - 1; ++j) {
@@ -1697,26 +1803,11 @@ namespace Glest {
 								// we have something which should not be smoothed!
 								// This is a cliff and must be textured -> set cliff texture
 								getSurfaceCell(i, j)->setSurfaceType(5);
-								//set invisible blocking object and replace resource objects
-								//and non blocking objects with invisible blocker too
-								Object *formerObject =
-									getSurfaceCell(i, j)->getObject();
-								if (formerObject != NULL) {
-									if (formerObject->getWalkable()
-										|| formerObject->getResource() != NULL) {
-										delete formerObject;
-										formerObject = NULL;
-									}
-								}
-								if (formerObject == NULL) {
-									Object *o = new Object(tileset->getObjectType(9),
-										getSurfaceCell(i, j)->getVertex(),
-										Vec2i(i, j));
-									getSurfaceCell(i, j)->setObject(o);
-								}
-							}
+								// initObjects puts an invisible blocker on it
+								cliffCells[j * surfaceW + i] = true;
 							}
 						}
+					}
 
 					height /= numUsedToSmooth;
 					if (maxMapHeight < height) {
@@ -1724,14 +1815,45 @@ namespace Glest {
 					}
 
 					getSurfaceCell(i, j)->setHeight(height);
-					Object *object = getSurfaceCell(i, j)->getObject();
-					if (object != NULL) {
-						object->setHeight(height);
+					smoothedHeights[j * surfaceW + i] = height;
+				}
+			}
+			delete[] oldHeights;
+		}
+
+		void Map::initObjects(Tileset *tileset) {
+			if ((int) smoothedHeights.size() != getSurfaceCellArraySize()) {
+				return;
+			}
+			for (int i = 1; i < surfaceW - 1; ++i) {
+				for (int j = 1; j < surfaceH - 1; ++j) {
+					SurfaceCell *sc = getSurfaceCell(i, j);
+					if (cliffCells[j * surfaceW + i] == true) {
+						//set invisible blocking object and replace resource objects
+						//and non blocking objects with invisible blocker too
+						Object *formerObject = sc->getObject();
+						if (formerObject != NULL) {
+							if (formerObject->getWalkable()
+								|| formerObject->getResource() != NULL) {
+								delete formerObject;
+								formerObject = NULL;
+							}
+						}
+						if (formerObject == NULL) {
+							Object *o = new Object(tileset->getObjectType(9), sc->getVertex(), Vec2i(i, j));
+							sc->setObject(o);
+						}
 					}
+
+					Object *object = sc->getObject();
+					if (object != NULL) {
+						object->setHeight(smoothedHeights[j * surfaceW + i]);
 					}
 				}
-			delete[] oldHeights;
 			}
+			vector<float>().swap(smoothedHeights);
+			vector<bool>().swap(cliffCells);
+		}
 
 		void Map::computeNearSubmerged() {
 
@@ -1962,6 +2084,7 @@ namespace Glest {
 
 			computeNormals();
 			computeInterpolatedHeights();
+			markSurfaceChanged(0, 0, surfaceW - 1, surfaceH - 1);
 		}
 
 		// =====================================================
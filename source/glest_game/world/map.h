@@ -290,6 +290,7 @@ namespace Glest {
 		public:
 			static const int cellScale;	//number of cells per surfaceCell
 			static const int mapScale;	//horizontal scale of surface
+			static const int surfaceChunkSize;	//surface cells per side of a terrain chunk
 
 		private:
 			string title;
@@ -312,6 +313,21 @@ namespace Glest {
 			float maxMapHeight;
 			string mapFile;
 
+			// Bumped when heights or textures of a chunk's cells change, lets
+			// the renderer rebuild only the terrain geometry that changed
+			int surfaceChunkW;
+			int surfaceChunkH;
+			vector<uint32> surfaceChunkVersions;
+
+			// The terrain is loaded and smoothed without the tileset and
+			// techtree, so it can be prepared ahead on another thread. These
+			// hold what the objects still need once the types are there.
+			bool terrainInitialized;
+			bool logUnload;
+			vector<int8> loadedObjects;
+			vector<float> smoothedHeights;
+			vector<bool> cliffCells;
+
 		private:
 			Map(Map&);
 			void operator=(Map&);
@@ -327,6 +343,15 @@ namespace Glest {
 			void init(Tileset *tileset);
 			Checksum load(const string &path, TechTree *techTree, Tileset *tileset);
 
+			Checksum loadTerrain(const string &path);
+			void initTerrain();
+			Checksum adoptTerrain(Map &preparedMap);
+			// Maps prepared ahead are freed silently, away from the loading screen
+			void setLogUnload(bool value) {
+				logUnload = value;
+			}
+			void loadObjects(TechTree *techTree, Tileset *tileset);
+
 			//get
 			inline Cell *getCell(int x, int y, bool errorOnInvalid = true) const {
 				int arrayIndex = y * w + x;
@@ -468,6 +493,17 @@ namespace Glest {
 			void computeNormals();
 			void computeInterpolatedHeights();
 
+			inline int getSurfaceChunkW() const {
+				return surfaceChunkW;
+			}
+			inline int getSurfaceChunkH() const {
+				return surfaceChunkH;
+			}
+			inline uint32 getSurfaceChunkVersion(int chunkX, int chunkY) const {
+				return surfaceChunkVersions[chunkY * surfaceChunkW + chunkX];
+			}
+			void markSurfaceChanged(int fromSurfX, int fromSurfY, int toSurfX, int toSurfY);
+
 			//static
 			inline static Vec2i toSurfCoords(const Vec2i &unitPos) {
 				return unitPos / cellScale;
@@ -720,7 +756,8 @@ namespace Glest {
 
 		private:
 			//compute
-			void smoothSurface(Tileset *tileset);
+			void smoothSurface();
+			void initObjects(Tileset *tileset);
 			void computeNearSubmerged();
 			void computeCellColors();
 			void putUnitCellsPrivate(Unit *unit, const Vec2i &pos, const UnitType *ut, bool isMorph, bool threaded);
@@ -0,0 +1,230 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "map_preloader.h"
+
+#include <cstdio>
+#include "map.h"
+#include "config.h"
+#include "checksum.h"
+#include "conversion.h"
+#include "platform_util.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Shared::Platform;
+
+namespace Glest {
+	namespace Game {
+
+		// =====================================================
+		// 	class MapPreloadThread
+		// =====================================================
+
+		MapPreloadThread::MapPreloadThread(MapPreloader *preloader) : BaseThread() {
+			this->preloader = preloader;
+			setUniqueID("MapPreloadThread");
+		}
+
+		void MapPreloadThread::execute() {
+			RunningStatusSafeWrapper runningStatus(this);
+
+			string path;
+			for (; getQuitStatus() == false && preloader->takeRequest(path) == true;) {
+				Map *map = NULL;
+				uint32 fileCRC = 0;
+				try {
+					Chrono chrono;
+					chrono.start();
+
+					fileCRC = MapPreloader::getFileCRC(path);
+					map = new Map();
+					map->setLogUnload(false);
+					map->loadTerrain(path);
+					map->initTerrain();
+
+					if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d] prepared map [%s] in " MG_I64_SPECIFIER " msecs\n", __FILE__, __FUNCTION__, __LINE__, path.c_str(), chrono.getMillis());
+				} catch (const exception &ex) {
+					delete map;
+					map = NULL;
+					// The game loads the map itself and reports the error then
+					SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] Error preloading map [%s]: [%s]\n", __FILE__, __FUNCTION__, __LINE__, path.c_str(), ex.what());
+				}
+				preloader->storePreparedMap(path, fileCRC, map);
+			}
+		}
+
+		// =====================================================
+		// 	class MapPreloader
+		// =====================================================
+
+		MapPreloader::MapPreloader() {
+			mutex = new Mutex(CODE_AT_LINE);
+			thread = NULL;
+			threadActive = false;
+			preparedFileCRC = 0;
+			preparedMap = NULL;
+		}
+
+		MapPreloader::~MapPreloader() {
+			end();
+			delete mutex;
+			mutex = NULL;
+		}
+
+		MapPreloader &MapPreloader::getInstance() {
+			static MapPreloader mapPreloader;
+			return mapPreloader;
+		}
+
+		uint32 MapPreloader::getFileCRC(const string &path) {
+#ifdef WIN32
+			FILE *f = _wfopen(utf8_decode(path).c_str(), L"rb");
+#else
+			FILE *f = fopen(path.c_str(), "rb");
+#endif
+			if (f == NULL) {
+				throw megaglest_runtime_error("Can't open file: " + path);
+			}
+			Checksum checksum;
+			char buffer[16384];
+			for (size_t readBytes = fread(buffer, 1, sizeof(buffer), f); readBytes > 0;
+				readBytes = fread(buffer, 1, sizeof(buffer), f)) {
+				checksum.addBytes(buffer, readBytes);
+			}
+			fclose(f);
+			return checksum.getSum();
+		}
+
+		bool MapPreloader::takeRequest(string &path) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			if (requestedPath.empty() == true || requestedPath == preparedPath) {
+				threadActive = false;
+				preparingPath = "";
+				return false;
+			}
+			path = requestedPath;
+			preparingPath = requestedPath;
+			return true;
+		}
+
+		void MapPreloader::storePreparedMap(const string &path, uint32 fileCRC, Map *map) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			preparingPath = "";
+			delete preparedMap;
+			// A failed map is remembered too, so it isn't tried again
+			preparedPath = path;
+			preparedFileCRC = fileCRC;
+			preparedMap = map;
+			if (path != requestedPath) {
+				delete preparedMap;
+				preparedMap = NULL;
+			}
+		}
+
+		// Called by the lobbies whenever they show a map, repeated calls with
+		// the same map cost nothing
+		void MapPreloader::request(const string &mapPath) {
+			static bool enabled = Config::getInstance().getBool("PreloadLobbyMap", "true");
+			if (enabled == false) {
+				return;
+			}
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			if (mapPath == requestedPath) {
+				return;
+			}
+			requestedPath = mapPath;
+			if (mapPath.empty() == true || threadActive == true) {
+				return;
+			}
+
+			// The last thread found nothing more to do and is finishing
+			MapPreloadThread *finishedThread = thread;
+			thread = NULL;
+			threadActive = true;
+			safeMutex.ReleaseLock();
+
+			if (finishedThread != NULL && BaseThread::shutdownAndWait(finishedThread) == true) {
+				delete finishedThread;
+			}
+			MapPreloadThread *newThread = new MapPreloadThread(this);
+
+			safeMutex.Lock();
+			thread = newThread;
+			safeMutex.ReleaseLock();
+			newThread->start();
+		}
+
+		// Returns the prepared map for mapPath if the file is still the one
+		// that was loaded, waiting for it if it is being prepared. The caller
+		// owns the map, everything else prepared is dropped.
+		Map *MapPreloader::takePreparedMap(const string &mapPath) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			for (; preparingPath == mapPath && mapPath.empty() == false;) {
+				safeMutex.ReleaseLock();
+				sleep(1);
+				safeMutex.Lock();
+			}
+
+			Map *map = NULL;
+			uint32 fileCRC = 0;
+			if (preparedPath == mapPath) {
+				map = preparedMap;
+				fileCRC = preparedFileCRC;
+				preparedMap = NULL;
+			} else {
+				delete preparedMap;
+				preparedMap = NULL;
+			}
+			requestedPath = "";
+			preparedPath = "";
+			safeMutex.ReleaseLock();
+
+			if (map != NULL) {
+				try {
+					if (getFileCRC(mapPath) != fileCRC) {
+						if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d] map [%s] changed since it was preloaded\n", __FILE__, __FUNCTION__, __LINE__, mapPath.c_str());
+						delete map;
+						map = NULL;
+					}
+				} catch (const exception &) {
+					delete map;
+					map = NULL;
+				}
+			}
+			return map;
+		}
+
+		void MapPreloader::end() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			requestedPath = "";
+			MapPreloadThread *finishedThread = thread;
+			thread = NULL;
+			safeMutex.ReleaseLock();
+
+			if (finishedThread != NULL) {
+				finishedThread->signalQuit();
+				if (BaseThread::shutdownAndWait(finishedThread) == true) {
+					delete finishedThread;
+				}
+			}
+
+			safeMutex.Lock();
+			delete preparedMap;
+			preparedMap = NULL;
+			preparedPath = "";
+			threadActive = false;
+			safeMutex.ReleaseLock();
+		}
+
+	}
+}//end namespace
@@ -0,0 +1,92 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_MAPPRELOADER_H_
+#define _GLEST_GAME_MAPPRELOADER_H_
+
+#ifdef WIN32
+#include <winsock2.h>
+#include <winsock.h>
+#endif
+
+#include <string>
+#include "base_thread.h"
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using std::string;
+using Shared::PlatformCommon::BaseThread;
+using Shared::Platform::Mutex;
+using Shared::Platform::uint32;
+
+namespace Glest {
+	namespace Game {
+
+		class Map;
+		class MapPreloader;
+
+		// =====================================================
+		// 	class MapPreloadThread
+		// =====================================================
+
+		class MapPreloadThread : public BaseThread {
+		private:
+			MapPreloader *preloader;
+
+		public:
+			explicit MapPreloadThread(MapPreloader *preloader);
+			virtual void execute();
+		};
+
+		// =====================================================
+		// 	class MapPreloader
+		//
+		//	Loads and smooths the terrain of the map selected in
+		//	the lobby on a background thread, so the game can
+		//	take it over at launch instead of doing it again.
+		// =====================================================
+
+		class MapPreloader {
+			friend class MapPreloadThread;
+
+		private:
+			Mutex *mutex;
+			MapPreloadThread *thread;
+			bool threadActive;
+
+			string requestedPath;
+			string preparingPath;
+			string preparedPath;
+			uint32 preparedFileCRC;
+			Map *preparedMap;
+
+			MapPreloader();
+			MapPreloader(const MapPreloader &);
+			void operator =(const MapPreloader &);
+
+			bool takeRequest(string &path);
+			void storePreparedMap(const string &path, uint32 fileCRC, Map *map);
+
+			static uint32 getFileCRC(const string &path);
+
+		public:
+			~MapPreloader();
+			static MapPreloader &getInstance();
+
+			void request(const string &mapPath);
+			Map *takePreparedMap(const string &mapPath);
+			void end();
+		};
+
+	}
+}//end namespace
+
+#endif
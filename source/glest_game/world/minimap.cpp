@@ -12,6 +12,8 @@
 #include "minimap.h"
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 
 #include "world.h"
 #include "vec.h"
@@ -32,6 +34,46 @@ namespace Glest {
 
 		const float Minimap::exploredAlpha = 0.5f;
 
+		// The fog of war planes hold one alpha byte per cell. The kernels
+		// below work on whole rows with plain loops the compiler vectorizes.
+
+		static void fowKeepMaxRow(const uint8 *previous, uint8 *current, int count) {
+			for (int i = 0; i < count; ++i) {
+				current[i] = std::max(previous[i], current[i]);
+			}
+		}
+
+		static void fowKeepExploredRow(const uint8 *previous, uint8 *current, int count, uint8 explored) {
+			for (int i = 0; i < count; ++i) {
+				uint8 faded = std::min(current[i], explored);
+				current[i] = (previous[i] > current[i] ? previous[i] : faded);
+			}
+		}
+
+		// blend runs from 0 (from) to 256 (to)
+		static void fowBlendRow(const uint8 *from, const uint8 *to, uint8 *target, int count, int blend) {
+			for (int i = 0; i < count; ++i) {
+				int value = from[i] + (((to[i] - from[i]) * blend) >> 8);
+				target[i] = (target[i] != to[i] ? static_cast<uint8>(value) : target[i]);
+			}
+		}
+
+		// Finds the first and last columns where the rows differ
+		static bool fowRowDiff(const uint8 *row1, const uint8 *row2, int count, int &first, int &last) {
+			if (memcmp(row1, row2, count) == 0) {
+				return false;
+			}
+			first = 0;
+			while (row1[first] == row2[first]) {
+				++first;
+			}
+			last = count - 1;
+			while (row1[last] == row2[last]) {
+				--last;
+			}
+			return true;
+		}
+
 		Minimap::Minimap() {
 			fowPixmap0 = NULL;
 			fowPixmap1 = NULL;
@@ -43,6 +85,9 @@ namespace Glest {
 			gameSettings = NULL;
 			tex = NULL;
 			fowTex = NULL;
+			fowBlendRect = Rect2i(0, 0, 0, 0);
+			fowUploadRowStart = 0;
+			fowUploadRowEnd = 0;
 		}
 
 		void Minimap::init(int w, int h, const World *world, bool fogOfWar) {
@@ -100,7 +145,12 @@ namespace Glest {
 
 				fowTex->getPixmap()->init(potW, potH, 1);
 				fowTex->getPixmap()->setPixels(&f, 1);
+
+				// The GL texture starts out without pixels
+				fowUploadRowStart = 0;
+				fowUploadRowEnd = potH;
 			}
+			setFowBlendAll();
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
@@ -141,6 +191,7 @@ namespace Glest {
 
 				if (fowPixmap1->getPixelf(sPos.x, sPos.y) < alpha) {
 					fowPixmap1->setPixel(sPos.x, sPos.y, alpha);
+					addFowBlendRect(sPos.x, sPos.y, sPos.x + 1, sPos.y + 1);
 				}
 
 				if (fowPixmap1Copy != NULL && isIncrementalUpdate == true) {
@@ -166,6 +217,7 @@ namespace Glest {
 			if (fowPixmap1Copy != NULL && fowPixmap1Copy_default != NULL) {
 				fowPixmap1Copy->copy(fowPixmap1Copy_default);
 			}
+			setFowBlendAll();
 		}
 
 		void Minimap::setFogOfWar(bool value) {
@@ -188,6 +240,7 @@ namespace Glest {
 			if (fowPixmap1 != NULL && fowPixmap1Copy != NULL) {
 				fowPixmap1->copy(fowPixmap1Copy);
 			}
+			setFowBlendAll();
 		}
 
 		void Minimap::resetFowTex() {
@@ -199,40 +252,38 @@ namespace Glest {
 				// Could turn off ONLY fog of war by setting below to false
 				bool overridefogOfWarValue = fogOfWar;
 
-				for (int indexPixelWidth = 0;
-					indexPixelWidth < fowTex->getPixmap()->getW();
-					++indexPixelWidth) {
-					for (int indexPixelHeight = 0;
-						indexPixelHeight < fowTex->getPixmap()->getH();
-						++indexPixelHeight) {
-						if ((fogOfWar == false && overridefogOfWarValue == false)) {
-							//(gameSettings->getFlagTypes1() & ft1_show_map_resources) != ft1_show_map_resources) {
-							//printf("Line: %d\n",__LINE__);
-
-							float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-							float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-							if (p0 > p1) {
-								fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p0);
-							} else {
-								fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p1);
-							}
-						} else if ((fogOfWar && overridefogOfWarValue) ||
-							(gameSettings->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources) {
-							//printf("Line: %d\n",__LINE__);
-
-							float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-							float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
+				int w = fowPixmap1->getW();
+				int h = fowPixmap1->getH();
+				const uint8 exploredByte = static_cast<uint8>(exploredAlpha * 255.f);
+				const uint8 *previousPixels = fowPixmap0->getPixels();
+				uint8 *currentPixels = fowPixmap1->getPixels();
+				const uint8 *texPixels = fowTex->getPixmap()->getPixels();
+
+				fowBlendRect = Rect2i(0, 0, 0, 0);
+				for (int y = 0; y < h; ++y) {
+					const uint8 *previousRow = previousPixels + y * w;
+					uint8 *currentRow = currentPixels + y * w;
+
+					if ((fogOfWar == false && overridefogOfWarValue == false)) {
+						//(gameSettings->getFlagTypes1() & ft1_show_map_resources) != ft1_show_map_resources) {
+						fowKeepMaxRow(previousRow, currentRow, w);
+					} else if ((fogOfWar && overridefogOfWarValue) ||
+						(gameSettings->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources) {
+						fowKeepExploredRow(previousRow, currentRow, w, exploredByte);
+					} else {
+						memset(currentRow, 255, w);
+					}
 
-							if (p1 > exploredAlpha) {
-								fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, exploredAlpha);
-							}
-							if (p0 > p1) {
-								fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p0);
-							}
-						} else {
-							//printf("Line: %d\n",__LINE__);
-							fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, 1.f);
-						}
+					// Blending is needed where the texture does not show the
+					// new plane yet, either from the old plane or a blend
+					// that did not reach the end
+					int first = 0;
+					int last = 0;
+					if (fowRowDiff(previousRow, currentRow, w, first, last) == true) {
+						addFowBlendRect(first, y, last + 1, y + 1);
+					}
+					if (fowRowDiff(texPixels + y * w, currentRow, w, first, last) == true) {
+						addFowBlendRect(first, y, last + 1, y + 1);
 					}
 				}
 			}
@@ -240,23 +291,65 @@ namespace Glest {
 
 		void Minimap::updateFowTex(float t) {
 			if (fowTex && fowPixmap0 && fowPixmap1) {
-				for (int indexPixelWidth = 0;
-					indexPixelWidth < fowPixmap0->getW();
-					++indexPixelWidth) {
-					for (int indexPixelHeight = 0;
-						indexPixelHeight < fowPixmap0->getH();
-						++indexPixelHeight) {
-						float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-						float p2 = fowTex->getPixmap()->getPixelf(indexPixelWidth, indexPixelHeight);
-						if (p1 != p2) {
-							float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-							fowTex->getPixmap()->setPixel(indexPixelWidth, indexPixelHeight, p0 + (t*(p1 - p0)));
-						}
-					}
+				if (fowBlendRect.p[1].x <= fowBlendRect.p[0].x || fowBlendRect.p[1].y <= fowBlendRect.p[0].y) {
+					return;
+				}
+
+				int w = fowPixmap1->getW();
+				int blend = static_cast<int>(t * 256.f);
+				const uint8 *previousPixels = fowPixmap0->getPixels();
+				const uint8 *currentPixels = fowPixmap1->getPixels();
+				uint8 *texPixels = fowTex->getPixmap()->getPixels();
+
+				int x0 = fowBlendRect.p[0].x;
+				int count = fowBlendRect.p[1].x - x0;
+				for (int y = fowBlendRect.p[0].y; y < fowBlendRect.p[1].y; ++y) {
+					int offset = y * w + x0;
+					fowBlendRow(previousPixels + offset, currentPixels + offset, texPixels + offset, count, blend);
+				}
+
+				if (fowUploadRowEnd <= fowUploadRowStart) {
+					fowUploadRowStart = fowBlendRect.p[0].y;
+					fowUploadRowEnd = fowBlendRect.p[1].y;
+				} else {
+					fowUploadRowStart = std::min(fowUploadRowStart, fowBlendRect.p[0].y);
+					fowUploadRowEnd = std::max(fowUploadRowEnd, fowBlendRect.p[1].y);
+				}
+				if (blend >= 256) {
+					// The texture shows the current plane now
+					fowBlendRect = Rect2i(0, 0, 0, 0);
 				}
 			}
 		}
 
+		bool Minimap::takeFowTexUploadRows(int &rowStart, int &rowCount) const {
+			if (fowUploadRowEnd <= fowUploadRowStart) {
+				return false;
+			}
+			rowStart = fowUploadRowStart;
+			rowCount = fowUploadRowEnd - fowUploadRowStart;
+			fowUploadRowStart = 0;
+			fowUploadRowEnd = 0;
+			return true;
+		}
+
+		void Minimap::addFowBlendRect(int x0, int y0, int x1, int y1) {
+			if (fowBlendRect.p[1].x <= fowBlendRect.p[0].x || fowBlendRect.p[1].y <= fowBlendRect.p[0].y) {
+				fowBlendRect = Rect2i(x0, y0, x1, y1);
+				return;
+			}
+			fowBlendRect.p[0].x = std::min(fowBlendRect.p[0].x, x0);
+			fowBlendRect.p[0].y = std::min(fowBlendRect.p[0].y, y0);
+			fowBlendRect.p[1].x = std::max(fowBlendRect.p[1].x, x1);
+			fowBlendRect.p[1].y = std::max(fowBlendRect.p[1].y, y1);
+		}
+
+		void Minimap::setFowBlendAll() {
+			if (fowPixmap1 != NULL) {
+				fowBlendRect = Rect2i(0, 0, fowPixmap1->getW(), fowPixmap1->getH());
+			}
+		}
+
 		// ==================== PRIVATE ====================
 
 		void Minimap::computeTexture(const World *world) {
@@ -320,6 +413,7 @@ namespace Glest {
 					fowPixmap1->getPixels()[pixelIndex] = fowPixmap1Node->getAttribute("pixel")->getIntValue();
 				}
 			}
+			setFowBlendAll();
 		}
 
 	}
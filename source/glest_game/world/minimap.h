@@ -18,6 +18,7 @@
 #endif
 
 #include "pixmap.h"
+#include "math_util.h"
 #include "texture.h"
 #include "xml_parser.h"
 #include "leak_dumper.h"
@@ -28,6 +29,7 @@ namespace Glest {
 		using Shared::Graphics::Vec4f;
 		using Shared::Graphics::Vec3f;
 		using Shared::Graphics::Vec2i;
+		using Shared::Graphics::Rect2i;
 		using Shared::Graphics::Pixmap2D;
 		using Shared::Graphics::Texture2D;
 		using Shared::Xml::XmlNode;
@@ -61,6 +63,13 @@ namespace Glest {
 			bool fogOfWar;
 			const GameSettings *gameSettings;
 
+			// Cells where fowTex may still differ from fowPixmap1, the
+			// only ones updateFowTex has to blend
+			Rect2i fowBlendRect;
+			// Rows of fowTex written since the renderer uploaded them
+			mutable int fowUploadRowStart;
+			mutable int fowUploadRowEnd;
+
 		private:
 			static const float exploredAlpha;
 
@@ -76,6 +85,8 @@ namespace Glest {
 				return tex;
 			}
 
+			bool takeFowTexUploadRows(int &rowStart, int &rowCount) const;
+
 			void incFowTextureAlphaSurface(const Vec2i sPos, float alpha, bool isIncrementalUpdate = false);
 			void resetFowTex();
 			void updateFowTex(float t);
@@ -92,6 +103,8 @@ namespace Glest {
 
 		private:
 			void computeTexture(const World *world);
+			void addFowBlendRect(int x0, int y0, int x1, int y1);
+			void setFowBlendAll();
 		};
 
 	}
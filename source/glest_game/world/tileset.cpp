@@ -22,6 +22,8 @@
 #include "properties.h"
 #include "lang.h"
 #include "platform_util.h"
+#include "xml_tree_cache.h"
+#include "config.h"
 
 using namespace Shared::Util;
 using namespace Shared::Xml;
@@ -171,6 +173,13 @@ namespace Glest {
 
 				if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
+				// Reuse the parsed XML files while the tileset is unchanged
+				auto_ptr<XmlTreeCache> xmlTreeCache;
+				if (Config::getInstance().getBool("XmlTreeCache", "true") == true) {
+					uint32 tilesetCRC = getFolderTreeContentsCheckSumRecursively(currentPath + "*", ".xml", NULL);
+					xmlTreeCache.reset(new XmlTreeCache(currentPath, tilesetCRC, XmlTreeCache::getCacheFileName(currentPath)));
+				}
+
 				//printf("About to load tileset [%s]\n",path.c_str());
 				//parse xml
 				XmlTree xmlTree;
@@ -49,6 +49,8 @@ using namespace Shared::Util;
 namespace Glest {
 	namespace Game {
 
+		static ConfigBoolHandle configDisableWaterSounds("DisableWaterSounds", "false");
+
 		// =====================================================
 		// 	class UnitUpdater
 		// =====================================================
@@ -325,7 +327,7 @@ namespace Glest {
 
 					//play water sound
 					if (map->getCell(unit->getPos())->getHeight() < map->getWaterLevel() && unit->getCurrField() == fLand) {
-						if (Config::getInstance().getBool("DisableWaterSounds", "false") == false) {
+						if (configDisableWaterSounds.get() == false) {
 							soundRenderer.playFx(
 								CoreData::getInstance().getWaterSound(),
 								unit->getCurrMidHeightVector(),
@@ -2600,7 +2602,7 @@ namespace Glest {
 
 			//compute damage
 			//damage += random.randRange(-var, var);
-			damage += attacker->getRandom()->randRange(-var, var, extractFileFromDirectoryPath(__FILE__) + intToStr(__LINE__));
+			damage += attacker->getRandom()->randRange(-var, var, "unit_updater.cpp" TOSTRING(__LINE__));
 			damage /= distance + 1;
 			damage -= armor;
 			damage *= damageMultiplier;
@@ -2698,11 +2700,16 @@ namespace Glest {
 				visible = true;
 			}
 
+			// Attack effects draw from their own particle stream, never from
+			// the unit random which is part of the simulation state
+			const int particleRandomSeed = unit->getId() + world->getFrameCount();
+
 			//for(ProjectileParticleSystemTypes::const_iterator pit= unit->getCurrSkill()->projectileParticleSystemTypes.begin(); pit != unit->getCurrSkill()->projectileParticleSystemTypes.end(); ++pit) {
 			for (ProjectileTypes::const_iterator pt = ast->projectileTypes.begin(); pt != ast->projectileTypes.end(); ++pt) {
 				bool startAttackParticleSystemNow = ((*pt)->getAttackStartTime() >= lastAnimProgress && (*pt)->getAttackStartTime() < animProgress);
 				if (startAttackParticleSystemNow) {
 					ProjectileParticleSystem *psProj = (*pt)->getProjectileParticleSystemType()->create(unit);
+					psProj->setRandomSeed(particleRandomSeed);
 					psProj->setPath(startPos, endPos);
 					psProj->setObserver(new ParticleDamager(unit, (*pt), this, gameCamera));
 					psProj->setVisible(visible);
@@ -2714,6 +2721,7 @@ namespace Glest {
 
 					if (pstSplash != NULL) {
 						SplashParticleSystem *psSplash = pstSplash->create(unit);
+						psSplash->setRandomSeed(particleRandomSeed);
 						psSplash->setPos(endPos);
 						psSplash->setVisible(visible);
 						if (unit->getFaction()->getTexture()) {
@@ -2735,6 +2743,7 @@ namespace Glest {
 				//splash
 				if (pstSplash != NULL) {
 					SplashParticleSystem *psSplash = pstSplash->create(unit);
+					psSplash->setRandomSeed(particleRandomSeed);
 					psSplash->setPos(endPos);
 					psSplash->setVisible(visible);
 					if (unit->getFaction()->getTexture()) {
@@ -2937,8 +2946,6 @@ namespace Glest {
 				bool isZeta = controlType == ctCpuZeta || controlType == ctNetworkCpuZeta;
 
 
-				string randomInfoData = "enemies.size() = " + intToStr(enemies.size());
-
 				//printf("unit %d has control:%d\n",unit->getId(),controlType);
 				for (int i = 0; i < (int) enemies.size(); ++i) {
 					Unit *enemy = enemies[i];
@@ -2985,9 +2992,12 @@ namespace Glest {
 
 				if (evalMode == false && (isUltra || isZeta)) {
 
-					unit->getRandom()->addLastCaller(randomInfoData);
+					RandomGen *random = unit->getRandom();
+					if (random->getDisableLastCallerTracking() == false) {
+						random->addLastCaller("enemies.size() = " + intToStr(enemies.size()));
+					}
 
-					if (attackingEnemySeen != NULL && unit->getRandom()->randRange(0, 2, extractFileFromDirectoryPath(__FILE__) + intToStr(__LINE__)) != 2) {
+					if (attackingEnemySeen != NULL && random->randRange(0, 2, "unit_updater.cpp" TOSTRING(__LINE__)) != 2) {
 						//if( attackingEnemySeen != NULL) {
 						*rangedPtr = attackingEnemySeen;
 						enemySeen = attackingEnemySeen;
@@ -36,6 +36,7 @@
 #include <iostream>
 #include "sound.h"
 #include "sound_renderer.h"
+#include "map_preloader.h"
 
 #include "leak_dumper.h"
 
@@ -45,6 +46,12 @@ using namespace Shared::Util;
 namespace Glest {
 	namespace Game {
 
+		static ConfigBoolHandle configShowPerfStats("ShowPerfStats", "false");
+		static ConfigBoolHandle configEnableNewThreadManager("EnableNewThreadManager", "false");
+
+		// Each faction hands out unit ids from its own range of this size
+		static const int unitIdRangePerFaction = 100000;
+
 		// =====================================================
 		// 	class World
 		// =====================================================
@@ -54,6 +61,10 @@ namespace Glest {
 		//int MaxExploredCellsLookupItemCache = 0;
 		time_t ExploredCellsLookupItem::lastDebug = 0;
 
+		static bool compareUnitRenderState(const UnitRenderState &left, const UnitRenderState &right) {
+			return left.unitId < right.unitId;
+		}
+
 		// ===================== PUBLIC ========================
 
 		World::World() : mutexFactionNextUnitId(new Mutex(CODE_AT_LINE)) {
@@ -94,6 +105,9 @@ namespace Glest {
 			cacheFowAlphaTexture = false;
 			cacheFowAlphaTextureFogOfWarValue = false;
 
+			renderSnapshotEnabled = (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == false &&
+				config.getBool("InterpolateUnitMotion", "false"));
+
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 		}
 
@@ -500,7 +514,15 @@ namespace Glest {
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
 			checksum->addFile(path);
-			mapChecksum = map.load(path, techTree, &tileset);
+			// The lobby may have loaded and smoothed the terrain already
+			Map *preparedMap = MapPreloader::getInstance().takePreparedMap(path);
+			if (preparedMap != NULL) {
+				mapChecksum = map.adoptTerrain(*preparedMap);
+				delete preparedMap;
+				map.loadObjects(techTree, &tileset);
+			} else {
+				mapChecksum = map.load(path, techTree, &tileset);
+			}
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 			return mapChecksum;
 		}
@@ -585,7 +607,7 @@ namespace Glest {
 		}
 
 		void World::updateAllFactionUnits() {
-			bool showPerfStats = Config::getInstance().getBool("ShowPerfStats", "false");
+			bool showPerfStats = configShowPerfStats.get();
 			Chrono chronoPerf;
 			if (showPerfStats) chronoPerf.start();
 			char perfBuf[8096] = "";
@@ -628,7 +650,7 @@ namespace Glest {
 			Chrono chrono;
 			chrono.start();
 
-			const bool newThreadManager = Config::getInstance().getBool("EnableNewThreadManager", "false");
+			const bool newThreadManager = configEnableNewThreadManager.get();
 			if (newThreadManager == true) {
 				masterController.signalSlaves(&frameCount);
 				bool slavesCompleted = masterController.waitTillSlavesTrigger(20000);
@@ -837,7 +859,7 @@ namespace Glest {
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
 
-			bool showPerfStats = Config::getInstance().getBool("ShowPerfStats", "false");
+			bool showPerfStats = configShowPerfStats.get();
 			Chrono chronoPerf;
 			char perfBuf[8096] = "";
 			std::vector<string> perfList;
@@ -960,6 +982,10 @@ namespace Glest {
 				}
 			}
 
+			if (renderSnapshotEnabled == true) {
+				publishRenderSnapshot();
+			}
+
 			if (showPerfStats && chronoPerf.getMillis() >= 50) {
 				for (unsigned int x = 0; x < perfList.size(); ++x) {
 					printf("%s", perfList[x].c_str());
@@ -968,6 +994,49 @@ namespace Glest {
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
 		}
 
+		const UnitRenderState *WorldRenderSnapshot::findUnit(int unitId) const {
+			int low = 0;
+			int high = (int) units.size() - 1;
+			while (low <= high) {
+				int middle = (low + high) / 2;
+				if (units[middle].unitId < unitId) {
+					low = middle + 1;
+				} else if (units[middle].unitId > unitId) {
+					high = middle - 1;
+				} else {
+					return &units[middle];
+				}
+			}
+			return NULL;
+		}
+
+		void World::publishRenderSnapshot() {
+			// The buffer is reused, so after the first frames this
+			// only copies values without allocating
+			WorldRenderSnapshot &snapshot = renderSnapshots.getWriteBuffer();
+			snapshot.frameCount = frameCount;
+			snapshot.publishMillis = Chrono::getCurMillis();
+			snapshot.units.clear();
+
+			for (int factionIndex = 0; factionIndex < (int) factions.size(); ++factionIndex) {
+				const Faction *faction = factions[factionIndex];
+				for (int unitIndex = 0; unitIndex < faction->getUnitCount(); ++unitIndex) {
+					const Unit *unit = faction->getUnit(unitIndex);
+
+					UnitRenderState state;
+					state.unitId = unit->getId();
+					state.position = unit->getCurrVectorFlat();
+					state.rotation = unit->getRotation();
+					state.rotationX = unit->getRotationX();
+					state.rotationZ = unit->getRotationZ();
+					snapshot.units.push_back(state);
+				}
+			}
+			std::sort(snapshot.units.begin(), snapshot.units.end(), compareUnitRenderState);
+
+			renderSnapshots.publish();
+		}
+
 		bool World::canTickWorld() const {
 			//tick
 			bool needToTick = (frameCount % GameConstants::updateFps == 0);
@@ -975,7 +1044,7 @@ namespace Glest {
 		}
 
 		void World::tick() {
-			bool showPerfStats = Config::getInstance().getBool("ShowPerfStats", "false");
+			bool showPerfStats = configShowPerfStats.get();
 			Chrono chronoPerf;
 			char perfBuf[8096] = "";
 			std::vector<string> perfList;
@@ -1094,6 +1163,15 @@ namespace Glest {
 		}
 
 		Unit* World::findUnitById(int id) const {
+			// Try the faction owning the id range first, units moved between
+			// factions are still found by the scan below
+			int ownerFactionIndex = id / unitIdRangePerFaction;
+			if (id >= 0 && ownerFactionIndex < getFactionCount()) {
+				Unit* unit = getFaction(ownerFactionIndex)->findUnit(id);
+				if (unit != NULL) {
+					return unit;
+				}
+			}
 			for (int i = 0; i < getFactionCount(); ++i) {
 				const Faction* faction = getFaction(i);
 				Unit* unit = faction->findUnit(id);
@@ -1104,6 +1182,12 @@ namespace Glest {
 			return NULL;
 		}
 
+		// Ids handed in by scripts or saved games index paged tables, so
+		// they must fall inside the ranges the factions allocate from
+		bool World::isUnitIdInRange(int id) const {
+			return id >= 0 && id / unitIdRangePerFaction < max(getFactionCount(), 1);
+		}
+
 		const UnitType* World::findUnitTypeById(const FactionType* factionType, int id) {
 			if (factionType == NULL) {
 				throw megaglest_runtime_error("factionType == NULL");
@@ -2021,6 +2105,7 @@ namespace Glest {
 					sc00->setSurfaceTexture(texture);
 				}
 			}
+			map.markSurfaceChanged(0, 0, map.getSurfaceW() - 1, map.getSurfaceH() - 1);
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 		}
 
@@ -2086,7 +2171,7 @@ namespace Glest {
 				}
 			}
 
-			if (Config::getInstance().getBool("EnableNewThreadManager", "false") == true) {
+			if (configEnableNewThreadManager.get() == true) {
 				std::vector<SlaveThreadControllerInterface *> slaveThreadList;
 				for (unsigned int i = 0; i < factions.size(); ++i) {
 					Faction *faction = factions[i];
@@ -2720,7 +2805,7 @@ namespace Glest {
 		int World::getNextUnitId(Faction *faction) {
 			MutexSafeWrapper safeMutex(mutexFactionNextUnitId, string(__FILE__) + "_" + intToStr(__LINE__));
 			if (mapFactionNextUnitId.find(faction->getIndex()) == mapFactionNextUnitId.end()) {
-				mapFactionNextUnitId[faction->getIndex()] = faction->getIndex() * 100000;
+				mapFactionNextUnitId[faction->getIndex()] = faction->getIndex() * unitIdRangePerFaction;
 			}
 			return mapFactionNextUnitId[faction->getIndex()]++;
 		}
@@ -46,6 +46,7 @@
 #include "unit_updater.h"
 #include "randomgen.h"
 #include "game_constants.h"
+#include "triple_buffer.h"
 #include "leak_dumper.h"
 
 namespace Glest {
@@ -54,6 +55,7 @@ namespace Glest {
 		using Shared::Graphics::Quad2i;
 		using Shared::Graphics::Rect2i;
 		using Shared::Util::RandomGen;
+		using Shared::Util::TripleBuffer;
 
 		class Faction;
 		class Unit;
@@ -75,6 +77,33 @@ namespace Glest {
 		///	The game world: Map + Tileset + TechTree
 		// =====================================================
 
+		// =====================================================
+		// 	class WorldRenderSnapshot
+		//
+		//	Unit placement at the end of one world frame, used by
+		//	the renderer to blend unit motion between frames
+		// =====================================================
+
+		class UnitRenderState {
+		public:
+			int unitId;
+			Vec3f position;
+			float rotation;
+			float rotationX;
+			float rotationZ;
+		};
+
+		class WorldRenderSnapshot {
+		public:
+			int frameCount;
+			int64 publishMillis;
+			vector<UnitRenderState> units;	// sorted by unitId
+
+			WorldRenderSnapshot() : frameCount(-1), publishMillis(0) {
+			}
+			const UnitRenderState *findUnit(int unitId) const;
+		};
+
 		class ExploredCellsLookupKey {
 		public:
 
@@ -158,6 +187,9 @@ namespace Glest {
 
 			std::map<int, std::map<std::string, Resource > > TeamResources;
 
+			bool renderSnapshotEnabled;
+			TripleBuffer<WorldRenderSnapshot> renderSnapshots;
+
 		public:
 			World();
 			~World();
@@ -253,6 +285,12 @@ namespace Glest {
 			inline int getFrameCount() const {
 				return frameCount;
 			}
+			inline bool isRenderSnapshotEnabled() const {
+				return renderSnapshotEnabled;
+			}
+			inline TripleBuffer<WorldRenderSnapshot> &getRenderSnapshots() {
+				return renderSnapshots;
+			}
 
 			//init & load
 			void init(Game *game, bool createUnits, bool initFactions = true);
@@ -279,6 +317,7 @@ namespace Glest {
 			//misc
 			void update();
 			Unit* findUnitById(int id) const;
+			bool isUnitIdInRange(int id) const;
 			const UnitType* findUnitTypeById(const FactionType* factionType, int id);
 			const UnitType *findUnitTypeByName(const string factionName, const string unitTypeName);
 			bool placeUnit(const Vec2i &startLoc, int radius, Unit *unit, bool spaciated = false, bool threaded = false);
@@ -422,6 +461,7 @@ namespace Glest {
 			void underTakeDeadFactionUnits();
 			void updateAllFactionConsumableCosts();
 			void restoreExploredFogOfWarCells();
+			void publishRenderSnapshot();
 
 		};
 
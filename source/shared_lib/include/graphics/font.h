@@ -14,6 +14,8 @@
 
 #include <string>
 #include <vector>
+#include <list>
+#include <map>
 #include "font_text.h"
 #include "leak_dumper.h"
 
@@ -31,14 +33,29 @@ namespace Shared {
 		class FontMetrics {
 
 		private:
+			// Least recently used cache entries live at the back of the list
+			typedef std::list<std::pair<string, float> > TextWidthCacheList;
+			typedef std::map<string, TextWidthCacheList::iterator> TextWidthCacheLookup;
+			typedef std::pair<string, int> WordWrapCacheKey;
+			typedef std::list<std::pair<WordWrapCacheKey, string> > WordWrapCacheList;
+			typedef std::map<WordWrapCacheKey, WordWrapCacheList::iterator> WordWrapCacheLookup;
+
 			float *widths;
 			float height;
 
 			//float yOffsetFactor;
 			Text *textHandler;
 
+			TextWidthCacheList textWidthCache;
+			TextWidthCacheLookup textWidthCacheLookup;
+			WordWrapCacheList wordWrapCache;
+			WordWrapCacheLookup wordWrapCacheLookup;
+
+			float computeTextWidth(const string &str) const;
+
 		public:
 			//static float DEFAULT_Y_OFFSET_FACTOR;
+			static int textCacheMaxEntries;
 
 			FontMetrics(Text *textHandler = NULL);
 			~FontMetrics();
@@ -50,7 +67,10 @@ namespace Shared {
 			Text * getTextHandler();
 
 			void setWidth(int i, float width) {
-				this->widths[i] = width;
+				if (this->widths[i] != width) {
+					this->widths[i] = width;
+					clearTextCache();
+				}
 			}
 			void setHeight(float height) {
 				this->height = height;
@@ -59,7 +79,14 @@ namespace Shared {
 			float getTextWidth(const string &str);
 			float getHeight(const string &str) const;
 
-			string wordWrapText(string text, int maxWidth);
+			string wordWrapText(const string &text, int maxWidth);
+
+			// Drops all cached measurements, must be called whenever the
+			// font face, size or glyph widths change
+			void clearTextCache();
+			int getTextCacheSize() const {
+				return (int) (textWidthCache.size() + wordWrapCache.size());
+			}
 
 		};
 
@@ -14,6 +14,7 @@
 
 #include "model_renderer.h"
 #include "model.h"
+#include "model_batch.h"
 #include "opengl.h"
 #include "leak_dumper.h"
 #include "texture_gl.h"
@@ -41,6 +42,19 @@ namespace Shared {
 				static bool noTeamColors;
 			};
 
+			// =====================================================
+			//	class ModelInstanceCallback
+			//
+			//	Sets the per instance state of a batched draw
+			// =====================================================
+
+			class ModelInstanceCallback {
+			public:
+				virtual ~ModelInstanceCallback() {
+				}
+				virtual void execute(const ModelInstance &instance) = 0;
+			};
+
 			// =====================================================
 			//	class ModelRendererGl
 			// =====================================================
@@ -58,6 +72,9 @@ namespace Shared {
 				virtual void end();
 				virtual void render(Model *model, int renderMode = rmNormal, float alpha = 1.0f);
 				virtual void renderNormalsOnly(Model *model);
+				// Draws the model once per instance, the model must already
+				// be interpolated to the pose of the instances
+				void renderInstances(Model *model, const ModelInstance *instances, int instanceCount, ModelInstanceCallback *instanceCallback = NULL);
 
 				void setDuplicateTexCoords(bool duplicateTexCoords) {
 					this->duplicateTexCoords = duplicateTexCoords;
@@ -69,6 +86,9 @@ namespace Shared {
 			private:
 
 				void renderMesh(Mesh *mesh, int renderMode = rmNormal, float alpha = 1.0f);
+				bool beginMesh(Mesh *mesh, int renderMode, float alpha);
+				void drawMesh(Mesh *mesh);
+				void endMesh(Mesh *mesh, int renderMode);
 				void renderMeshNormals(Mesh *mesh);
 			};
 		}
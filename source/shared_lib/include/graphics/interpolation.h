@@ -15,6 +15,7 @@
 #include "vec.h"
 #include "model.h"
 #include <map>
+#include <vector>
 #include "leak_dumper.h"
 
 namespace Shared {
@@ -26,6 +27,23 @@ namespace Shared {
 
 		class InterpolationData {
 		private:
+			// One interpolated pose, shared by every unit that draws the
+			// mesh at the same frame pair and quantized phase
+			class PoseCacheEntry {
+			public:
+				uint32 prevFrame;
+				uint32 nextFrame;
+				float localT;
+				bool cycle;
+				bool verticesValid;
+				bool normalsValid;
+				uint32 lastUsed;
+				Vec3f *vertices;
+				Vec3f *normals;
+
+				PoseCacheEntry();
+			};
+
 			const Mesh *mesh;
 
 			Vec3f *vertices;
@@ -33,9 +51,15 @@ namespace Shared {
 
 			int raw_frame_ofs;
 
+			std::vector<PoseCacheEntry> poseCache;
+			uint32 poseCacheUseCounter;
+
 			static bool enableInterpolation;
+			static int poseQuantizationSteps;
+			static int poseCacheSize;
 
-			void update(const Vec3f* src, Vec3f* &dest, float t, bool cycle);
+			void update(float t, bool cycle, bool updateVertices, bool updateNormals);
+			PoseCacheEntry *findPose(uint32 prevFrame, uint32 nextFrame, float localT, bool cycle);
 
 		public:
 			InterpolationData(const Mesh *mesh);
@@ -44,6 +68,15 @@ namespace Shared {
 			static void setEnableInterpolation(bool enabled) {
 				enableInterpolation = enabled;
 			}
+			// Steps between two keyframes a pose is rounded to, 0 disables rounding
+			static void setPoseQuantizationSteps(int steps) {
+				poseQuantizationSteps = steps;
+			}
+			static void setPoseCacheSize(int size) {
+				poseCacheSize = size;
+			}
+
+			static void lerpFrames(const Vec3f *prev, const Vec3f *next, Vec3f *dest, uint32 count, float t);
 
 			const Vec3f *getVertices() const {
 				return !vertices || !enableInterpolation ? mesh->getVertices() + raw_frame_ofs : vertices;
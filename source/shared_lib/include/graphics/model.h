@@ -113,6 +113,7 @@ namespace Shared {
 				return indexCount;
 			}
 			uint32 getTriangleCount() const;
+			std::size_t getDataByteCount() const;
 
 			uint32	getVBOVertices() const {
 				return m_nVBOVertices;
@@ -282,6 +283,7 @@ namespace Shared {
 
 			uint32 getTriangleCount() const;
 			uint32 getVertexCount() const;
+			std::size_t getDataByteCount() const;
 
 			//io
 			void save(const string &path, string convertTextureToFormat, bool keepsmallest);
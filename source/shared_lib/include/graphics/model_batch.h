@@ -0,0 +1,107 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_GRAPHICS_MODELBATCH_H_
+#define _SHARED_GRAPHICS_MODELBATCH_H_
+
+#include <vector>
+#include "vec.h"
+#include "leak_dumper.h"
+
+using std::vector;
+
+namespace Shared {
+	namespace Graphics {
+
+		class Model;
+		class Texture;
+
+		// =====================================================
+		//	class ModelInstance
+		//
+		//	One placement of a model: transform and color
+		// =====================================================
+
+		class ModelInstance {
+		public:
+			// Column major like glMultMatrixf expects
+			float transform[16];
+			Vec4f color;
+			float animProgress;
+
+			ModelInstance();
+			void setTransform(const Vec3f &position, float rotationDegrees);
+		};
+
+		// =====================================================
+		//	class ModelBatch
+		//
+		//	A run of instances sharing model and animation pose
+		// =====================================================
+
+		class ModelBatch {
+		public:
+			Model *model;
+			float animProgress;
+			int firstInstance;
+			int instanceCount;
+		};
+
+		// =====================================================
+		//	class ModelBatchList
+		//
+		//	Groups model instances so that instances of the same
+		//	model and pose are drawn together. Batches are ordered
+		//	by the texture of the first mesh, then by model, so
+		//	models sharing a texture follow each other. Instances
+		//	keep the order they were added in within a batch.
+		// =====================================================
+
+		class ModelBatchList {
+		private:
+			class Entry {
+			public:
+				const Texture *texture;
+				Model *model;
+				float animProgress;
+				int instanceIndex;
+
+				bool operator<(const Entry &other) const;
+			};
+
+			vector<Entry> entries;
+			vector<ModelInstance> addedInstances;
+			vector<ModelInstance> instances;
+			vector<ModelBatch> batches;
+
+		public:
+			void clear();
+			void add(Model *model, const ModelInstance &instance);
+			void add(Model *model, const Texture *texture, const ModelInstance &instance);
+			void build();
+
+			const vector<ModelBatch> &getBatches() const {
+				return batches;
+			}
+			const vector<ModelInstance> &getInstances() const {
+				return instances;
+			}
+			int getInstanceCount() const {
+				return (int) instances.size();
+			}
+
+			static const Texture *getModelTexture(const Model *model);
+		};
+
+	}
+}//end namespace
+
+#endif
@@ -13,17 +13,20 @@
 #define _SHARED_GRAPHICS_PARTICLE_H_
 
 #include <list>
+#include <unordered_map>
 #include <cassert>
 #include "vec.h"
 #include "pixmap.h"
 #include "texture_manager.h"
 #include "randomgen.h"
 #include "xml_parser.h"
+#include "object_pool.h"
 #include "leak_dumper.h"
 #include "interpolation.h"
 
 using std::list;
 using Shared::Util::RandomGen;
+using Shared::Util::rsParticles;
 using Shared::Xml::XmlNode;
 
 namespace Shared {
@@ -39,6 +42,7 @@ namespace Shared {
 		class ParticleRenderer;
 		class ModelRenderer;
 		class Model;
+		class ParticleManager;
 
 		// =====================================================
 		//	class Particle
@@ -193,6 +197,10 @@ namespace Shared {
 			ParticleObserver *particleObserver;
 			ParticleOwner *particleOwner;
 
+		private:
+			friend class ParticleManager;
+			ParticleManager *particleManager;
+
 		public:
 			//conmstructor and destructor
 			ParticleSystem(int particleCount);
@@ -275,9 +283,13 @@ namespace Shared {
 			virtual void fade();
 			int isEmpty() const;
 
-			virtual void setParticleOwner(ParticleOwner *particleOwner) {
-				this->particleOwner = particleOwner;
+			// Particle systems use their own random stream so effects never
+			// consume numbers from a simulation generator
+			void setRandomSeed(int seed) {
+				random.init(seed, rsParticles);
 			}
+
+			virtual void setParticleOwner(ParticleOwner *particleOwner);
 			virtual ParticleOwner * getParticleOwner() {
 				return this->particleOwner;
 			}
@@ -459,6 +471,10 @@ namespace Shared {
 		public:
 			UnitParticleSystem(int particleCount = 2000);
 			~UnitParticleSystem();
+#ifndef SL_LEAK_DUMP
+			static void *operator new(size_t size);
+			static void operator delete(void *ptr, size_t size);
+#endif
 
 			virtual ParticleSystemType getParticleSystemType() const {
 				return pst_UnitParticleSystem;
@@ -712,6 +728,10 @@ namespace Shared {
 		public:
 			ProjectileParticleSystem(int particleCount = 1000);
 			virtual ~ProjectileParticleSystem();
+#ifndef SL_LEAK_DUMP
+			static void *operator new(size_t size);
+			static void operator delete(void *ptr, size_t size);
+#endif
 
 			virtual ParticleSystemType getParticleSystemType() const {
 				return pst_SplashParticleSystem;
@@ -770,6 +790,10 @@ namespace Shared {
 		public:
 			SplashParticleSystem(int particleCount = 1000);
 			virtual ~SplashParticleSystem();
+#ifndef SL_LEAK_DUMP
+			static void *operator new(size_t size);
+			static void operator delete(void *ptr, size_t size);
+#endif
 
 			virtual void update();
 			virtual void initParticle(Particle *p, int particleIndex);
@@ -807,7 +831,21 @@ namespace Shared {
 
 		class ParticleManager {
 		private:
+			typedef std::unordered_map<const ParticleSystem *, int> SlotMap;
+			typedef std::unordered_map<ParticleOwner *, vector<ParticleSystem *> > OwnerMap;
+
+			// Removed systems leave a NULL slot until the next compaction,
+			// so drawing and update order stay the order of manage calls
 			vector<ParticleSystem *> particleSystems;
+			int emptySlotCount;
+			bool updating;
+			SlotMap particleSystemSlots;
+			OwnerMap ownerParticleSystems;
+
+			void addOwnerEntry(ParticleSystem *ps, ParticleOwner *particleOwner);
+			void removeOwnerEntry(ParticleSystem *ps, ParticleOwner *particleOwner);
+			bool unmanage(ParticleSystem *ps);
+			void compact();
 
 		public:
 			ParticleManager();
@@ -819,10 +857,13 @@ namespace Shared {
 			void cleanupParticleSystems(ParticleSystem *ps);
 			void cleanupParticleSystems(vector<ParticleSystem *> &particleSystems);
 			void cleanupUnitParticleSystems(vector<UnitParticleSystem *> &particleSystems);
-			int findParticleSystems(ParticleSystem *psFind, const vector<ParticleSystem *> &particleSystems) const;
 			bool validateParticleSystemStillExists(ParticleSystem * particleSystem) const;
 			void removeParticleSystemsForParticleOwner(ParticleOwner * particleOwner);
+			void changeParticleOwner(ParticleSystem *ps, ParticleOwner *oldOwner, ParticleOwner *newOwner);
 			bool hasActiveParticleSystem(ParticleSystem::ParticleSystemType type) const;
+			int getParticleSystemCount() const {
+				return (int) particleSystemSlots.size();
+			}
 		};
 
 	}
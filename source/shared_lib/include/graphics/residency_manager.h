@@ -0,0 +1,84 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_GRAPHICS_RESIDENCYMANAGER_H_
+#define _SHARED_GRAPHICS_RESIDENCYMANAGER_H_
+
+#include <string>
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using std::string;
+using Shared::Platform::int64;
+using Shared::Platform::uint32;
+
+namespace Shared {
+	namespace Graphics {
+
+		class Texture2D;
+		class Model;
+
+		// =====================================================
+		//	class ResidencyManager
+		//
+		// Keeps track of the memory held by loaded textures and
+		// models. Once the pixels of file backed textures kept in
+		// RAM exceed the budget, those idle the longest are dropped
+		// if the GPU already has them; they are read from the file
+		// again when something asks for them.
+		// =====================================================
+
+		class ResidencyManager {
+		public:
+			enum Category {
+				rcTexturePixels,
+				rcTextureUploads,
+				rcModelMeshes,
+
+				rcCount
+			};
+
+			// Textures used within this many frames are never dropped
+			static const uint32 minIdleFrames;
+			// The budget is checked once every this many frames
+			static const uint32 checkIntervalFrames;
+
+		private:
+			ResidencyManager();
+
+		public:
+			static void registerTexture(Texture2D *texture);
+			static void unregisterTexture(Texture2D *texture);
+			static void registerModel(Model *model);
+			static void unregisterModel(Model *model);
+
+			// A negative budget keeps all pixels
+			static void setTexturePixelBudget(int64 bytes);
+			static int64 getTexturePixelBudget();
+
+			static uint32 getCurrentFrame();
+			static void nextFrame();
+			static int enforceBudget();
+
+			// Reads dropped pixels back from the file, the check is
+			// repeated under the lock so it can't race the eviction
+			static void reloadPixels(Texture2D *texture);
+			static int64 getEvictedCount();
+			static int64 getReloadedCount();
+
+			static int64 getResidentBytes(Category category);
+			static string getStatsText();
+		};
+
+	}
+}//end namespace
+
+#endif
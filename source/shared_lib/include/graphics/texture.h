@@ -15,6 +15,7 @@
 #include "data_types.h"
 #include "pixmap.h"
 #include <string>
+#include <atomic>
 #include "leak_dumper.h"
 
 using std::string;
@@ -170,20 +171,49 @@ namespace Shared {
 		// =====================================================
 
 		class Texture2D : public Texture {
+			friend class ResidencyManager;
+
 		protected:
 			Pixmap2D pixmap;
 
+		private:
+			// Set while the pixels can be read from path again. The
+			// residency check runs on the main thread while loader
+			// threads use the texture
+			std::atomic<bool> fileBacked;
+			std::atomic<bool> pixelsEvicted;
+			mutable std::atomic<uint32> lastUsedFrame;
+			int residencySlot;
+
+			void evictPixels();
+
+		protected:
+			void ensurePixels() const;
+			// For subclasses that change the pixels in place
+			void clearFileBacked() {
+				fileBacked = false;
+			}
+
 		public:
+			Texture2D();
+			virtual ~Texture2D();
+
 			void load(const string &path);
 
-			Pixmap2D *getPixmap() {
-				return &pixmap;
-			}
-			const Pixmap2D *getPixmapConst() const {
-				return &pixmap;
-			}
+			Pixmap2D *getPixmap();
+			const Pixmap2D *getPixmapConst() const;
 			virtual string getPath() const;
 			virtual void deletePixels();
+
+			bool hasPixelData() const {
+				return pixmap.getPixels() != NULL;
+			}
+			bool canEvictPixels() const {
+				return inited == true && fileBacked == true && hasPixelData() == true;
+			}
+			uint32 getLastUsedFrame() const {
+				return lastUsedFrame.load();
+			}
 			virtual std::size_t getPixelByteCount() const {
 				return pixmap.getPixelByteCount();
 			}
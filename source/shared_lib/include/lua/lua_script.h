@@ -72,6 +72,12 @@ namespace Shared {
 			void beginCall(string functionName);
 			void endCall();
 
+			// Registry references let hot event handlers be called without
+			// a global lookup by name, LUA_NOREF means no such function
+			int getFunctionRef(const string &functionName);
+			void releaseFunctionRef(int functionRef);
+			void beginCall(int functionRef, const string &functionName);
+
 			int runCode(const string code);
 			void setSandboxWrapperFunctionName(string name);
 			void setSandboxCode(string code);
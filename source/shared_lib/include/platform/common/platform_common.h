@@ -244,6 +244,7 @@ namespace Shared {
 		bool renameFile(string oldFile, string newFile);
 		void removeFolder(const string &path);
 		off_t getFileSize(string filename);
+		int64 getFileModificationTime(const string &filename);
 		bool searchAndReplaceTextInFile(string fileName, string findText, string replaceText, bool simulateOnly);
 		void copyFileTo(string fromFileName, string toFileName);
 
@@ -311,21 +312,81 @@ namespace Shared {
 
 		string safeCharPtrCopy(const char *ptr, int maxLength = -1);
 
+		// Keeps shadow copies of sensitive values (hp, ep, unit type stats)
+		// to detect memory tampering. Owners track only a handful of values
+		// so they live in a fixed slot array searched linearly, values past
+		// the inline slots spill into a vector.
 		class ValueCheckerVault {
 
-		protected:
-			std::map<const void *, int32> vaultList;
+		private:
+			static const int vaultInlineSlotCount = 4;
+
+			class VaultItem {
+			public:
+				const void *ptr;
+				int32 value;
+			};
 
+			VaultItem vaultSlots[vaultInlineSlotCount];
+			int vaultSlotsUsed;
+			std::vector<VaultItem> vaultOverflowList;
+
+			const VaultItem * findVaultItem(const void *ptr) const;
+
+		protected:
 			void addItemToVault(const void *ptr, int value);
 			void checkItemInVault(const void *ptr, int value) const;
 
 		public:
 
-			ValueCheckerVault() {
-				vaultList.clear();
+			ValueCheckerVault() : vaultSlotsUsed(0) {
 			}
 		};
 
+		// =====================================================
+		//	class ContentManifest
+		//
+		// Per-file CRC list of a content folder (tileset, techtree) relative
+		// to its root. A host publishes it so clients can download only the
+		// files that are missing or differ from their local copy.
+		// =====================================================
+		class ContentManifest {
+		public:
+			class Entry {
+			public:
+				string path;
+				uint32 crc;
+				int64 size;
+
+				Entry() : crc(0), size(0) {
+				}
+			};
+
+		private:
+			static const char *manifestHeader;
+
+			string account;
+			vector<Entry> entries;
+
+		public:
+			void build(const string &rootFolder, const string &account, bool forceNoCache = false);
+			bool save(const string &fileName) const;
+			bool load(const string &fileName);
+
+			// FTP account on the host that serves the files of this manifest
+			const string &getAccount() const {
+				return account;
+			}
+			const vector<Entry> &getEntries() const {
+				return entries;
+			}
+
+			vector<Entry> getChangedEntries(const ContentManifest &localManifest) const;
+			vector<string> getObsoletePaths(const ContentManifest &localManifest) const;
+
+			static string getManifestFileName(const string &contentType, const string &contentName);
+		};
+
 
 	}
 }//end namespace
@@ -103,6 +103,12 @@ namespace Shared {
 			void getTechtreeFromServer(pair<string, string> techtreeName);
 			pair<FTP_Client_ResultType, string> getTechtreeFromServer(pair<string, string> techtreeName, string ftpUser, string ftpUserPassword);
 
+			// Downloads only the files that differ from the host's published
+			// content manifest, fails when the host has no manifest
+			pair<FTP_Client_ResultType, string> getContentDeltaFromServer(FTP_Client_CallbackType downloadType,
+				pair<string, string> contentName, const string &contentType,
+				const string &destRootPath, const string &baseUser, const string &customUser);
+
 			void getScenarioFromServer(pair<string, string> fileName);
 			pair<FTP_Client_ResultType, string> getScenarioInternalFromServer(pair<string, string> fileName);
 
@@ -20,6 +20,7 @@
 #include "base_thread.h"
 #include <vector>
 #include <string>
+#include <map>
 #include "data_types.h"
 #include "socket.h"
 
@@ -49,6 +50,13 @@ namespace Shared {
 			bool allowInternetTilesetFileTransfers;
 			bool allowInternetTechtreeFileTransfers;
 
+			// content CRC each published manifest was built for, by manifest file
+			std::map<string, uint32> publishedManifestCRCs;
+
+			bool publishContentManifest(const std::pair<string, string> &contentPaths,
+				const char *baseUser, const char *customUser,
+				const string &contentType, const string &contentName, uint32 contentCRC);
+
 		public:
 
 			FTPServerThread(std::pair<string, string> mapsPath,
@@ -63,6 +71,11 @@ namespace Shared {
 			virtual bool shutdownAndWait();
 
 			void setInternetEnabled(bool value, bool forceChange = false);
+
+			// Writes the per file CRC manifest of a tileset / techtree into the
+			// temp files folder so clients can download only what differs
+			bool publishTilesetManifest(const string &tilesetName, uint32 tilesetCRC);
+			bool publishTechtreeManifest(const string &techtreeName, uint32 techtreeCRC);
 			static void addClientToServerIPAddress(uint32 clientIp, uint32 ServerIp);
 			static FTPClientValidationInterface * getFtpValidationIntf() {
 				return ftpValidationIntf;
@@ -48,7 +48,7 @@ public:
 	StaticSoundSource();
 	virtual ~StaticSoundSource();
 
-	void play(StaticSound* sound);
+	void play(StaticSound* sound, const int8 *samples, uint32 size);
 
 protected:
 	friend class SoundPlayerOpenAL;
@@ -77,6 +77,7 @@ protected:
 
 	StrSound* sound;
 	ALuint buffers[STREAMFRAGMENTS];
+	int8 *fragmentData;
 	ALenum format;
 
 	enum FadeState { NoFading, FadingOn, FadingOff };
@@ -111,9 +111,13 @@ namespace Shared {
 		//	class StaticSound
 		// =====================================================
 
+		class SoundSampleBuffer;
+
 		class StaticSound : public Sound {
 		private:
 			int8 * samples;
+			bool lazy;
+			SoundSampleBuffer *lockedBuffer;
 
 		public:
 			StaticSound();
@@ -122,9 +126,19 @@ namespace Shared {
 			int8 *getSamples() const {
 				return samples;
 			}
+			bool isLazy() const {
+				return lazy;
+			}
 
 			void load(const string &path);
 			void close();
+
+			// Samples to play, decoded through the sample cache when the
+			// sound was loaded lazily. NULL if they are not decoded yet.
+			const int8 *lockSamples(uint32 &size);
+			void unlockSamples();
+
+			static int8 *decodeFile(const string &path, SoundInfo *info);
 		};
 
 		// =====================================================
@@ -0,0 +1,168 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_SOUND_SOUNDSAMPLECACHE_H_
+#define _SHARED_SOUND_SOUNDSAMPLECACHE_H_
+
+#include <string>
+#include <map>
+#include <vector>
+#include "sound.h"
+#include "base_thread.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+
+namespace Shared {
+	namespace Sound {
+
+		class SoundSampleCache;
+
+		// =====================================================
+		//	class SoundSampleBuffer
+		//
+		//	Decoded samples of one sound file, shared by all
+		//	static sounds loaded from that file
+		// =====================================================
+
+		class SoundSampleBuffer {
+		private:
+			friend class SoundSampleCache;
+
+			string path;
+			SoundInfo info;
+			int8 *samples;
+			int refCount;
+			int priority;
+			uint64 lastUsed;
+			bool queued;
+			bool decoding;
+			bool failed;
+
+		public:
+			explicit SoundSampleBuffer(const string &path);
+			~SoundSampleBuffer();
+
+			const string &getPath() const {
+				return path;
+			}
+			const SoundInfo *getInfo() const {
+				return &info;
+			}
+			const int8 *getSamples() const {
+				return samples;
+			}
+			bool isReady() const {
+				return samples != NULL;
+			}
+		};
+
+		// =====================================================
+		//	class SoundSampleDecoder
+		//
+		//	Decodes a whole sound file, returns a buffer
+		//	allocated with new[] or NULL
+		// =====================================================
+
+		class SoundSampleDecoder {
+		public:
+			virtual ~SoundSampleDecoder() {
+			}
+			virtual int8 *decode(const string &path, SoundInfo *info) = 0;
+		};
+
+		// =====================================================
+		//	class SoundDecodeThread
+		// =====================================================
+
+		class SoundDecodeThread : public BaseThread {
+		private:
+			SoundSampleCache *cache;
+
+		public:
+			explicit SoundDecodeThread(SoundSampleCache *cache);
+			virtual void execute();
+		};
+
+		// =====================================================
+		//	class SoundSampleCache
+		//
+		//	LRU cache of decoded static sounds with a memory cap.
+		//	Sounds not in the cache are queued by priority and
+		//	decoded by a pool of background threads. Short sounds
+		//	that are played, and all sounds when no decode thread
+		//	is running, are decoded right away.
+		// =====================================================
+
+		class SoundSampleCache {
+		public:
+			static const int priorityPrefetch = 0;
+			static const int priorityPlay = 10;
+			static const uint64 defaultMemoryLimit = 64 * 1024 * 1024;
+			// Played sounds up to this size are decoded right away
+			// when they are not cached, longer ones wait for a thread
+			static const uint32 defaultInlineDecodeLimit = 2 * 1024 * 1024;
+
+		private:
+			typedef std::map<string, SoundSampleBuffer *> BufferMap;
+
+			Mutex *mutex;
+			Semaphore decodeSignal;
+			BufferMap buffers;
+			vector<SoundSampleBuffer *> decodeQueue;
+			vector<SoundDecodeThread *> decodeThreads;
+			SoundSampleDecoder *decoder;
+			bool lazyLoading;
+			uint64 memoryLimit;
+			uint64 memoryUsage;
+			uint32 inlineDecodeLimit;
+			uint64 useCounter;
+
+			SoundSampleBuffer *getBuffer(const string &path);
+			void queueDecode(SoundSampleBuffer *buffer, int priority);
+			void decodeBuffer(SoundSampleBuffer *buffer);
+			void evict(const SoundSampleBuffer *keep);
+
+		public:
+			SoundSampleCache();
+			~SoundSampleCache();
+
+			static SoundSampleCache &getInstance();
+
+			void setDecoder(SoundSampleDecoder *decoder);
+			void setLazyLoading(bool value);
+			bool getLazyLoading();
+			void setMemoryLimit(uint64 value);
+			uint64 getMemoryLimit();
+			uint64 getMemoryUsage();
+			void setInlineDecodeLimit(uint32 value);
+			uint32 getInlineDecodeLimit();
+
+			void startDecodeThreads(int threadCount);
+			void stopDecodeThreads();
+			int getDecodeThreadCount();
+
+			SoundSampleBuffer *acquire(const string &path, int priority = priorityPlay, uint32 expectedSize = 0);
+			void release(SoundSampleBuffer *buffer);
+			void prefetch(const string &path, int priority = priorityPrefetch);
+
+			bool decodeNext();
+			bool waitForDecodeRequest(int waitMilliseconds);
+			bool isCached(const string &path);
+			void clear();
+		};
+
+	}
+}//end namespace
+
+#endif
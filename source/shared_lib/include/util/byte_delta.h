@@ -0,0 +1,54 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_BYTEDELTA_H_
+#define _SHARED_UTIL_BYTEDELTA_H_
+
+#include <vector>
+#include "leak_dumper.h"
+
+using std::vector;
+
+namespace Shared {
+	namespace Util {
+
+		// =====================================================
+		//	class ByteDelta
+		//
+		// Byte ranges of a buffer that differ from a base buffer of
+		// the same size, stored as runs of: uint16 offset, uint16
+		// length, bytes. Offsets and lengths are in common endian
+		// order so the runs can be sent as they are.
+		// =====================================================
+
+		class ByteDelta {
+		private:
+			ByteDelta();
+
+		public:
+			// Appends the runs to the payload and returns how many were
+			// added. Unchanged gaps up to maxRunGapBytes are sent instead
+			// of starting a new run. Buffers must be the same size and
+			// no larger than 64k.
+			static int encode(const vector<unsigned char> &base,
+				const vector<unsigned char> &target,
+				vector<unsigned char> &payload, int maxRunGapBytes);
+
+			// Writes the runs over the buffer, fails without touching it
+			// when the payload is truncated or a run is out of range
+			static bool apply(const vector<unsigned char> &payload, int runCount,
+				vector<unsigned char> &buffer);
+		};
+
+	}
+}//end namespace
+
+#endif
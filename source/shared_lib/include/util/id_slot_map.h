@@ -0,0 +1,285 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_IDSLOTMAP_H_
+#define _SHARED_UTIL_IDSLOTMAP_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "platform_util.h"
+#include "conversion.h"
+#include "leak_dumper.h"
+
+namespace Shared {
+	namespace Util {
+
+		// =====================================================
+		//	class IdSlotMap
+		//
+		// Map keyed by non negative integer ids (unit ids) that stores
+		// values in pages of slots indexed directly by the id. Lookups are
+		// O(1), iteration visits ids in ascending order like std::map and
+		// pages emptied by erase or clear are kept on a free list for reuse.
+		// Each slot keeps the id it was filled for and lookups check it,
+		// so a recycled page never answers for a stale id.
+		// =====================================================
+
+		template<typename T>
+		class IdSlotMap {
+		public:
+			typedef std::pair<int, T> value_type;
+
+		private:
+			static const int pageBits = 8;
+			static const int pageSize = 1 << pageBits;
+
+			class Page {
+			public:
+				value_type slots[pageSize];
+				int count;
+
+				Page() : count(0) {
+					for (int index = 0; index < pageSize; ++index) {
+						slots[index].first = -1;
+					}
+				}
+			};
+
+			std::vector<Page *> pages;
+			std::vector<Page *> freePages;
+			size_t entryCount;
+
+			template<typename MapType, typename ValueType>
+			class IteratorImpl {
+			private:
+				MapType *owner;
+				int pageIndex;
+				int slotIndex;
+
+				friend class IdSlotMap;
+				template<typename, typename> friend class IteratorImpl;
+
+				void skipUnused() {
+					for (; pageIndex < (int) owner->pages.size(); ++pageIndex, slotIndex = 0) {
+						const Page *page = owner->pages[pageIndex];
+						if (page == NULL || page->count == 0) {
+							continue;
+						}
+						for (; slotIndex < pageSize; ++slotIndex) {
+							if (page->slots[slotIndex].first >= 0) {
+								return;
+							}
+						}
+					}
+					slotIndex = 0;
+				}
+
+			public:
+				IteratorImpl() : owner(NULL), pageIndex(0), slotIndex(0) {
+				}
+				IteratorImpl(MapType *owner, int pageIndex, int slotIndex) :
+					owner(owner), pageIndex(pageIndex), slotIndex(slotIndex) {
+				}
+				template<typename OtherMapType, typename OtherValueType>
+				IteratorImpl(const IteratorImpl<OtherMapType, OtherValueType> &other) :
+					owner(other.owner), pageIndex(other.pageIndex), slotIndex(other.slotIndex) {
+				}
+
+				ValueType &operator*() const {
+					return owner->pages[pageIndex]->slots[slotIndex];
+				}
+				ValueType *operator->() const {
+					return &owner->pages[pageIndex]->slots[slotIndex];
+				}
+				IteratorImpl &operator++() {
+					++slotIndex;
+					skipUnused();
+					return *this;
+				}
+				IteratorImpl operator++(int) {
+					IteratorImpl result = *this;
+					++(*this);
+					return result;
+				}
+				bool operator==(const IteratorImpl &other) const {
+					return pageIndex == other.pageIndex && slotIndex == other.slotIndex;
+				}
+				bool operator!=(const IteratorImpl &other) const {
+					return !(*this == other);
+				}
+			};
+
+		public:
+			typedef IteratorImpl<IdSlotMap, value_type> iterator;
+			typedef IteratorImpl<const IdSlotMap, const value_type> const_iterator;
+
+		private:
+			const value_type *findSlot(int id) const {
+				if (id < 0) {
+					return NULL;
+				}
+				size_t pageIndex = (size_t) id >> pageBits;
+				if (pageIndex >= pages.size() || pages[pageIndex] == NULL) {
+					return NULL;
+				}
+				const value_type &slot = pages[pageIndex]->slots[id & (pageSize - 1)];
+				return (slot.first == id ? &slot : NULL);
+			}
+
+			Page *newPage() {
+				if (freePages.empty() == false) {
+					Page *page = freePages.back();
+					freePages.pop_back();
+					return page;
+				}
+				return new Page();
+			}
+
+			void releasePage(size_t pageIndex) {
+				Page *page = pages[pageIndex];
+				for (int index = 0; page->count > 0 && index < pageSize; ++index) {
+					if (page->slots[index].first >= 0) {
+						page->slots[index].first = -1;
+						page->slots[index].second = T();
+						page->count--;
+					}
+				}
+				pages[pageIndex] = NULL;
+				freePages.push_back(page);
+			}
+
+			void copyFrom(const IdSlotMap &other) {
+				for (const_iterator iterMap = other.begin(); iterMap != other.end(); ++iterMap) {
+					(*this)[iterMap->first] = iterMap->second;
+				}
+			}
+
+		public:
+			IdSlotMap() : entryCount(0) {
+			}
+			IdSlotMap(const IdSlotMap &other) : entryCount(0) {
+				copyFrom(other);
+			}
+			~IdSlotMap() {
+				for (size_t index = 0; index < pages.size(); ++index) {
+					delete pages[index];
+				}
+				for (size_t index = 0; index < freePages.size(); ++index) {
+					delete freePages[index];
+				}
+			}
+
+			IdSlotMap &operator=(const IdSlotMap &other) {
+				if (this != &other) {
+					clear();
+					copyFrom(other);
+				}
+				return *this;
+			}
+
+			T &operator[](int id) {
+				if (id < 0) {
+					throw megaglest_runtime_error("Invalid id for IdSlotMap: " + intToStr(id));
+				}
+				size_t pageIndex = (size_t) id >> pageBits;
+				if (pageIndex >= pages.size()) {
+					pages.resize(pageIndex + 1, NULL);
+				}
+				if (pages[pageIndex] == NULL) {
+					pages[pageIndex] = newPage();
+				}
+				Page *page = pages[pageIndex];
+				value_type &slot = page->slots[id & (pageSize - 1)];
+				if (slot.first != id) {
+					slot.first = id;
+					page->count++;
+					entryCount++;
+				}
+				return slot.second;
+			}
+
+			iterator find(int id) {
+				if (findSlot(id) == NULL) {
+					return end();
+				}
+				return iterator(this, id >> pageBits, id & (pageSize - 1));
+			}
+			const_iterator find(int id) const {
+				if (findSlot(id) == NULL) {
+					return end();
+				}
+				return const_iterator(this, id >> pageBits, id & (pageSize - 1));
+			}
+
+			// Returns NULL when the id has no entry
+			T *get(int id) {
+				return const_cast<T *>(static_cast<const IdSlotMap *>(this)->get(id));
+			}
+			const T *get(int id) const {
+				const value_type *slot = findSlot(id);
+				return (slot != NULL ? &slot->second : NULL);
+			}
+
+			size_t erase(int id) {
+				value_type *slot = const_cast<value_type *>(findSlot(id));
+				if (slot == NULL) {
+					return 0;
+				}
+				size_t pageIndex = (size_t) id >> pageBits;
+				slot->first = -1;
+				slot->second = T();
+				entryCount--;
+				if (--pages[pageIndex]->count == 0) {
+					releasePage(pageIndex);
+				}
+				return 1;
+			}
+
+			void clear() {
+				for (size_t index = 0; index < pages.size(); ++index) {
+					if (pages[index] != NULL) {
+						releasePage(index);
+					}
+				}
+				pages.clear();
+				entryCount = 0;
+			}
+
+			size_t size() const {
+				return entryCount;
+			}
+			bool empty() const {
+				return entryCount == 0;
+			}
+
+			iterator begin() {
+				iterator result(this, 0, 0);
+				result.skipUnused();
+				return result;
+			}
+			iterator end() {
+				return iterator(this, (int) pages.size(), 0);
+			}
+			const_iterator begin() const {
+				const_iterator result(this, 0, 0);
+				result.skipUnused();
+				return result;
+			}
+			const_iterator end() const {
+				return const_iterator(this, (int) pages.size(), 0);
+			}
+		};
+
+	}
+}
+
+#endif
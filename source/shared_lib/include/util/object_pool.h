@@ -0,0 +1,220 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_OBJECTPOOL_H_
+#define _SHARED_UTIL_OBJECTPOOL_H_
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using std::string;
+using Shared::Platform::int64;
+
+namespace Shared {
+	namespace Util {
+
+		// =====================================================
+		//	class ObjectPoolStats
+		//
+		// Allocation counters of one pool. Pools must have static
+		// storage duration, they register themselves so their
+		// counters can be listed in the debug stats.
+		// =====================================================
+
+		class ObjectPoolStats {
+		private:
+			const char *name;
+			std::atomic<int64> heapCount;
+			std::atomic<int64> reuseCount;
+			std::atomic<int64> releaseCount;
+
+			ObjectPoolStats(const ObjectPoolStats &);
+			void operator =(const ObjectPoolStats &);
+
+		protected:
+			void countHeap() {
+				heapCount++;
+			}
+			void countReuse() {
+				reuseCount++;
+			}
+			void countRelease() {
+				releaseCount++;
+			}
+
+		public:
+			explicit ObjectPoolStats(const char *name);
+
+			const char *getName() const {
+				return name;
+			}
+			int64 getHeapCount() const {
+				return heapCount.load();
+			}
+			int64 getReuseCount() const {
+				return reuseCount.load();
+			}
+			int64 getLiveCount() const {
+				return heapCount.load() + reuseCount.load() - releaseCount.load();
+			}
+
+			static std::vector<ObjectPoolStats *> getPoolList();
+			static string getStatsText();
+		};
+
+		// =====================================================
+		//	class ObjectPool
+		//
+		// Recycles the memory of objects of type T through a small
+		// free list per thread, meant to back class operator new and
+		// delete of types that are created and destroyed constantly.
+		// Other sizes, like those of derived classes, and blocks
+		// beyond the free list go to the heap.
+		// =====================================================
+
+		template<typename T, int freeListSize = 256>
+		class ObjectPool : public ObjectPoolStats {
+		private:
+			class FreeList {
+			public:
+				void *blocks[freeListSize];
+				int count;
+
+				FreeList() : count(0) {
+				}
+				~FreeList() {
+					for (int i = 0; i < count; ++i) {
+						free(blocks[i]);
+					}
+					count = 0;
+					isFreeListEnded() = true;
+				}
+			};
+
+			// Objects deleted while the thread exits, after its free
+			// list is gone, use the heap directly
+			static bool &isFreeListEnded() {
+				static thread_local bool ended = false;
+				return ended;
+			}
+			static FreeList *getFreeList() {
+				if (isFreeListEnded() == true) {
+					return NULL;
+				}
+				static thread_local FreeList freeList;
+				return &freeList;
+			}
+
+		public:
+			explicit ObjectPool(const char *name) : ObjectPoolStats(name) {
+			}
+
+			void *allocate(size_t size) {
+				FreeList *freeList = (size == sizeof(T) ? getFreeList() : NULL);
+				if (freeList != NULL && freeList->count > 0) {
+					countReuse();
+					return freeList->blocks[--freeList->count];
+				}
+
+				void *block = malloc(size);
+				if (block == NULL) {
+					throw std::bad_alloc();
+				}
+				countHeap();
+				return block;
+			}
+
+			void release(void *block, size_t size) {
+				if (block == NULL) {
+					return;
+				}
+				countRelease();
+
+				FreeList *freeList = (size == sizeof(T) ? getFreeList() : NULL);
+				if (freeList != NULL && freeList->count < freeListSize) {
+					freeList->blocks[freeList->count++] = block;
+					return;
+				}
+				free(block);
+			}
+		};
+
+		// =====================================================
+		//	class BufferPool
+		//
+		// Recycles containers like std::vector with their capacity.
+		// acquire swaps an emptied buffer of an earlier owner into
+		// the caller's container and release takes it back, so a
+		// resize to a size used before does not allocate.
+		// =====================================================
+
+		template<typename T, int freeListSize = 64>
+		class BufferPool : public ObjectPoolStats {
+		private:
+			class FreeList {
+			public:
+				T buffers[freeListSize];
+				int count;
+
+				FreeList() : count(0) {
+				}
+				~FreeList() {
+					isFreeListEnded() = true;
+				}
+			};
+
+			static bool &isFreeListEnded() {
+				static thread_local bool ended = false;
+				return ended;
+			}
+			static FreeList *getFreeList() {
+				if (isFreeListEnded() == true) {
+					return NULL;
+				}
+				static thread_local FreeList freeList;
+				return &freeList;
+			}
+
+		public:
+			explicit BufferPool(const char *name) : ObjectPoolStats(name) {
+			}
+
+			void acquire(T &buffer) {
+				FreeList *freeList = getFreeList();
+				if (freeList != NULL && freeList->count > 0) {
+					countReuse();
+					buffer.swap(freeList->buffers[--freeList->count]);
+					return;
+				}
+				countHeap();
+			}
+
+			void release(T &buffer) {
+				countRelease();
+
+				FreeList *freeList = getFreeList();
+				if (freeList != NULL && freeList->count < freeListSize && buffer.capacity() > 0) {
+					buffer.clear();
+					buffer.swap(freeList->buffers[freeList->count++]);
+				}
+			}
+		};
+
+	}
+}//end namespace
+
+#endif
@@ -20,6 +20,17 @@
 namespace Shared {
 	namespace Util {
 
+		// Independent random streams. Generators seeded with the same value
+		// but a different stream produce unrelated sequences, so cosmetic
+		// randomness never shares numbers with simulation randomness.
+		enum RandomStream {
+			rsDefault,
+			rsSimulation,
+			rsAi,
+			rsParticles,
+			rsCosmetic
+		};
+
 		// =====================================================
 		//	class RandomGen
 		// =====================================================
@@ -31,18 +42,35 @@ namespace Shared {
 			static const int b;
 
 		private:
+			// Call sites given as string literals are tracked by pointer so
+			// desync debugging does not allocate per random number
+			class LastCallerEntry {
+			public:
+				const char *callSite;
+				std::string text;
+
+				LastCallerEntry(const char *callSite, const std::string &text) :
+					callSite(callSite), text(text) {
+				}
+			};
+
 			int lastNumber;
-			std::vector<std::string> lastCaller;
+			std::vector<LastCallerEntry> lastCaller;
 			bool disableLastCallerTracking;
 
-			int rand(std::string lastCaller);
+			int rand(const char *lastCaller);
 
 		public:
 			RandomGen();
 			void init(int seed);
+			void init(int seed, RandomStream stream);
+
+			static int getStreamSeed(int seed, RandomStream stream);
 
-			int randRange(int min, int max, std::string lastCaller = "");
-			float randRange(float min, float max, std::string lastCaller = "");
+			int randRange(int min, int max, const char *lastCaller = NULL);
+			float randRange(float min, float max, const char *lastCaller = NULL);
+			int randRange(int min, int max, const std::string &lastCaller);
+			float randRange(float min, float max, const std::string &lastCaller);
 
 			int getLastNumber() const {
 				return lastNumber;
@@ -53,10 +81,14 @@ namespace Shared {
 
 			std::string getLastCaller() const;
 			void clearLastCaller();
-			void addLastCaller(std::string text);
+			void addLastCaller(const char *callSite);
+			void addLastCaller(const std::string &text);
 			void setDisableLastCallerTracking(bool value) {
 				disableLastCallerTracking = value;
 			}
+			bool getDisableLastCallerTracking() const {
+				return disableLastCallerTracking;
+			}
 		};
 
 	}
@@ -0,0 +1,78 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_TRIPLEBUFFER_H_
+#define _SHARED_UTIL_TRIPLEBUFFER_H_
+
+#include <atomic>
+#include "leak_dumper.h"
+
+namespace Shared {
+	namespace Util {
+
+		// =====================================================
+		//	class TripleBuffer
+		//
+		// Hands values from one writer thread to one reader thread
+		// without locks. The writer fills the write buffer and
+		// publishes it, the reader picks up the latest published
+		// buffer and keeps reading it until it asks for a newer one.
+		// Neither side ever waits for the other, values published
+		// while the reader is busy replace each other.
+		// =====================================================
+
+		template<typename T>
+		class TripleBuffer {
+		private:
+			// Index of the spare buffer, with freshBit set while it
+			// holds a value the reader has not picked up yet
+			static const int freshBit = 4;
+
+			T buffers[3];
+			std::atomic<int> spare;
+			int writeIndex;
+			int readIndex;
+
+			TripleBuffer(const TripleBuffer &);
+			void operator =(const TripleBuffer &);
+
+		public:
+			TripleBuffer() : spare(1), writeIndex(0), readIndex(2) {
+			}
+
+			T &getWriteBuffer() {
+				return buffers[writeIndex];
+			}
+			void publish() {
+				writeIndex = spare.exchange(writeIndex | freshBit) & ~freshBit;
+			}
+
+			bool hasUpdate() const {
+				return (spare.load() & freshBit) != 0;
+			}
+			// Switches to the latest published buffer, returns false
+			// if nothing was published since the last call
+			bool update() {
+				if (hasUpdate() == false) {
+					return false;
+				}
+				readIndex = spare.exchange(readIndex) & ~freshBit;
+				return true;
+			}
+			const T &getReadBuffer() const {
+				return buffers[readIndex];
+			}
+		};
+
+	}
+}//end namespace
+
+#endif
@@ -1,4 +1,4 @@
-#define GAME_VERSION "0.8.02"
+#define GAME_VERSION "0.8.04"
 #define LAST_COMPATIBLE_VERSION "0.8.01"
 #define G3D_VIEWER_VERSION "1.0.00"
 #define MAP_EDITOR_VERSION "1.0.00"
@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_set>
 
 #if defined(WANT_XERCES)
 
@@ -65,6 +66,7 @@ namespace Shared {
 		class XmlTree;
 		class XmlNode;
 		class XmlAttribute;
+		class XmlArena;
 
 #if defined(WANT_XERCES)
 		// =====================================================
@@ -125,7 +127,9 @@ namespace Shared {
 			static bool isInitialized();
 			void cleanup();
 
-			XmlNode *load(const string &path, const std::map<string, string> &mapTagReplacementValues, bool noValidation = false, bool skipStackTrace = false, bool skipUpdatePathClimbingParts = false);
+			XmlNode *load(const string &path, const std::map<string, string> &mapTagReplacementValues, bool noValidation = false, bool skipStackTrace = false, bool skipUpdatePathClimbingParts = false, vector<char> *image = NULL);
+			// Takes over the image, the caller's vector is left empty
+			XmlNode *loadImage(vector<char> &image, const std::map<string, string> &mapTagReplacementValues, bool skipUpdatePathClimbingParts = false);
 			void save(const string &path, const XmlNode *node);
 		};
 
@@ -165,18 +169,37 @@ namespace Shared {
 
 		class XmlNode {
 		private:
-			string name;
+			friend class XmlIoRapid;
+			friend class XmlArena;
+
+			const string *name;
+			string nameStorage;
 			string text;
 			vector<XmlNode*> children;
 			vector<XmlAttribute*> attributes;
 			mutable const XmlNode* superNode;
+			XmlArena *arena;
+			bool ownsArena;
+			bool inArena;
 
 		private:
 			XmlNode(XmlNode&);
 			void operator =(XmlNode&);
 
+			XmlNode(xml_node<> *node, XmlArena *arena, bool ownsArena);
+			XmlNode(const char *&image, const char *imageEnd, XmlArena *arena, bool ownsArena);
+			void init(xml_node<> *node);
+			void initFromImage(const char *&image, const char *imageEnd);
+			void setText(const char *value);
+			static void writeImage(xml_node<> *node, vector<char> &image);
+
 			string getTreeString() const;
 			bool hasChildNoSuper(const string& childName) const;
+			const string *findName(const string &name) const;
+			bool isNamed(const string *name, const string &nameValue) const {
+				// Names interned in the arena compare by pointer
+				return (arena != NULL ? this->name == name : *this->name == nameValue);
+			}
 
 		public:
 
@@ -196,7 +219,7 @@ namespace Shared {
 			}
 
 			const string &getName() const {
-				return name;
+				return *name;
 			}
 			size_t getChildCount() const {
 				return children.size();
@@ -233,16 +256,28 @@ namespace Shared {
 
 		class XmlAttribute {
 		private:
+			friend class XmlNode;
+			friend class XmlArena;
+
+			const string *name;
+			string nameStorage;
+			// Points into the arena buffer unless tags were replaced
+			const char *rawValue;
 			string value;
-			string name;
 			bool skipRestrictionCheck;
 			bool usesCommondata;
-			std::map<string, string> mapTagReplacementValues;
+			bool inArena;
 
 		private:
 			XmlAttribute(XmlAttribute&);
 			void operator =(XmlAttribute&);
 
+			XmlAttribute(const char *name, const char *value, XmlArena *arena);
+			void setValueWithTags(const string &value, const std::map<string, string> *mapTagReplacementValues, bool skipUpdatePathClimbingParts);
+			string getValueString() const {
+				return (rawValue != NULL ? string(rawValue) : value);
+			}
+
 		public:
 
 #if defined(WANT_XERCES)
@@ -255,8 +290,8 @@ namespace Shared {
 			XmlAttribute(const string &name, const string &value, const std::map<string, string> &mapTagReplacementValues);
 
 		public:
-			const string getName() const {
-				return name;
+			const string &getName() const {
+				return *name;
 			}
 			const string getValue(string prefixValue = "", bool trimValueWithStartingSlash = false) const;
 
@@ -271,6 +306,60 @@ namespace Shared {
 			void setValue(string val);
 		};
 
+		// =====================================================
+		//	class XmlArena
+		//
+		//	Storage shared by all nodes of a loaded document: the
+		//	parsed file buffer that attribute values point into,
+		//	blocks the nodes are allocated from and the interned
+		//	element and attribute names.
+		// =====================================================
+
+		class XmlArena {
+		private:
+			static const size_t blockSize = 32 * 1024;
+
+			vector<char> buffer;
+			vector<char *> blocks;
+			size_t blockUsed;
+			vector<XmlNode *> nodes;
+			vector<XmlAttribute *> attributes;
+			std::unordered_set<string> names;
+			std::map<string, string> mapTagReplacementValues;
+			string tagStartCharacters;
+			bool skipUpdatePathClimbingParts;
+
+			XmlArena(XmlArena&);
+			void operator =(XmlArena&);
+
+			void *allocate(size_t size);
+
+		public:
+			XmlArena(const std::map<string, string> &mapTagReplacementValues, bool skipUpdatePathClimbingParts);
+			~XmlArena();
+
+			vector<char> &getBuffer() {
+				return buffer;
+			}
+			bool ownsStrings() const {
+				return buffer.empty() == false;
+			}
+			const std::map<string, string> &getTagReplacementValues() const {
+				return mapTagReplacementValues;
+			}
+			bool getSkipUpdatePathClimbingParts() const {
+				return skipUpdatePathClimbingParts;
+			}
+
+			const string *internName(const string &name);
+			const string *findName(const string &name) const;
+			bool mayContainTags(const char *value) const;
+
+			XmlNode *newNode(xml_node<> *node);
+			XmlNode *newNode(const char *&image, const char *imageEnd);
+			XmlAttribute *newAttribute(const char *name, const char *value);
+		};
+
 
 	}
 }//end namespace
@@ -0,0 +1,89 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_XML_XMLTREECACHE_H_
+#define _SHARED_XML_XMLTREECACHE_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using Shared::Platform::uint32;
+
+namespace Shared {
+	namespace Xml {
+
+		class XmlNode;
+
+		// =====================================================
+		//	class XmlTreeCache
+		//
+		//	Parsed images of the XML files below one folder, like
+		//	a techtree or tileset. While a cache exists XmlTree
+		//	loads files of its folder from the images and adds
+		//	the files it had to parse. The images are saved to a
+		//	cache file and only reused while the content checksum
+		//	of the folder stays the same. The folder checksum may
+		//	come from the CRC cache, so each image is also checked
+		//	against the size and time of its file.
+		// =====================================================
+
+		class XmlTreeCache {
+		private:
+			class Entry {
+			public:
+				uint32 fileSize;
+				uint32 fileTime;
+				vector<char> image;
+			};
+			typedef std::map<string, Entry> EntryMap;
+
+			static const uint32 formatVersion = 2;
+
+			string rootPath;
+			string cacheFile;
+			uint32 contentChecksum;
+			EntryMap entries;
+			bool changed;
+
+			XmlTreeCache(XmlTreeCache&);
+			void operator =(XmlTreeCache&);
+
+			static XmlTreeCache *findCache(const string &path);
+			bool readFile();
+			void writeFile();
+
+		public:
+			XmlTreeCache(const string &rootPath, uint32 contentChecksum, const string &cacheFile);
+			~XmlTreeCache();
+
+			static string getCacheFileName(const string &rootPath);
+
+			static bool coversPath(const string &path);
+			static XmlNode *loadTree(const string &path, const std::map<string, string> &mapTagReplacementValues, bool skipUpdatePathClimbingParts);
+			// Takes over the image, the caller's vector is left empty
+			static void storeTree(const string &path, vector<char> &image);
+
+			int getEntryCount() const {
+				return (int) entries.size();
+			}
+			bool isChanged() const {
+				return changed;
+			}
+		};
+
+	}
+}//end namespace
+
+#endif
@@ -64,6 +64,8 @@ namespace Shared {
 
 		int Font::faceResolution = 72;
 		string Font::langHeightText = "yW";
+
+		int FontMetrics::textCacheMaxEntries = 1024;
 		//
 
 		void Font::resetToDefaults() {
@@ -116,6 +118,7 @@ namespace Shared {
 
 		void FontMetrics::setTextHandler(Text *textHandler) {
 			this->textHandler = textHandler;
+			clearTextCache();
 			//SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] this->textHandler = [%p] Owner = [%p]\n", __FILE__, __FUNCTION__, __LINE__, this->textHandler, this);
 		}
 
@@ -123,31 +126,61 @@ namespace Shared {
 			return this->textHandler;
 		}
 
+		void FontMetrics::clearTextCache() {
+			textWidthCache.clear();
+			textWidthCacheLookup.clear();
+			wordWrapCache.clear();
+			wordWrapCacheLookup.clear();
+		}
+
 		float FontMetrics::getTextWidth(const string &str) {
-			string longestLine = "";
-			size_t found = str.find("\n");
-			if (found == string::npos) {
-				longestLine = str;
-			} else {
-				vector<string> lineTokens;
-				Tokenize(str, lineTokens, "\n");
-				if (lineTokens.empty() == false) {
-					for (unsigned int i = 0; i < lineTokens.size(); ++i) {
-						string currentStr = lineTokens[i];
-						if (currentStr.length() > longestLine.length()) {
-							longestLine = currentStr;
-						}
-					}
+			TextWidthCacheLookup::iterator iterFind = textWidthCacheLookup.find(str);
+			if (iterFind != textWidthCacheLookup.end()) {
+				// Move the hit to the front so it is evicted last
+				textWidthCache.splice(textWidthCache.begin(), textWidthCache, iterFind->second);
+				return iterFind->second->second;
+			}
+
+			float width = computeTextWidth(str);
+			if (textCacheMaxEntries > 0) {
+				textWidthCache.push_front(std::make_pair(str, width));
+				textWidthCacheLookup[str] = textWidthCache.begin();
+				if ((int) textWidthCache.size() > textCacheMaxEntries) {
+					textWidthCacheLookup.erase(textWidthCache.back().first);
+					textWidthCache.pop_back();
 				}
 			}
+			return width;
+		}
+
+		float FontMetrics::computeTextWidth(const string &str) const {
+			// Find the longest line without copying every line out of the string
+			size_t longestLineStart = 0;
+			size_t longestLineLength = 0;
+			for (size_t lineStart = 0; lineStart <= str.length();) {
+				size_t lineEnd = str.find('\n', lineStart);
+				if (lineEnd == string::npos) {
+					lineEnd = str.length();
+				}
+				if (lineEnd - lineStart > longestLineLength) {
+					longestLineStart = lineStart;
+					longestLineLength = lineEnd - lineStart;
+				}
+				lineStart = lineEnd + 1;
+			}
 
 			if (textHandler != NULL) {
+				if (longestLineLength == str.length()) {
+					return (textHandler->Advance(str.c_str()) * Font::scaleFontValue);
+				}
+				string longestLine = str.substr(longestLineStart, longestLineLength);
 				return (textHandler->Advance(longestLine.c_str()) * Font::scaleFontValue);
 			} else {
+				const char *longestLine = str.c_str() + longestLineStart;
 				float width = 0.f;
-				for (unsigned int i = 0; i < longestLine.size() && (int) i < Font::charCount; ++i) {
+				for (unsigned int i = 0; i < longestLineLength && (int) i < Font::charCount; ++i) {
 					if (longestLine[i] >= Font::charCount) {
-						string sError = "str[i] >= Font::charCount, [" + longestLine + "] i = " + uIntToStr(i);
+						string sError = "str[i] >= Font::charCount, [" + str.substr(longestLineStart, longestLineLength) + "] i = " + uIntToStr(i);
 						throw megaglest_runtime_error(sError);
 					}
 					//Treat 2 byte characters as spaces
@@ -169,8 +202,16 @@ namespace Shared {
 			}
 		}
 
-		string FontMetrics::wordWrapText(string text, int maxWidth) {
+		string FontMetrics::wordWrapText(const string &sourceText, int maxWidth) {
+			WordWrapCacheKey cacheKey(sourceText, maxWidth);
+			WordWrapCacheLookup::iterator iterFind = wordWrapCacheLookup.find(cacheKey);
+			if (iterFind != wordWrapCacheLookup.end()) {
+				wordWrapCache.splice(wordWrapCache.begin(), wordWrapCache, iterFind->second);
+				return iterFind->second->second;
+			}
+
 			// Strip newlines from source
+			string text = sourceText;
 			replaceAll(text, "\n", " \n ");
 
 			// Get all words (space separated text)
@@ -181,7 +222,7 @@ namespace Shared {
 			float lineWidth = 0.0f;
 
 			for (unsigned int i = 0; i < words.size(); ++i) {
-				string word = words[i];
+				const string &word = words[i];
 				if (word == "\n") {
 					wrappedText += word;
 					lineWidth = 0;
@@ -196,6 +237,14 @@ namespace Shared {
 				}
 			}
 
+			if (textCacheMaxEntries > 0) {
+				wordWrapCache.push_front(std::make_pair(cacheKey, wrappedText));
+				wordWrapCacheLookup[cacheKey] = wordWrapCache.begin();
+				if ((int) wordWrapCache.size() > textCacheMaxEntries) {
+					wordWrapCacheLookup.erase(wordWrapCache.back().first);
+					wordWrapCache.pop_back();
+				}
+			}
 			return wrappedText;
 		}
 
@@ -289,6 +338,7 @@ namespace Shared {
 			}
 		}
 		void Font::setSize(int size) {
+			metrics.clearTextCache();
 			if (textHandler) {
 				return textHandler->SetFaceSize(size);
 			} else {
@@ -247,6 +247,37 @@ namespace Shared {
 				assertGl();
 			}
 
+			void ModelRendererGl::renderInstances(Model *model, const ModelInstance *instances, int instanceCount, ModelInstanceCallback *instanceCallback) {
+				//assertions
+				assert(rendering);
+				assertGl();
+
+				// Mesh state and arrays are set once, each instance only
+				// changes the matrix and color before drawing
+				for (uint32 i = 0; i < model->getMeshCount(); ++i) {
+					Mesh *mesh = model->getMeshPtr(i);
+					if (beginMesh(mesh, rmNormal, 1.0f) == false) {
+						continue;
+					}
+					for (int instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex) {
+						const ModelInstance &instance = instances[instanceIndex];
+						glColor4fv(instance.color.ptr());
+						if (instanceCallback != NULL) {
+							instanceCallback->execute(instance);
+						}
+
+						glPushMatrix();
+						glMultMatrixf(instance.transform);
+						drawMesh(mesh);
+						glPopMatrix();
+					}
+					endMesh(mesh, rmNormal);
+				}
+
+				//assertions
+				assertGl();
+			}
+
 			void ModelRendererGl::renderNormalsOnly(Model *model) {
 				//assertions
 				assert(rendering);
@@ -266,9 +297,16 @@ namespace Shared {
 			// ===================== PRIVATE =======================
 
 			void ModelRendererGl::renderMesh(Mesh *mesh, int renderMode, float alpha) {
+				if (beginMesh(mesh, renderMode, alpha) == true) {
+					drawMesh(mesh);
+					endMesh(mesh, renderMode);
+				}
+			}
+
+			bool ModelRendererGl::beginMesh(Mesh *mesh, int renderMode, float alpha) {
 
 				if (renderMode == rmSelection && mesh->getNoSelect() == true) {// don't render this and do nothing
-					return;
+					return false;
 				}
 				//assertions
 				assertGl();
@@ -320,10 +358,6 @@ namespace Shared {
 					}
 				}
 
-				//misc vars
-				uint32 vertexCount = mesh->getVertexCount();
-				uint32 indexCount = mesh->getIndexCount();
-
 				//assertions
 				assertGl();
 
@@ -411,6 +445,13 @@ namespace Shared {
 						glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 					}
 				}
+				return true;
+			}
+
+			void ModelRendererGl::drawMesh(Mesh *mesh) {
+				//misc vars
+				uint32 vertexCount = mesh->getVertexCount();
+				uint32 indexCount = mesh->getIndexCount();
 
 				if (getVBOSupported() == true && mesh->getFrameCount() == 1) {
 					assertGl();
@@ -418,7 +459,6 @@ namespace Shared {
 					glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, mesh->getVBOIndexes());
 					glDrawRangeElements(GL_TRIANGLES, 0, vertexCount - 1, indexCount, GL_UNSIGNED_INT, (char *) NULL);
 					glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
-					glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
 
 					//glDrawRangeElements(GL_TRIANGLES, 0, vertexCount-1, indexCount, GL_UNSIGNED_INT, mesh->getIndices());
 
@@ -429,6 +469,12 @@ namespace Shared {
 
 					glDrawRangeElements(GL_TRIANGLES, 0, vertexCount - 1, indexCount, GL_UNSIGNED_INT, mesh->getIndices());
 				}
+			}
+
+			void ModelRendererGl::endMesh(Mesh *mesh, int renderMode) {
+				if (getVBOSupported() == true && mesh->getFrameCount() == 1) {
+					glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+				}
 				// glow
 				if (renderMode == rmNormal && mesh->getGlow() == true) {
 					// glow off
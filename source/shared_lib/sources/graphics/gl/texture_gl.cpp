@@ -763,6 +763,9 @@ namespace Shared {
 				assertGl();
 
 				if (inited == false) {
+					if (pixmapInit == true) {
+						ensurePixels();
+					}
 					assertGl();
 					//params
 					GLint wrap = toWrapModeGl(wrapMode);
@@ -818,6 +821,8 @@ namespace Shared {
 							if (SystemFlags::VERBOSE_MODE_ENABLED) printf("\n\n\n**WARNING** Enabling ATI video card hacks, resizing texture to power of two [%d x %d] to [%d x %d] components [%d] path [%s]\n", pixmap.getW(), pixmap.getH(), next_power_of_2(pixmap.getW()), next_power_of_2(pixmap.getH()), pixmap.getComponents(), pixmap.getPath().c_str());
 
 							pixmap.Scale(glFormat, next_power_of_2(pixmap.getW()), next_power_of_2(pixmap.getH()));
+							// The file no longer matches what was uploaded
+							clearFileBacked();
 						}
 
 						glTexImage2D(GL_TEXTURE_2D, 0, glCompressionFormat,
@@ -879,6 +884,8 @@ namespace Shared {
 							if (SystemFlags::VERBOSE_MODE_ENABLED) printf("\n\n\n**WARNING** Enabling ATI video card hacks, resizing texture to power of two [%d x %d] to [%d x %d] components [%d] path [%s]\n", pixmap.getW(), pixmap.getH(), next_power_of_2(pixmap.getW()), next_power_of_2(pixmap.getH()), pixmap.getComponents(), pixmap.getPath().c_str());
 
 							pixmap.Scale(glFormat, next_power_of_2(pixmap.getW()), next_power_of_2(pixmap.getH()));
+							// The file no longer matches what was uploaded
+							clearFileBacked();
 						}
 
 						glTexImage2D(GL_TEXTURE_2D, 0, glCompressionFormat, pixmap.getW(),
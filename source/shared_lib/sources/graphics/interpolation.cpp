@@ -32,6 +32,20 @@ namespace Shared {
 		// =====================================================
 
 		bool InterpolationData::enableInterpolation = true;
+		int InterpolationData::poseQuantizationSteps = 16;
+		int InterpolationData::poseCacheSize = 4;
+
+		InterpolationData::PoseCacheEntry::PoseCacheEntry() {
+			prevFrame = 0;
+			nextFrame = 0;
+			localT = 0;
+			cycle = false;
+			verticesValid = false;
+			normalsValid = false;
+			lastUsed = 0;
+			vertices = NULL;
+			normals = NULL;
+		}
 
 		InterpolationData::InterpolationData(const Mesh *mesh) {
 			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
@@ -42,31 +56,76 @@ namespace Shared {
 			normals = NULL;
 
 			raw_frame_ofs = 0;
+			poseCacheUseCounter = 0;
 
 			this->mesh = mesh;
 		}
 
 		InterpolationData::~InterpolationData() {
-			delete[] vertices;
+			// vertices and normals point into the pose cache
+			for (unsigned int i = 0; i < poseCache.size(); ++i) {
+				delete[] poseCache[i].vertices;
+				delete[] poseCache[i].normals;
+			}
+			poseCache.clear();
 			vertices = NULL;
-			delete[] normals;
 			normals = NULL;
 		}
 
 		void InterpolationData::update(float t, bool cycle) {
-			updateVertices(t, cycle);
-			updateNormals(t, cycle);
+			update(t, cycle, true, true);
 		}
 
 		void InterpolationData::updateVertices(float t, bool cycle) {
-			update(mesh->getVertices(), vertices, t, cycle);
+			update(t, cycle, true, false);
 		}
 
 		void InterpolationData::updateNormals(float t, bool cycle) {
-			update(mesh->getNormals(), normals, t, cycle);
+			update(t, cycle, false, true);
 		}
 
-		void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cycle) {
+		void InterpolationData::lerpFrames(const Vec3f *prev, const Vec3f *next, Vec3f *dest, uint32 count, float t) {
+			// Plain float loop without branches so the compiler can vectorize it
+			const float *prevData = prev->ptr();
+			const float *nextData = next->ptr();
+			float *destData = dest->ptr();
+			uint32 floatCount = count * 3;
+			for (uint32 i = 0; i < floatCount; ++i) {
+				destData[i] = prevData[i] + (nextData[i] - prevData[i]) * t;
+			}
+		}
+
+		InterpolationData::PoseCacheEntry *InterpolationData::findPose(uint32 prevFrame, uint32 nextFrame, float localT, bool cycle) {
+			poseCacheUseCounter++;
+
+			PoseCacheEntry *leastRecentPose = NULL;
+			for (unsigned int i = 0; i < poseCache.size(); ++i) {
+				PoseCacheEntry &pose = poseCache[i];
+				if (pose.prevFrame == prevFrame && pose.nextFrame == nextFrame &&
+					pose.localT == localT && pose.cycle == cycle) {
+					pose.lastUsed = poseCacheUseCounter;
+					return &pose;
+				}
+				if (leastRecentPose == NULL || pose.lastUsed < leastRecentPose->lastUsed) {
+					leastRecentPose = &pose;
+				}
+			}
+
+			if ((int) poseCache.size() < max(poseCacheSize, 1)) {
+				poseCache.push_back(PoseCacheEntry());
+				leastRecentPose = &poseCache.back();
+			}
+			leastRecentPose->prevFrame = prevFrame;
+			leastRecentPose->nextFrame = nextFrame;
+			leastRecentPose->localT = localT;
+			leastRecentPose->cycle = cycle;
+			leastRecentPose->verticesValid = false;
+			leastRecentPose->normalsValid = false;
+			leastRecentPose->lastUsed = poseCacheUseCounter;
+			return leastRecentPose;
+		}
+
+		void InterpolationData::update(float t, bool cycle, bool updateVertices, bool updateNormals) {
 
 			if (t <0.0f || t>1.0f) {
 				printf("ERROR t = [%f] for cycle [%d] f [%d] v [%d]\n", t, cycle, mesh->getFrameCount(), mesh->getVertexCount());
@@ -106,11 +165,32 @@ namespace Shared {
 				assert(nextFrame < frameCount);
 
 				if (enableInterpolation) {
-					if (!dest) { // not previously allocated
-						dest = new Vec3f[vertexCount];
+					// Round the phase so units at nearly the same point of the
+					// animation share one pose
+					if (poseQuantizationSteps > 0) {
+						localT = static_cast<int>(localT * poseQuantizationSteps + 0.5f) / static_cast<float>(poseQuantizationSteps);
+					}
+
+					PoseCacheEntry *pose = findPose(prevFrame, nextFrame, localT, cycle);
+					if (updateVertices == true) {
+						if (pose->verticesValid == false) {
+							if (!pose->vertices) { // not previously allocated
+								pose->vertices = new Vec3f[vertexCount];
+							}
+							lerpFrames(&mesh->getVertices()[prevFrameBase], &mesh->getVertices()[nextFrameBase], pose->vertices, vertexCount, localT);
+							pose->verticesValid = true;
+						}
+						vertices = pose->vertices;
 					}
-					for (uint32 j = 0; j < vertexCount; ++j) {
-						dest[j] = src[prevFrameBase + j].lerp(localT, src[nextFrameBase + j]);
+					if (updateNormals == true) {
+						if (pose->normalsValid == false) {
+							if (!pose->normals) { // not previously allocated
+								pose->normals = new Vec3f[vertexCount];
+							}
+							lerpFrames(&mesh->getNormals()[prevFrameBase], &mesh->getNormals()[nextFrameBase], pose->normals, vertexCount, localT);
+							pose->normalsValid = true;
+						}
+						normals = pose->normals;
 					}
 				} else {
 					raw_frame_ofs = prevFrameBase;
@@ -21,6 +21,7 @@
 #include "platform_common.h"
 #include "opengl.h"
 #include "platform_util.h"
+#include "residency_manager.h"
 //#include <memory>
 #include <map>
 #include <vector>
@@ -242,6 +243,23 @@ namespace Shared {
 			end();
 		}
 
+		std::size_t Mesh::getDataByteCount() const {
+			std::size_t byteCount = 0;
+			if (vertices != NULL) {
+				byteCount += sizeof(Vec3f) * frameCount * vertexCount;
+			}
+			if (normals != NULL) {
+				byteCount += sizeof(Vec3f) * frameCount * vertexCount;
+			}
+			if (texCoords != NULL) {
+				byteCount += sizeof(Vec2f) * vertexCount;
+			}
+			if (indices != NULL) {
+				byteCount += sizeof(uint32) * indexCount;
+			}
+			return byteCount;
+		}
+
 		void Mesh::init() {
 			try {
 				vertices = new Vec3f[frameCount*vertexCount];
@@ -1079,9 +1097,11 @@ namespace Shared {
 			lastCycleData = false;
 			lastTVertex = -1;
 			lastCycleVertex = false;
+			ResidencyManager::registerModel(this);
 		}
 
 		Model::~Model() {
+			ResidencyManager::unregisterModel(this);
 			if (meshes) delete[] meshes;
 			meshes = NULL;
 		}
@@ -1124,6 +1144,17 @@ namespace Shared {
 			return triangleCount;
 		}
 
+		// Mesh arrays only, textures are counted on their own
+		std::size_t Model::getDataByteCount() const {
+			std::size_t byteCount = 0;
+			if (meshes != NULL) {
+				for (uint32 i = 0; i < meshCount; ++i) {
+					byteCount += meshes[i].getDataByteCount();
+				}
+			}
+			return byteCount;
+		}
+
 		uint32 Model::getVertexCount() const {
 			uint32 vertexCount = 0;
 			for (uint32 i = 0; i < meshCount; ++i) {
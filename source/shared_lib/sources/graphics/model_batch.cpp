@@ -0,0 +1,136 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "model_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include "model.h"
+#include "math_util.h"
+#include "leak_dumper.h"
+
+using namespace std;
+
+namespace Shared {
+	namespace Graphics {
+
+		// =====================================================
+		//	class ModelInstance
+		// =====================================================
+
+		ModelInstance::ModelInstance() : color(1.f, 1.f, 1.f, 1.f) {
+			animProgress = 0.f;
+			setTransform(Vec3f(0.f), 0.f);
+		}
+
+		// Same matrix as glTranslatef followed by glRotatef around the y axis
+		void ModelInstance::setTransform(const Vec3f &position, float rotationDegrees) {
+			float radians = degToRad(rotationDegrees);
+			float cosAngle = std::cos(radians);
+			float sinAngle = std::sin(radians);
+
+			transform[0] = cosAngle;
+			transform[1] = 0.f;
+			transform[2] = -sinAngle;
+			transform[3] = 0.f;
+
+			transform[4] = 0.f;
+			transform[5] = 1.f;
+			transform[6] = 0.f;
+			transform[7] = 0.f;
+
+			transform[8] = sinAngle;
+			transform[9] = 0.f;
+			transform[10] = cosAngle;
+			transform[11] = 0.f;
+
+			transform[12] = position.x;
+			transform[13] = position.y;
+			transform[14] = position.z;
+			transform[15] = 1.f;
+		}
+
+		// =====================================================
+		//	class ModelBatchList
+		// =====================================================
+
+		bool ModelBatchList::Entry::operator<(const Entry &other) const {
+			if (texture != other.texture) {
+				return texture < other.texture;
+			}
+			if (model != other.model) {
+				return model < other.model;
+			}
+			if (animProgress != other.animProgress) {
+				return animProgress < other.animProgress;
+			}
+			return instanceIndex < other.instanceIndex;
+		}
+
+		void ModelBatchList::clear() {
+			entries.clear();
+			addedInstances.clear();
+			instances.clear();
+			batches.clear();
+		}
+
+		void ModelBatchList::add(Model *model, const ModelInstance &instance) {
+			add(model, getModelTexture(model), instance);
+		}
+
+		void ModelBatchList::add(Model *model, const Texture *texture, const ModelInstance &instance) {
+			Entry entry;
+			entry.texture = texture;
+			entry.model = model;
+			entry.animProgress = instance.animProgress;
+			entry.instanceIndex = (int) addedInstances.size();
+
+			entries.push_back(entry);
+			addedInstances.push_back(instance);
+		}
+
+		void ModelBatchList::build() {
+			std::sort(entries.begin(), entries.end());
+
+			instances.clear();
+			batches.clear();
+			instances.reserve(entries.size());
+
+			for (unsigned int index = 0; index < entries.size(); ++index) {
+				const Entry &entry = entries[index];
+				if (batches.empty() == true ||
+					batches.back().model != entry.model ||
+					batches.back().animProgress != entry.animProgress) {
+
+					ModelBatch batch;
+					batch.model = entry.model;
+					batch.animProgress = entry.animProgress;
+					batch.firstInstance = (int) instances.size();
+					batch.instanceCount = 0;
+					batches.push_back(batch);
+				}
+				instances.push_back(addedInstances[entry.instanceIndex]);
+				batches.back().instanceCount++;
+			}
+
+			entries.clear();
+			addedInstances.clear();
+		}
+
+		const Texture *ModelBatchList::getModelTexture(const Model *model) {
+			if (model == NULL || model->getMeshCount() == 0) {
+				return NULL;
+			}
+			return model->getMesh(0)->getTexture(0);
+		}
+
+	}
+}//end namespace
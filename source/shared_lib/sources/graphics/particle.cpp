@@ -40,6 +40,13 @@ namespace Shared {
 		const bool checkMemory = false;
 		static map<void *, int> memoryObjectList;
 
+		// Every attack and effect creates a few particle systems, their
+		// particle vectors and objects are recycled instead of freed
+		static BufferPool<std::vector<Particle> > particleBufferPool("Particle buffer");
+		static ObjectPool<UnitParticleSystem> unitParticleSystemPool("UnitParticleSystem");
+		static ObjectPool<ProjectileParticleSystem> projectileParticleSystemPool("ProjectileParticleSystem");
+		static ObjectPool<SplashParticleSystem> splashParticleSystemPool("SplashParticleSystem");
+
 		void Particle::saveGame(XmlNode *rootNode) {
 			std::map<string, string> mapTagReplacements;
 			XmlNode *particleNode = rootNode->addChild("Particle");
@@ -102,6 +109,7 @@ namespace Shared {
 			//init particle vector
 			blendMode = bmOne;
 			//particles= new Particle[particleCount];
+			particleBufferPool.acquire(particles);
 			particles.clear();
 			//particles.reserve(particleCount);
 			particles.resize(particleCount);
@@ -135,7 +143,10 @@ namespace Shared {
 			particleSystemStartDelay = 0;
 
 			this->particleOwner = NULL;
+			this->particleManager = NULL;
 			this->particleSize = 0.0f;
+
+			random.init(0, rsParticles);
 		}
 
 		ParticleSystem::~ParticleSystem() {
@@ -146,12 +157,19 @@ namespace Shared {
 			}
 
 			//delete [] particles;
-			particles.clear();
+			particleBufferPool.release(particles);
 
 			delete particleObserver;
 			particleObserver = NULL;
 		}
 
+		void ParticleSystem::setParticleOwner(ParticleOwner *particleOwner) {
+			if (this->particleManager != NULL && this->particleOwner != particleOwner) {
+				this->particleManager->changeParticleOwner(this, this->particleOwner, particleOwner);
+			}
+			this->particleOwner = particleOwner;
+		}
+
 		void ParticleSystem::callParticleOwnerEnd(ParticleSystem *particleSystem) {
 			if (this->particleOwner != NULL) {
 				this->particleOwner->end(particleSystem);
@@ -1058,6 +1076,16 @@ namespace Shared {
 			}
 		}
 
+#ifndef SL_LEAK_DUMP
+		void *UnitParticleSystem::operator new(size_t size) {
+			return unitParticleSystemPool.allocate(size);
+		}
+
+		void UnitParticleSystem::operator delete(void *ptr, size_t size) {
+			unitParticleSystemPool.release(ptr, size);
+		}
+#endif
+
 		bool UnitParticleSystem::getVisible() const {
 			if ((isNight == true) && (isVisibleAtNight == true)) {
 				return visible;
@@ -1771,6 +1799,16 @@ namespace Shared {
 			}
 		}
 
+#ifndef SL_LEAK_DUMP
+		void *ProjectileParticleSystem::operator new(size_t size) {
+			return projectileParticleSystemPool.allocate(size);
+		}
+
+		void ProjectileParticleSystem::operator delete(void *ptr, size_t size) {
+			projectileParticleSystemPool.release(ptr, size);
+		}
+#endif
+
 		void ProjectileParticleSystem::link(SplashParticleSystem *particleSystem) {
 			nextParticleSystem = particleSystem;
 			nextParticleSystem->setVisible(false);
@@ -2188,6 +2226,16 @@ namespace Shared {
 			}
 		}
 
+#ifndef SL_LEAK_DUMP
+		void *SplashParticleSystem::operator new(size_t size) {
+			return splashParticleSystemPool.allocate(size);
+		}
+
+		void SplashParticleSystem::operator delete(void *ptr, size_t size) {
+			splashParticleSystemPool.release(ptr, size);
+		}
+#endif
+
 		void SplashParticleSystem::initParticleSystem() {
 			startEmissionRate = emissionRate;
 		}
@@ -2356,7 +2404,7 @@ namespace Shared {
 		//  ParticleManager
 		// ===========================================================================
 
-		ParticleManager::ParticleManager() {
+		ParticleManager::ParticleManager() : emptySlotCount(0), updating(false) {
 		}
 
 		ParticleManager::~ParticleManager() {
@@ -2411,6 +2459,8 @@ namespace Shared {
 			size_t particleSystemCount = particleSystems.size();
 			int currentParticleCount = 0;
 
+			// Systems removed while updating keep their slot until the loop is done
+			updating = true;
 			vector<ParticleSystem *> cleanupParticleSystemsList;
 			for (unsigned int i = 0; i < particleSystems.size(); i++) {
 				ParticleSystem *ps = particleSystems[i];
@@ -2430,68 +2480,100 @@ namespace Shared {
 					}
 				}
 			}
-			//particleSystems.remove(NULL);
+			updating = false;
 			cleanupParticleSystems(cleanupParticleSystemsList);
+			compact();
 
 			if (SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0)
 				SystemFlags::OutputDebug(SystemFlags::debugPerformance, "In [%s::%s] Line: %d took msecs: %lld, particleSystemCount = %d, currentParticleCount = %d\n", __FILE__, __FUNCTION__, __LINE__, chrono.getMillis(), particleSystemCount, currentParticleCount);
 		}
 
 		bool ParticleManager::validateParticleSystemStillExists(ParticleSystem * particleSystem) const {
-			int index = findParticleSystems(particleSystem, this->particleSystems);
-			return (index >= 0);
+			// Only the address is looked up, the system may be deleted already
+			return particleSystemSlots.find(particleSystem) != particleSystemSlots.end();
 		}
 
 		void ParticleManager::removeParticleSystemsForParticleOwner(ParticleOwner *particleOwner) {
-			if (particleOwner != NULL && particleSystems.empty() == false) {
-				vector<ParticleSystem *> cleanupParticleSystemsList;
-
-				for (unsigned int index = 0; index < particleSystems.size(); ++index) {
-					ParticleSystem *ps = particleSystems[index];
-					if (ps != NULL && ps->getParticleOwner() == particleOwner) {
-						cleanupParticleSystemsList.push_back(ps);
-					}
-				}
-				if (cleanupParticleSystemsList.empty() == false) {
+			if (particleOwner != NULL) {
+				OwnerMap::iterator iterFind = ownerParticleSystems.find(particleOwner);
+				if (iterFind != ownerParticleSystems.end()) {
+					// Cleanup changes the owner index, so work on a copy
+					vector<ParticleSystem *> cleanupParticleSystemsList = iterFind->second;
 					cleanupParticleSystems(cleanupParticleSystemsList);
 				}
 			}
 		}
 
-		int ParticleManager::findParticleSystems(ParticleSystem *psFind, const vector<ParticleSystem *> &particleSystems) const {
-			int result = -1;
-			for (unsigned int i = 0; i < particleSystems.size(); i++) {
-				ParticleSystem *ps = particleSystems[i];
-				if (ps != NULL && psFind != NULL && psFind == ps) {
-					result = i;
-					break;
-				}
+		void ParticleManager::changeParticleOwner(ParticleSystem *ps, ParticleOwner *oldOwner, ParticleOwner *newOwner) {
+			removeOwnerEntry(ps, oldOwner);
+			addOwnerEntry(ps, newOwner);
+		}
+
+		void ParticleManager::addOwnerEntry(ParticleSystem *ps, ParticleOwner *particleOwner) {
+			if (particleOwner != NULL) {
+				ownerParticleSystems[particleOwner].push_back(ps);
 			}
-			return result;
 		}
 
-		void ParticleManager::cleanupParticleSystems(ParticleSystem *ps) {
+		void ParticleManager::removeOwnerEntry(ParticleSystem *ps, ParticleOwner *particleOwner) {
+			if (particleOwner == NULL) {
+				return;
+			}
+			OwnerMap::iterator iterFind = ownerParticleSystems.find(particleOwner);
+			if (iterFind != ownerParticleSystems.end()) {
+				vector<ParticleSystem *> &ownerList = iterFind->second;
+				ownerList.erase(std::remove(ownerList.begin(), ownerList.end(), ps), ownerList.end());
+				if (ownerList.empty() == true) {
+					ownerParticleSystems.erase(iterFind);
+				}
+			}
+		}
 
-			int index = findParticleSystems(ps, this->particleSystems);
-			if (ps != NULL && index >= 0) {
-				//		printf("-- Delete cleanupParticleSystems [%p]\n",ps);
-				//		static map<void *,int> deleteList;
-				//		if(deleteList.find(ps) != deleteList.end()) {
-				//			assert(deleteList.find(ps) == deleteList.end());
-				//		}
-				//		deleteList[ps]++;
+		bool ParticleManager::unmanage(ParticleSystem *ps) {
+			SlotMap::iterator iterFind = particleSystemSlots.find(ps);
+			if (iterFind == particleSystemSlots.end()) {
+				return false;
+			}
+			particleSystems[iterFind->second] = NULL;
+			++emptySlotCount;
+			particleSystemSlots.erase(iterFind);
 
-						// This code causes segfault on game end, no need to fade, just delete
-						//if(ps->getState() != ParticleSystem::sFade) {
-						//	ps->fade();
-						//}
+			removeOwnerEntry(ps, ps->particleOwner);
+			ps->particleManager = NULL;
+			return true;
+		}
 
+		void ParticleManager::compact() {
+			if (emptySlotCount == 0) {
+				return;
+			}
+			int slot = 0;
+			for (unsigned int i = 0; i < particleSystems.size(); ++i) {
+				ParticleSystem *ps = particleSystems[i];
 				if (ps != NULL) {
-					ps->callParticleOwnerEnd(ps);
+					particleSystems[slot] = ps;
+					particleSystemSlots[ps] = slot;
+					++slot;
 				}
+			}
+			particleSystems.resize(slot);
+			emptySlotCount = 0;
+		}
 
+		void ParticleManager::cleanupParticleSystems(ParticleSystem *ps) {
+			if (ps != NULL && unmanage(ps) == true) {
+				// This code causes segfault on game end, no need to fade, just delete
+				//if(ps->getState() != ParticleSystem::sFade) {
+				//	ps->fade();
+				//}
+
+				ps->callParticleOwnerEnd(ps);
 				delete ps;
-				this->particleSystems.erase(this->particleSystems.begin() + index);
+
+				// Keep the holes bounded when systems are removed between updates
+				if (updating == false && emptySlotCount > 64 && emptySlotCount * 2 > (int) particleSystems.size()) {
+					compact();
+				}
 			}
 		}
 
@@ -2517,8 +2599,12 @@ namespace Shared {
 		}
 
 		void ParticleManager::manage(ParticleSystem *ps) {
-			assert((std::find(particleSystems.begin(), particleSystems.end(), ps) == particleSystems.end()) && "particle cannot be added twice");
+			assert(particleSystemSlots.find(ps) == particleSystemSlots.end() && "particle cannot be added twice");
+			particleSystemSlots[ps] = (int) particleSystems.size();
 			particleSystems.push_back(ps);
+			ps->particleManager = this;
+			addOwnerEntry(ps, ps->particleOwner);
+
 			for (int i = ps->getChildCount() - 1; i >= 0; i--) {
 				manage(ps->getChild(i));
 			}
@@ -2527,20 +2613,20 @@ namespace Shared {
 		void ParticleManager::end() {
 			while (particleSystems.empty() == false) {
 				ParticleSystem *ps = particleSystems.back();
-
-				//		printf("-- Delete end() [%p]\n",ps);
-				//		static map<void *,int> deleteList;
-				//		if(deleteList.find(ps) != deleteList.end()) {
-				//			assert(deleteList.find(ps) == deleteList.end());
-				//		}
-				//		deleteList[ps]++;
+				particleSystems.pop_back();
 
 				if (ps != NULL) {
+					particleSystemSlots.erase(ps);
+					removeOwnerEntry(ps, ps->particleOwner);
+					ps->particleManager = NULL;
+
 					ps->callParticleOwnerEnd(ps);
+					delete ps;
 				}
-				delete ps;
-				particleSystems.pop_back();
 			}
+			emptySlotCount = 0;
+			particleSystemSlots.clear();
+			ownerParticleSystems.clear();
 		}
 
 		}
@@ -1281,6 +1281,40 @@ namespace Shared {
 			return (max(abs(a.x - b.x), abs(a.y - b.y)) + 3.f*a.dist(b)) / 4.f;
 		}
 
+		// Corner weights of one splat pixel, in the order of the corners
+		class SplatWeights {
+		public:
+			float corner[4];
+			float inverseTotal;
+		};
+
+		// Blends one row of the four corner pixmaps into target. The float
+		// steps are the ones getPixel4f and setPixel use, so the result
+		// does not depend on taking this path.
+		static void splatRow(uint8 *target, int targetComponents, const uint8 *const *sources,
+			const int *sourceComponents, const SplatWeights *weights, int count) {
+			int channels = min(targetComponents, 4);
+			for (int x = 0; x < count; ++x) {
+				const SplatWeights &weight = weights[x];
+				for (int c = 0; c < channels; ++c) {
+					float value = 0.f;
+					for (int corner = 0; corner < 4; ++corner) {
+						float source = (c < sourceComponents[corner] ? sources[corner][x * sourceComponents[corner] + c] / 255.f : 0.f);
+						value += source * weight.corner[corner];
+					}
+					target[x * targetComponents + c] = static_cast<uint8>((value * weight.inverseTotal) * 255.f);
+				}
+			}
+		}
+
+		static void lerpRow(uint8 *target, const uint8 *from, const uint8 *to, int count, float t) {
+			for (int i = 0; i < count; ++i) {
+				float value = from[i] / 255.f;
+				value = value + (to[i] / 255.f - value) * t;
+				target[i] = static_cast<uint8>(value * 255.f);
+			}
+		}
+
 		void Pixmap2D::splat(const Pixmap2D *leftUp, const Pixmap2D *rightUp, const Pixmap2D *leftDown, const Pixmap2D *rightDown) {
 
 			RandomGen random;
@@ -1295,39 +1329,37 @@ namespace Shared {
 				throw megaglest_runtime_error("Pixmap2D::splat: pixmap dimensions don't agree");
 			}
 
+			// The weights are drawn column by column like they always were,
+			// so a splat keeps its look, then the pixels are blended by rows
+			vector<SplatWeights> weights(w * h);
+			float avg = std::pow((w + h) / 2.f, 2.0f);
+			const Vec2i corners[4] = { Vec2i(0, 0), Vec2i(w, 0), Vec2i(0, h), Vec2i(w, h) };
 			for (int i = 0; i < w; ++i) {
 				for (int j = 0; j < h; ++j) {
+					SplatWeights &weight = weights[j * w + i];
+					float total = 0.f;
+					for (int corner = 0; corner < 4; ++corner) {
+						float dist = std::pow(splatDist(Vec2i(i, j), corners[corner]), 2.0f);
+						weight.corner[corner] = dist > avg ? 0 : ((avg - dist))*random.randRange(0.5f, 1.0f);
+						total += weight.corner[corner];
+					}
+					weight.inverseTotal = 1.0f / total;
+				}
+			}
 
-					float avg = (w + h) / 2.f;
-
-					float distLu = splatDist(Vec2i(i, j), Vec2i(0, 0));
-					float distRu = splatDist(Vec2i(i, j), Vec2i(w, 0));
-					float distLd = splatDist(Vec2i(i, j), Vec2i(0, h));
-					float distRd = splatDist(Vec2i(i, j), Vec2i(w, h));
-
-					const float powFactor = 2.0f;
-
-					distLu = std::pow(distLu, powFactor);
-					distRu = std::pow(distRu, powFactor);
-					distLd = std::pow(distLd, powFactor);
-					distRd = std::pow(distRd, powFactor);
-					avg = std::pow(avg, powFactor);
-
-					float lu = distLu > avg ? 0 : ((avg - distLu))*random.randRange(0.5f, 1.0f);
-					float ru = distRu > avg ? 0 : ((avg - distRu))*random.randRange(0.5f, 1.0f);
-					float ld = distLd > avg ? 0 : ((avg - distLd))*random.randRange(0.5f, 1.0f);
-					float rd = distRd > avg ? 0 : ((avg - distRd))*random.randRange(0.5f, 1.0f);
-
-					float total = lu + ru + ld + rd;
-
-					Vec4f pix = (leftUp->getPixel4f(i, j)*lu +
-						rightUp->getPixel4f(i, j)*ru +
-						leftDown->getPixel4f(i, j)*ld +
-						rightDown->getPixel4f(i, j)*rd)*(1.0f / total);
-
-					setPixel(i, j, pix);
+			const Pixmap2D *sourcePixmaps[4] = { leftUp, rightUp, leftDown, rightDown };
+			int sourceComponents[4];
+			for (int corner = 0; corner < 4; ++corner) {
+				sourceComponents[corner] = sourcePixmaps[corner]->getComponents();
+			}
+			for (int j = 0; j < h; ++j) {
+				const uint8 *sourceRows[4];
+				for (int corner = 0; corner < 4; ++corner) {
+					sourceRows[corner] = sourcePixmaps[corner]->getPixels() + j * w * sourceComponents[corner];
 				}
+				splatRow(pixels + j * w * components, components, sourceRows, sourceComponents, &weights[j * w], w);
 			}
+			CalculatePixelsCRC(pixels, getPixelByteCount(), crc);
 		}
 
 		void Pixmap2D::lerp(float t, const Pixmap2D *pixmap1, const Pixmap2D *pixmap2) {
@@ -1337,6 +1369,12 @@ namespace Shared {
 				throw megaglest_runtime_error("Pixmap2D::lerp: pixmap dimensions don't agree");
 			}
 
+			if (components <= 4 && pixmap1->getComponents() == components && pixmap2->getComponents() == components) {
+				lerpRow(pixels, pixmap1->getPixels(), pixmap2->getPixels(), w * h * components, t);
+				CalculatePixelsCRC(pixels, getPixelByteCount(), crc);
+				return;
+			}
+
 			for (int i = 0; i < w; ++i) {
 				for (int j = 0; j < h; ++j) {
 					setPixel(i, j, pixmap1->getPixel4f(i, j).lerp(t, pixmap2->getPixel4f(i, j)));
@@ -1363,6 +1401,18 @@ namespace Shared {
 				throw megaglest_runtime_error("Pixmap2D::subCopy(), bad dimensions");
 			}
 
+			int sourceW = sourcePixmap->getW();
+			int sourceH = sourcePixmap->getH();
+			if (x >= 0 && y >= 0 && x + sourceW <= w && y + sourceH <= h) {
+				// Fits completely, copy whole rows
+				for (int j = 0; j < sourceH; ++j) {
+					memcpy(pixels + ((y + j) * w + x) * components,
+						sourcePixmap->getPixels() + j * sourceW * components, sourceW * components);
+				}
+				CalculatePixelsCRC(pixels, getPixelByteCount(), crc);
+				return;
+			}
+
 			uint8 *pixel = new uint8[components];
 
 			for (int i = 0; i < sourcePixmap->getW(); ++i) {
@@ -1384,6 +1434,16 @@ namespace Shared {
 				throw megaglest_runtime_error("Pixmap2D::copyImagePart(), bad dimensions");
 			}
 
+			int sourceW = sourcePixmap->getW();
+			if (x >= 0 && y >= 0 && x + w <= sourceW && y + h <= sourcePixmap->getH()) {
+				for (int j = 0; j < h; ++j) {
+					memcpy(pixels + j * w * components,
+						sourcePixmap->getPixels() + ((y + j) * sourceW + x) * components, w * components);
+				}
+				CalculatePixelsCRC(pixels, getPixelByteCount(), crc);
+				return;
+			}
+
 			uint8 *pixel = new uint8[components];
 
 			for (int i = x; i < x + w; ++i) {
@@ -0,0 +1,244 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "residency_manager.h"
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include "texture.h"
+#include "model.h"
+#include "thread.h"
+#include "platform_common.h"
+#include "conversion.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+
+namespace Shared {
+	namespace Graphics {
+
+		const uint32 ResidencyManager::minIdleFrames = 300;
+		const uint32 ResidencyManager::checkIntervalFrames = 64;
+
+		// Textures and models are created by the loader threads as well
+		struct ResidencyRegistry {
+			Mutex mutex;
+			std::vector<Texture2D *> textures;
+			std::vector<Model *> models;
+
+			int64 texturePixelBudget;
+			std::atomic<uint32> currentFrame;
+			int64 evictedCount;
+			int64 reloadedCount;
+
+			ResidencyRegistry() : mutex(CODE_AT_LINE), texturePixelBudget(-1),
+				currentFrame(0), evictedCount(0), reloadedCount(0) {
+			}
+		};
+
+		static ResidencyRegistry &getRegistry() {
+			static ResidencyRegistry registry;
+			return registry;
+		}
+
+		static bool isLessRecentlyUsed(const Texture2D *a, const Texture2D *b) {
+			return a->getLastUsedFrame() < b->getLastUsedFrame();
+		}
+
+		static string toMegabytes(int64 bytes) {
+			return floatToStr(bytes / (1024.0f * 1024.0f), 1) + " MB";
+		}
+
+		// =====================================================
+		//	class ResidencyManager
+		// =====================================================
+
+		void ResidencyManager::registerTexture(Texture2D *texture) {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			texture->residencySlot = (int) registry.textures.size();
+			texture->lastUsedFrame = registry.currentFrame.load();
+			registry.textures.push_back(texture);
+		}
+
+		void ResidencyManager::unregisterTexture(Texture2D *texture) {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			int slot = texture->residencySlot;
+			if (slot < 0 || slot >= (int) registry.textures.size() || registry.textures[slot] != texture) {
+				return;
+			}
+			registry.textures[slot] = registry.textures.back();
+			registry.textures[slot]->residencySlot = slot;
+			registry.textures.pop_back();
+			texture->residencySlot = -1;
+		}
+
+		void ResidencyManager::registerModel(Model *model) {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			registry.models.push_back(model);
+		}
+
+		void ResidencyManager::unregisterModel(Model *model) {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			std::vector<Model *>::iterator iterFind = std::find(registry.models.begin(), registry.models.end(), model);
+			if (iterFind != registry.models.end()) {
+				*iterFind = registry.models.back();
+				registry.models.pop_back();
+			}
+		}
+
+		void ResidencyManager::setTexturePixelBudget(int64 bytes) {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			registry.texturePixelBudget = bytes;
+		}
+
+		int64 ResidencyManager::getTexturePixelBudget() {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			return registry.texturePixelBudget;
+		}
+
+		// Read without the lock by the textures on every use
+		uint32 ResidencyManager::getCurrentFrame() {
+			return getRegistry().currentFrame.load();
+		}
+
+		// Called once per rendered frame from the main thread
+		void ResidencyManager::nextFrame() {
+			ResidencyRegistry &registry = getRegistry();
+			uint32 frame = ++registry.currentFrame;
+			if (frame % checkIntervalFrames == 0) {
+				enforceBudget();
+			}
+		}
+
+		// Drops the pixels of the least recently used idle textures until
+		// the budget is met, returns how many were dropped
+		int ResidencyManager::enforceBudget() {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			if (registry.texturePixelBudget < 0) {
+				return 0;
+			}
+
+			uint32 currentFrame = registry.currentFrame.load();
+			int64 residentBytes = 0;
+			std::vector<Texture2D *> candidates;
+			for (unsigned int i = 0; i < registry.textures.size(); ++i) {
+				Texture2D *texture = registry.textures[i];
+				if (texture->hasPixelData() == false) {
+					continue;
+				}
+				residentBytes += texture->getPixelByteCount();
+				if (texture->canEvictPixels() == true &&
+					currentFrame - texture->getLastUsedFrame() >= minIdleFrames) {
+					candidates.push_back(texture);
+				}
+			}
+			if (residentBytes <= registry.texturePixelBudget) {
+				return 0;
+			}
+
+			std::sort(candidates.begin(), candidates.end(), isLessRecentlyUsed);
+			int evicted = 0;
+			for (unsigned int i = 0; i < candidates.size() && residentBytes > registry.texturePixelBudget; ++i) {
+				residentBytes -= candidates[i]->getPixelByteCount();
+				candidates[i]->evictPixels();
+				evicted++;
+			}
+			registry.evictedCount += evicted;
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d] dropped pixels of %d textures, " MG_I64_SPECIFIER " bytes still resident\n", __FILE__, __FUNCTION__, __LINE__, evicted, residentBytes);
+			return evicted;
+		}
+
+		void ResidencyManager::reloadPixels(Texture2D *texture) {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			if (texture->pixelsEvicted == false) {
+				return;
+			}
+			texture->pixmap.load(texture->path);
+			texture->pixelsEvicted = false;
+			registry.reloadedCount++;
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem, "In [%s::%s Line: %d] reloaded pixels of [%s]\n", __FILE__, __FUNCTION__, __LINE__, texture->path.c_str());
+		}
+
+		int64 ResidencyManager::getEvictedCount() {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			return registry.evictedCount;
+		}
+
+		int64 ResidencyManager::getReloadedCount() {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			return registry.reloadedCount;
+		}
+
+		int64 ResidencyManager::getResidentBytes(Category category) {
+			ResidencyRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			int64 result = 0;
+			switch (category) {
+				case rcTexturePixels:
+					for (unsigned int i = 0; i < registry.textures.size(); ++i) {
+						const Texture2D *texture = registry.textures[i];
+						if (texture->hasPixelData() == true) {
+							result += texture->getPixelByteCount();
+						}
+					}
+					break;
+				case rcTextureUploads:
+					// Uncompressed size, mipmaps add a third
+					for (unsigned int i = 0; i < registry.textures.size(); ++i) {
+						const Texture2D *texture = registry.textures[i];
+						if (texture->getInited() == true) {
+							int64 bytes = texture->getPixelByteCount();
+							result += (texture->getMipmap() == true ? bytes * 4 / 3 : bytes);
+						}
+					}
+					break;
+				case rcModelMeshes:
+					for (unsigned int i = 0; i < registry.models.size(); ++i) {
+						result += registry.models[i]->getDataByteCount();
+					}
+					break;
+				default:
+					break;
+			}
+			return result;
+		}
+
+		string ResidencyManager::getStatsText() {
+			int64 budget = getTexturePixelBudget();
+			string result = "Texture pixels in RAM: " + toMegabytes(getResidentBytes(rcTexturePixels));
+			if (budget >= 0) {
+				result += " of " + toMegabytes(budget);
+			}
+			result += " dropped " + intToStr(getEvictedCount()) +
+				" reloaded " + intToStr(getReloadedCount()) + "\n";
+			result += "Textures on GPU (est.): " + toMegabytes(getResidentBytes(rcTextureUploads)) + "\n";
+			result += "Model meshes in RAM: " + toMegabytes(getResidentBytes(rcModelMeshes)) + "\n";
+			return result;
+		}
+
+	}
+}//end namespace
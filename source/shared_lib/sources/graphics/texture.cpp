@@ -13,6 +13,7 @@
 #include "util.h"
 #include <SDL.h>
 #include "platform_util.h"
+#include "residency_manager.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
@@ -86,11 +87,55 @@ namespace Shared {
 		//	class Texture2D
 		// =====================================================
 
+		Texture2D::Texture2D() : Texture() {
+			fileBacked = false;
+			pixelsEvicted = false;
+			lastUsedFrame = 0;
+			residencySlot = -1;
+			ResidencyManager::registerTexture(this);
+		}
+
+		Texture2D::~Texture2D() {
+			ResidencyManager::unregisterTexture(this);
+		}
+
+		// Callers of the writable pixmap may change the pixels, so they
+		// can't be read back from the file anymore
+		Pixmap2D *Texture2D::getPixmap() {
+			ensurePixels();
+			fileBacked = false;
+			return &pixmap;
+		}
+
+		const Pixmap2D *Texture2D::getPixmapConst() const {
+			ensurePixels();
+			return &pixmap;
+		}
+
+		void Texture2D::ensurePixels() const {
+			lastUsedFrame = ResidencyManager::getCurrentFrame();
+			if (pixelsEvicted == false) {
+				return;
+			}
+			ResidencyManager::reloadPixels(const_cast<Texture2D *>(this));
+		}
+
+		// The GPU keeps its copy, the pixels are read from the file again
+		// if they are needed later
+		void Texture2D::evictPixels() {
+			if (canEvictPixels() == false) {
+				return;
+			}
+			pixmap.deletePixels();
+			pixelsEvicted = true;
+		}
+
 		std::pair<SDL_Surface*, unsigned char*> Texture2D::CreateSDLSurface(bool newPixelData) const {
 			std::pair<SDL_Surface*, unsigned char*> result;
 			result.first = NULL;
 			result.second = NULL;
 
+			ensurePixels();
 			unsigned char* surfData = NULL;
 			if (newPixelData == true) {
 				// copy pixel data
@@ -227,6 +272,9 @@ namespace Shared {
 			}
 			pixmap.load(path);
 			this->path = path;
+			fileBacked = true;
+			pixelsEvicted = false;
+			lastUsedFrame = ResidencyManager::getCurrentFrame();
 		}
 
 		string Texture2D::getPath() const {
@@ -236,6 +284,7 @@ namespace Shared {
 		void Texture2D::deletePixels() {
 			//printf("+++> Texture2D pixmap deletion for [%s]\n",getPath().c_str());
 			pixmap.deletePixels();
+			pixelsEvicted = false;
 		}
 
 		// =====================================================
@@ -1962,6 +1962,24 @@ namespace Shared {
 			return 0;
 			}
 
+		// Seconds since the epoch, 0 when the file can not be read
+		int64 getFileModificationTime(const string &filename) {
+#ifdef WIN32
+#if defined(__MINGW32__)
+			struct _stat stbuf;
+#else
+			struct _stat64i32 stbuf;
+#endif
+			if (_wstat(utf8_decode(filename).c_str(), &stbuf) != -1) {
+#else
+			struct stat stbuf;
+			if (stat(filename.c_str(), &stbuf) != -1) {
+#endif
+				return (int64) stbuf.st_mtime;
+			}
+			return 0;
+		}
+
 		string executable_path(const string &exeName, bool includeExeNameInPath) {
 			string value = "";
 #ifdef _WIN32
@@ -2243,9 +2261,33 @@ namespace Shared {
 				handler(szMsg);
 		}
 
+		const ValueCheckerVault::VaultItem * ValueCheckerVault::findVaultItem(const void *ptr) const {
+			for (int index = 0; index < vaultSlotsUsed; ++index) {
+				if (vaultSlots[index].ptr == ptr) {
+					return &vaultSlots[index];
+				}
+			}
+			for (unsigned int index = 0; index < vaultOverflowList.size(); ++index) {
+				if (vaultOverflowList[index].ptr == ptr) {
+					return &vaultOverflowList[index];
+				}
+			}
+			return NULL;
+		}
+
 		void ValueCheckerVault::addItemToVault(const void *ptr, int value) {
 #ifndef _DISABLE_MEMORY_VAULT_CHECKS
-			vaultList[ptr] = value;
+			VaultItem *item = const_cast<VaultItem *>(findVaultItem(ptr));
+			if (item == NULL) {
+				if (vaultSlotsUsed < vaultInlineSlotCount) {
+					item = &vaultSlots[vaultSlotsUsed++];
+				} else {
+					vaultOverflowList.push_back(VaultItem());
+					item = &vaultOverflowList.back();
+				}
+				item->ptr = ptr;
+			}
+			item->value = value;
 #endif
 		}
 
@@ -2253,14 +2295,169 @@ namespace Shared {
 #ifndef _DISABLE_MEMORY_VAULT_CHECKS
 			if (value == 0) //workaround
 				return;
-			map<const void *, int32>::const_iterator iterFind = vaultList.find(ptr);
-			if (iterFind != vaultList.end()) {
-				if (iterFind->second != 0 && iterFind->second != value)
-					notifyValueChangedUnexpectedly(value, iterFind->second);
+			const VaultItem *item = findVaultItem(ptr);
+			if (item != NULL) {
+				if (item->value != 0 && item->value != value)
+					notifyValueChangedUnexpectedly(value, item->value);
 			}
 #endif
 		}
 
+		// =====================================================
+		//	class ContentManifest
+		// =====================================================
+
+		const char *ContentManifest::manifestHeader = "MegaGlestContentManifest 1";
+
+		static bool compareContentManifestEntry(const ContentManifest::Entry &left, const ContentManifest::Entry &right) {
+			return left.path < right.path;
+		}
+
+		void ContentManifest::build(const string &rootFolder, const string &account, bool forceNoCache) {
+			this->account = account;
+			entries.clear();
+
+			string root = rootFolder;
+			endPathWithSlash(root);
+
+			vector<std::pair<string, uint32> > fileList;
+			if (forceNoCache == true) {
+				// Files may have just been replaced, so skip every CRC cache
+				vector<string> files = getFolderTreeContentsListRecursively(root + "*", "");
+				for (unsigned int index = 0; index < files.size(); ++index) {
+					Checksum::removeFileFromCache(files[index]);
+					Checksum checksum;
+					checksum.addFile(files[index]);
+					fileList.push_back(std::make_pair(files[index], checksum.getSum()));
+				}
+			} else {
+				fileList = getFolderTreeContentsCheckSumListRecursively(root + "*", "", NULL);
+			}
+
+			for (unsigned int index = 0; index < fileList.size(); ++index) {
+				const string &file = fileList[index].first;
+				if (StartsWith(file, root) == false) {
+					continue;
+				}
+				Entry entry;
+				entry.path = file.substr(root.size());
+				entry.crc = fileList[index].second;
+				entry.size = getFileSize(file);
+				entries.push_back(entry);
+			}
+			std::sort(entries.begin(), entries.end(), compareContentManifestEntry);
+		}
+
+		bool ContentManifest::save(const string &fileName) const {
+#ifdef WIN32
+			FILE *fp = _wfopen(utf8_decode(fileName).c_str(), L"w");
+#else
+			FILE *fp = fopen(fileName.c_str(), "w");
+#endif
+			if (fp == NULL) {
+				return false;
+			}
+			fprintf(fp, "%s\n%s\n", manifestHeader, account.c_str());
+			for (unsigned int index = 0; index < entries.size(); ++index) {
+				const Entry &entry = entries[index];
+				fprintf(fp, "%u %lld %s\n", entry.crc, (long long) entry.size, entry.path.c_str());
+			}
+			bool result = (ferror(fp) == 0);
+			fclose(fp);
+			return result;
+		}
+
+		bool ContentManifest::load(const string &fileName) {
+			account = "";
+			entries.clear();
+
+#ifdef WIN32
+			FILE *fp = _wfopen(utf8_decode(fileName).c_str(), L"r");
+#else
+			FILE *fp = fopen(fileName.c_str(), "r");
+#endif
+			if (fp == NULL) {
+				return false;
+			}
+
+			bool result = false;
+			char szLine[8096] = "";
+			if (fgets(szLine, 8096, fp) != NULL && trim(szLine, " \r\n") == manifestHeader &&
+				fgets(szLine, 8096, fp) != NULL) {
+				account = trim(szLine, " \r\n");
+				result = true;
+
+				while (fgets(szLine, 8096, fp) != NULL) {
+					string line = szLine;
+					line = trim_right(line, "\r\n");
+					if (line.empty() == true) {
+						continue;
+					}
+
+					// crc size path, the path may contain spaces
+					size_t crcEnd = line.find(' ');
+					size_t sizeEnd = (crcEnd != string::npos ? line.find(' ', crcEnd + 1) : string::npos);
+					if (sizeEnd == string::npos || sizeEnd + 1 >= line.size()) {
+						result = false;
+						break;
+					}
+					Entry entry;
+					entry.crc = (uint32) strtoul(line.substr(0, crcEnd).c_str(), NULL, 10);
+					entry.size = strtoll(line.substr(crcEnd + 1, sizeEnd - crcEnd - 1).c_str(), NULL, 10);
+					entry.path = line.substr(sizeEnd + 1);
+
+					// Never let a manifest point outside the content folder
+					if (entry.path.find("..") != string::npos || StartsWith(entry.path, "/") == true) {
+						result = false;
+						break;
+					}
+					entries.push_back(entry);
+				}
+			}
+			fclose(fp);
+
+			if (result == false) {
+				account = "";
+				entries.clear();
+			}
+			return result;
+		}
+
+		vector<ContentManifest::Entry> ContentManifest::getChangedEntries(const ContentManifest &localManifest) const {
+			std::map<string, uint32> localFiles;
+			for (unsigned int index = 0; index < localManifest.entries.size(); ++index) {
+				localFiles[localManifest.entries[index].path] = localManifest.entries[index].crc;
+			}
+
+			vector<Entry> result;
+			for (unsigned int index = 0; index < entries.size(); ++index) {
+				std::map<string, uint32>::const_iterator iterFind = localFiles.find(entries[index].path);
+				if (iterFind == localFiles.end() || iterFind->second != entries[index].crc) {
+					result.push_back(entries[index]);
+				}
+			}
+			return result;
+		}
+
+		vector<string> ContentManifest::getObsoletePaths(const ContentManifest &localManifest) const {
+			std::map<string, bool> files;
+			for (unsigned int index = 0; index < entries.size(); ++index) {
+				files[entries[index].path] = true;
+			}
+
+			vector<string> result;
+			for (unsigned int index = 0; index < localManifest.entries.size(); ++index) {
+				if (files.find(localManifest.entries[index].path) == files.end()) {
+					result.push_back(localManifest.entries[index].path);
+				}
+			}
+			return result;
+		}
+
+		string ContentManifest::getManifestFileName(const string &contentType, const string &contentName) {
+			return contentType + "_" + contentName + ".manifest";
+		}
+
 		string getUserHome() {
 			string home_folder;
 			home_folder = safeCharPtrCopy(getenv("HOME"), 8095);
@@ -476,7 +476,11 @@ namespace Shared {
 				this->fileArchiveExtractCommandSuccessResult);
 
 			pair<FTP_Client_ResultType, string> result = make_pair(ftp_crt_FAIL, "");
-			if (findArchive == true) {
+			if (tileSetName.second == "") {
+				result = getContentDeltaFromServer(ftp_cct_Tileset, tileSetName, "tilesets",
+					this->tilesetsPath.second, FTP_TILESETS_USERNAME, FTP_TILESETS_CUSTOM_USERNAME);
+			}
+			if (findArchive == true && result.first != ftp_crt_SUCCESS && this->getQuitStatus() == false) {
 				if (tileSetName.second != "") {
 					//result = getTilesetFromServer(tileSetName, "", "", "", findArchive);
 					result = getTilesetFromServer(tileSetName, "", "", "", true);
@@ -658,7 +662,11 @@ namespace Shared {
 			bool findArchive = executeShellCommand(
 				this->fileArchiveExtractCommand,
 				this->fileArchiveExtractCommandSuccessResult);
-			if (findArchive == true) {
+			if (techtreeName.second == "") {
+				result = getContentDeltaFromServer(ftp_cct_Techtree, techtreeName, "techtrees",
+					this->techtreesPath.second, FTP_TECHTREES_USERNAME, FTP_TECHTREES_CUSTOM_USERNAME);
+			}
+			if (findArchive == true && result.first != ftp_crt_SUCCESS && this->getQuitStatus() == false) {
 				if (techtreeName.second != "") {
 					result = getTechtreeFromServer(techtreeName, "", "");
 				} else {
@@ -735,6 +743,107 @@ namespace Shared {
 
 		}
 
+		pair<FTP_Client_ResultType, string> FTPClientThread::getContentDeltaFromServer(FTP_Client_CallbackType downloadType,
+			pair<string, string> contentName, const string &contentType,
+			const string &destRootPath, const string &baseUser, const string &customUser) {
+
+			pair<FTP_Client_ResultType, string> result = make_pair(ftp_crt_FAIL, "");
+			if (tempFilesPath == "" || destRootPath == "") {
+				return result;
+			}
+
+			string manifestFileName = ContentManifest::getManifestFileName(contentType, contentName.first);
+			string destManifest = tempFilesPath;
+			endPathWithSlash(destManifest);
+			destManifest += manifestFileName;
+
+			result = getFileFromServer(downloadType, make_pair(contentName.first, ""),
+				manifestFileName, destManifest, FTP_TEMPFILES_USERNAME, FTP_COMMON_PASSWORD);
+			if (result.first != ftp_crt_SUCCESS) {
+				// Older hosts publish no manifest, the caller falls back to the archive
+				return make_pair(ftp_crt_FAIL, result.second);
+			}
+
+			ContentManifest remoteManifest;
+			bool manifestLoaded = remoteManifest.load(destManifest);
+			removeFile(destManifest);
+			if (manifestLoaded == false ||
+				(remoteManifest.getAccount() != baseUser && remoteManifest.getAccount() != customUser)) {
+				return make_pair(ftp_crt_FAIL, "invalid content manifest!");
+			}
+
+			string destRootFolder = destRootPath;
+			endPathWithSlash(destRootFolder);
+			destRootFolder += contentName.first;
+			endPathWithSlash(destRootFolder);
+
+			// Files completed by an earlier interrupted attempt match and are skipped
+			ContentManifest localManifest;
+			if (folderExists(destRootFolder) == true) {
+				localManifest.build(destRootFolder, "", true);
+			}
+
+			vector<ContentManifest::Entry> changedEntries = remoteManifest.getChangedEntries(localManifest);
+			vector<string> obsoletePaths = remoteManifest.getObsoletePaths(localManifest);
+
+			if (SystemFlags::VERBOSE_MODE_ENABLED) printf("===> FTP Client delta for [%s] files: %d changed: %d obsolete: %d\n", contentName.first.c_str(), (int) remoteManifest.getEntries().size(), (int) changedEntries.size(), (int) obsoletePaths.size());
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "===> FTP Client delta for [%s] files: %d changed: %d obsolete: %d\n", contentName.first.c_str(), (int) remoteManifest.getEntries().size(), (int) changedEntries.size(), (int) obsoletePaths.size());
+
+			result = make_pair(ftp_crt_SUCCESS, "");
+			for (unsigned int index = 0; index < changedEntries.size(); ++index) {
+				if (this->getQuitStatus() == true) {
+					result = make_pair(ftp_crt_ABORTED, "");
+					break;
+				}
+
+				const ContentManifest::Entry &entry = changedEntries[index];
+				string destFile = destRootFolder + entry.path;
+
+				// my_fwrite only creates the file on the first chunk, an empty
+				// file would never be written and a stale copy never truncated
+				string destFolder = extractDirectoryPathFromFile(destFile);
+				if (isdir(destFolder.c_str()) == false) {
+					createDirectoryPaths(destFolder);
+				}
+#ifdef WIN32
+				FILE *fpDest = _wfopen(utf8_decode(destFile).c_str(), L"wb");
+#else
+				FILE *fpDest = fopen(destFile.c_str(), "wb");
+#endif
+				if (fpDest == NULL) {
+					result = make_pair(ftp_crt_FAIL, "cannot create " + destFile);
+					break;
+				}
+				fclose(fpDest);
+
+				result = getFileFromServer(downloadType, make_pair(contentName.first, ""),
+					contentName.first + "/" + entry.path, destFile,
+					remoteManifest.getAccount(), FTP_COMMON_PASSWORD);
+				if (result.first != ftp_crt_SUCCESS) {
+					break;
+				}
+
+				Checksum::removeFileFromCache(destFile);
+				Checksum checksum;
+				checksum.addFile(destFile);
+				if (checksum.getSum() != entry.crc) {
+					removeFile(destFile);
+					result = make_pair(ftp_crt_PARTIALFAIL, "checksum mismatch for " + entry.path);
+					break;
+				}
+			}
+
+			if (result.first == ftp_crt_SUCCESS) {
+				for (unsigned int index = 0; index < obsoletePaths.size(); ++index) {
+					string obsoleteFile = destRootFolder + obsoletePaths[index];
+					Checksum::removeFileFromCache(obsoleteFile);
+					removeFile(obsoleteFile);
+				}
+			}
+
+			return result;
+		}
+
 		void FTPClientThread::getScenarioFromServer(pair<string, string> fileName) {
 			pair<FTP_Client_ResultType, string> result = make_pair(ftp_crt_FAIL, "");
 			bool findArchive = executeShellCommand(
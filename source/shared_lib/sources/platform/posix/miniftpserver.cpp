@@ -206,6 +206,64 @@ namespace Shared {
 			}
 		}
 
+		bool FTPServerThread::publishContentManifest(const std::pair<string, string> &contentPaths,
+			const char *baseUser, const char *customUser,
+			const string &contentType, const string &contentName, uint32 contentCRC) {
+			if (tempFilesPath == "" || contentName == "") {
+				return false;
+			}
+
+			string manifestFile = tempFilesPath;
+			endPathWithSlash(manifestFile);
+			manifestFile += ContentManifest::getManifestFileName(contentType, contentName);
+
+			std::map<string, uint32>::iterator iterFind = publishedManifestCRCs.find(manifestFile);
+			if (iterFind != publishedManifestCRCs.end() && iterFind->second == contentCRC &&
+				fileExists(manifestFile) == true) {
+				return true;
+			}
+
+			// Custom content shadows the base content of the same name
+			string contentRoot = "";
+			string account = "";
+			if (contentPaths.second != "" && folderExists(contentPaths.second + contentName) == true) {
+				contentRoot = contentPaths.second + contentName;
+				account = customUser;
+			} else if (contentPaths.first != "" && folderExists(contentPaths.first + contentName) == true) {
+				contentRoot = contentPaths.first + contentName;
+				account = baseUser;
+			}
+			if (contentRoot == "") {
+				return false;
+			}
+
+			ContentManifest manifest;
+			manifest.build(contentRoot, account);
+
+			createDirectoryPaths(tempFilesPath);
+			bool result = manifest.save(manifestFile);
+			if (result == true) {
+				publishedManifestCRCs[manifestFile] = contentCRC;
+			} else {
+				publishedManifestCRCs.erase(manifestFile);
+			}
+
+			if (SystemFlags::VERBOSE_MODE_ENABLED) printf("===> FTP Server published manifest [%s] files: %d result: %d\n", manifestFile.c_str(), (int) manifest.getEntries().size(), result);
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork, "In [%s::%s Line: %d] manifest [%s] files: %d result: %d\n", __FILE__, __FUNCTION__, __LINE__, manifestFile.c_str(), (int) manifest.getEntries().size(), result);
+
+			return result;
+		}
+
+		bool FTPServerThread::publishTilesetManifest(const string &tilesetName, uint32 tilesetCRC) {
+			return publishContentManifest(tilesetsPath, FTP_TILESETS_USERNAME, FTP_TILESETS_CUSTOM_USERNAME,
+				"tilesets", tilesetName, tilesetCRC);
+		}
+
+		bool FTPServerThread::publishTechtreeManifest(const string &techtreeName, uint32 techtreeCRC) {
+			return publishContentManifest(techtreesPath, FTP_TECHTREES_USERNAME, FTP_TECHTREES_CUSTOM_USERNAME,
+				"techtrees", techtreeName, techtreeCRC);
+		}
+
 		void FTPServerThread::execute() {
 			{
 				RunningStatusSafeWrapper runningStatus(this);
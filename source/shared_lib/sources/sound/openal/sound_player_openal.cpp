@@ -139,7 +139,7 @@ namespace Shared {
 				}
 			}
 
-			void StaticSoundSource::play(StaticSound* sound) {
+			void StaticSoundSource::play(StaticSound* sound, const int8 *samples, uint32 size) {
 				if (SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled) SystemFlags::OutputDebug(SystemFlags::debugSound, "In [%s::%s Line: %d]\n", __FILE__, __FUNCTION__, __LINE__);
 
 				if (bufferAllocated) {
@@ -152,11 +152,11 @@ namespace Shared {
 				alGenBuffers(1, &buffer);
 				SoundPlayerOpenAL::checkAlError("Couldn't create audio buffer: ");
 
-				if (SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled) SystemFlags::OutputDebug(SystemFlags::debugSound, "In [%s::%s Line: %d] filename [%s] format = %d, sound->getSamples() = %d, sound->getInfo()->getSize() = %d, sound->getInfo()->getSamplesPerSecond() = %d\n", __FILE__, __FUNCTION__, __LINE__, sound->getFileName().c_str(), format, sound->getSamples(), sound->getInfo()->getSize(), sound->getInfo()->getSamplesPerSecond());
+				if (SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled) SystemFlags::OutputDebug(SystemFlags::debugSound, "In [%s::%s Line: %d] filename [%s] format = %d, samples = %p, size = %u, sound->getInfo()->getSamplesPerSecond() = %d\n", __FILE__, __FUNCTION__, __LINE__, sound->getFileName().c_str(), format, samples, size, sound->getInfo()->getSamplesPerSecond());
 
 				bufferAllocated = true;
-				alBufferData(buffer, format, sound->getSamples(),
-					static_cast<ALsizei> (sound->getInfo()->getSize()),
+				alBufferData(buffer, format, samples,
+					static_cast<ALsizei> (size),
 					static_cast<ALsizei> (sound->getInfo()->getSamplesPerSecond()));
 
 				SoundPlayerOpenAL::checkAlError(string(__FILE__) + string(" ") + string(__FUNCTION__) + string(" ") + intToStr(__LINE__));
@@ -175,6 +175,7 @@ namespace Shared {
 				fadeState = NoFading;
 				format = 0;
 				fade = 0;
+				fragmentData = new int8[STREAMFRAGMENTSIZE];
 				alGenBuffers(STREAMFRAGMENTS, buffers);
 				SoundPlayerOpenAL::checkAlError(string(__FILE__) + string(" ") + string(__FUNCTION__) + string(" ") + intToStr(__LINE__));
 			}
@@ -182,6 +183,8 @@ namespace Shared {
 			StreamSoundSource::~StreamSoundSource() {
 				stop();
 				alDeleteBuffers(STREAMFRAGMENTS, buffers);
+				delete[] fragmentData;
+				fragmentData = NULL;
 				SoundPlayerOpenAL::checkAlError("Couldn't delete audio buffers: ");
 			}
 
@@ -288,7 +291,7 @@ namespace Shared {
 
 			bool StreamSoundSource::fillBufferAndQueue(ALuint buffer) {
 				// fill buffer
-				int8* bufferdata = new int8[STREAMFRAGMENTSIZE];
+				int8* bufferdata = fragmentData;
 				uint32 bytesread = 0;
 				do {
 					bytesread += sound->read(bufferdata + bytesread, STREAMFRAGMENTSIZE - bytesread);
@@ -304,7 +307,6 @@ namespace Shared {
 
 				alBufferData(buffer, format, bufferdata, STREAMFRAGMENTSIZE,
 					sound->getInfo()->getSamplesPerSecond());
-				delete[] bufferdata;
 				SoundPlayerOpenAL::checkAlError("Couldn't refill audio buffer: ");
 
 				alSourceQueueBuffers(source, 1, &buffer);
@@ -505,19 +507,31 @@ namespace Shared {
 				if (initOk == false) return;
 
 				try {
+					// Only long lazily loaded sounds can still be waiting for a
+					// decode thread, they are skipped until they are decoded
+					uint32 size = 0;
+					const int8 *samples = staticSound->lockSamples(size);
+					if (samples == NULL) {
+						return;
+					}
+
 					StaticSoundSource* source = findStaticSoundSource();
 
 					if (source == 0) {
-						if (force == false)
+						if (force == false) {
+							staticSound->unlockSamples();
 							return;
+						}
 						else {
 							// force usage of first StaticSoundSource
 							source = staticSources.front();
 							source->stop();
 						}
 					}
-					source->play(staticSound);
+					source->play(staticSound, samples, size);
+					staticSound->unlockSamples();
 				} catch (std::exception& e) {
+					staticSound->unlockSamples();
 					SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] Error [%s]\n", __FILE__, __FUNCTION__, __LINE__, e.what());
 					std::cerr << "Couldn't play static sound: [" << e.what() << "]\n";
 				}
@@ -10,6 +10,7 @@
 // ==============================================================
 
 #include "sound.h"
+#include "sound_sample_cache.h"
 
 #include <fstream>
 #include <stdexcept>
@@ -50,6 +51,8 @@ namespace Shared {
 
 		StaticSound::StaticSound() {
 			samples = NULL;
+			lazy = false;
+			lockedBuffer = NULL;
 			soundFileLoader = NULL;
 			fileName = "";
 		}
@@ -59,6 +62,9 @@ namespace Shared {
 		}
 
 		void StaticSound::close() {
+			unlockSamples();
+			lazy = false;
+
 			if (samples != NULL) {
 				delete[] samples;
 				samples = NULL;
@@ -79,6 +85,14 @@ namespace Shared {
 			if (GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
 				return;
 			}
+
+			SoundSampleCache &cache = SoundSampleCache::getInstance();
+			if (cache.getLazyLoading() == false) {
+				samples = decodeFile(path, &info);
+				return;
+			}
+
+			// Only read the header now, the samples are decoded on first play
 			string ext = (path.empty() == false ? path.substr(path.find_last_of('.') + 1) : "");
 			soundFileLoader = SoundFileLoaderFactory::getInstance()->newInstance(ext);
 
@@ -86,12 +100,62 @@ namespace Shared {
 				throw megaglest_runtime_error("soundFileLoader == NULL");
 			}
 			soundFileLoader->open(path, &info);
-			samples = new int8[info.getSize()];
-			soundFileLoader->read(samples, info.getSize());
 			soundFileLoader->close();
 
 			delete soundFileLoader;
 			soundFileLoader = NULL;
+
+			lazy = true;
+			cache.prefetch(path);
+		}
+
+		const int8 *StaticSound::lockSamples(uint32 &size) {
+			unlockSamples();
+
+			if (lazy == false) {
+				size = info.getSize();
+				return samples;
+			}
+
+			lockedBuffer = SoundSampleCache::getInstance().acquire(fileName,
+				SoundSampleCache::priorityPlay, info.getSize());
+			if (lockedBuffer == NULL) {
+				size = 0;
+				return NULL;
+			}
+			size = lockedBuffer->getInfo()->getSize();
+			return lockedBuffer->getSamples();
+		}
+
+		void StaticSound::unlockSamples() {
+			if (lockedBuffer != NULL) {
+				SoundSampleCache::getInstance().release(lockedBuffer);
+				lockedBuffer = NULL;
+			}
+		}
+
+		int8 *StaticSound::decodeFile(const string &path, SoundInfo *info) {
+			string ext = (path.empty() == false ? path.substr(path.find_last_of('.') + 1) : "");
+			SoundFileLoader *loader = SoundFileLoaderFactory::getInstance()->newInstance(ext);
+
+			if (loader == NULL) {
+				throw megaglest_runtime_error("soundFileLoader == NULL");
+			}
+
+			int8 *result = NULL;
+			try {
+				loader->open(path, info);
+				result = new int8[info->getSize()];
+				loader->read(result, info->getSize());
+				loader->close();
+			} catch (...) {
+				delete[] result;
+				delete loader;
+				throw;
+			}
+
+			delete loader;
+			return result;
 		}
 
 		// =====================================================
@@ -0,0 +1,383 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "sound_sample_cache.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "util.h"
+#include "platform_util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+
+namespace Shared {
+	namespace Sound {
+
+		// Decodes through the sound file loaders, like StaticSound::load
+		class SoundFileSampleDecoder : public SoundSampleDecoder {
+		public:
+			virtual int8 *decode(const string &path, SoundInfo *info) {
+				return StaticSound::decodeFile(path, info);
+			}
+		};
+
+		static SoundFileSampleDecoder soundFileSampleDecoder;
+
+		// =====================================================
+		//	class SoundSampleBuffer
+		// =====================================================
+
+		SoundSampleBuffer::SoundSampleBuffer(const string &path) {
+			this->path = path;
+			samples = NULL;
+			refCount = 0;
+			priority = 0;
+			lastUsed = 0;
+			queued = false;
+			decoding = false;
+			failed = false;
+		}
+
+		SoundSampleBuffer::~SoundSampleBuffer() {
+			delete[] samples;
+			samples = NULL;
+		}
+
+		// =====================================================
+		//	class SoundDecodeThread
+		// =====================================================
+
+		SoundDecodeThread::SoundDecodeThread(SoundSampleCache *cache) : BaseThread() {
+			this->cache = cache;
+			uniqueID = "SoundDecodeThread";
+		}
+
+		void SoundDecodeThread::execute() {
+			RunningStatusSafeWrapper runningStatus(this);
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled) SystemFlags::OutputDebug(SystemFlags::debugSound, "In [%s::%s Line: %d] Sound decode thread is running\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
+
+			try {
+				for (; getQuitStatus() == false;) {
+					bool decoded = false;
+					{
+						ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+						decoded = cache->decodeNext();
+					}
+					if (decoded == false && getQuitStatus() == false) {
+						cache->waitForDecodeRequest(50);
+					}
+				}
+			} catch (const exception &ex) {
+				SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] Error [%s]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, ex.what());
+			}
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled) SystemFlags::OutputDebug(SystemFlags::debugSound, "In [%s::%s Line: %d] Sound decode thread is exiting\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__);
+		}
+
+		// =====================================================
+		//	class SoundSampleCache
+		// =====================================================
+
+		SoundSampleCache::SoundSampleCache() : mutex(new Mutex(CODE_AT_LINE)) {
+			decoder = &soundFileSampleDecoder;
+			lazyLoading = false;
+			memoryLimit = defaultMemoryLimit;
+			memoryUsage = 0;
+			inlineDecodeLimit = defaultInlineDecodeLimit;
+			useCounter = 0;
+		}
+
+		SoundSampleCache::~SoundSampleCache() {
+			stopDecodeThreads();
+			clear();
+
+			delete mutex;
+			mutex = NULL;
+		}
+
+		SoundSampleCache &SoundSampleCache::getInstance() {
+			static SoundSampleCache cache;
+			return cache;
+		}
+
+		void SoundSampleCache::setDecoder(SoundSampleDecoder *decoder) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			this->decoder = (decoder != NULL ? decoder : &soundFileSampleDecoder);
+		}
+
+		void SoundSampleCache::setLazyLoading(bool value) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			lazyLoading = value;
+		}
+
+		bool SoundSampleCache::getLazyLoading() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			return lazyLoading;
+		}
+
+		void SoundSampleCache::setMemoryLimit(uint64 value) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			memoryLimit = value;
+			evict(NULL);
+		}
+
+		uint64 SoundSampleCache::getMemoryLimit() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			return memoryLimit;
+		}
+
+		uint64 SoundSampleCache::getMemoryUsage() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			return memoryUsage;
+		}
+
+		void SoundSampleCache::setInlineDecodeLimit(uint32 value) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			inlineDecodeLimit = value;
+		}
+
+		uint32 SoundSampleCache::getInlineDecodeLimit() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			return inlineDecodeLimit;
+		}
+
+		void SoundSampleCache::startDecodeThreads(int threadCount) {
+			stopDecodeThreads();
+
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			for (int index = 0; index < threadCount; ++index) {
+				SoundDecodeThread *thread = new SoundDecodeThread(this);
+				thread->setUniqueID(CODE_AT_LINE);
+				thread->start();
+				decodeThreads.push_back(thread);
+			}
+		}
+
+		void SoundSampleCache::stopDecodeThreads() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			vector<SoundDecodeThread *> threads = decodeThreads;
+			decodeThreads.clear();
+			safeMutex.ReleaseLock();
+
+			for (unsigned int index = 0; index < threads.size(); ++index) {
+				threads[index]->signalQuit();
+				decodeSignal.signal();
+			}
+			for (unsigned int index = 0; index < threads.size(); ++index) {
+				BaseThread::shutdownAndWait(threads[index]);
+				delete threads[index];
+			}
+		}
+
+		int SoundSampleCache::getDecodeThreadCount() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			return (int) decodeThreads.size();
+		}
+
+		SoundSampleBuffer *SoundSampleCache::getBuffer(const string &path) {
+			BufferMap::iterator iterFind = buffers.find(path);
+			if (iterFind != buffers.end()) {
+				return iterFind->second;
+			}
+			SoundSampleBuffer *buffer = new SoundSampleBuffer(path);
+			buffers[path] = buffer;
+			return buffer;
+		}
+
+		void SoundSampleCache::queueDecode(SoundSampleBuffer *buffer, int priority) {
+			if (buffer->queued == true) {
+				if (priority > buffer->priority) {
+					buffer->priority = priority;
+				}
+			} else if (buffer->decoding == false) {
+				buffer->priority = priority;
+				buffer->queued = true;
+				decodeQueue.push_back(buffer);
+				decodeSignal.signal();
+			}
+		}
+
+		// Returns the decoded samples and pins them until release() is
+		// called. Played sounds no longer than the inline limit, with
+		// expectedSize taken from the file header, are decoded here so a
+		// one shot sound isn't dropped while the threads catch up. Longer
+		// ones return NULL until a decode thread got to them.
+		SoundSampleBuffer *SoundSampleCache::acquire(const string &path, int priority, uint32 expectedSize) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			SoundSampleBuffer *buffer = getBuffer(path);
+			buffer->lastUsed = ++useCounter;
+
+			bool decodeNow = (decodeThreads.empty() == true ||
+				(priority >= priorityPlay && expectedSize <= inlineDecodeLimit));
+			if (buffer->samples == NULL && buffer->failed == false && decodeNow == true) {
+				// Pinned so clear() can't delete it while the lock is released
+				buffer->refCount++;
+				for (; buffer->decoding == true;) {
+					// A decode thread already has it, short files are done soon
+					safeMutex.ReleaseLock();
+					sleep(1);
+					safeMutex.Lock();
+				}
+				if (buffer->samples == NULL && buffer->failed == false) {
+					if (buffer->queued == true) {
+						decodeQueue.erase(std::find(decodeQueue.begin(), decodeQueue.end(), buffer));
+						buffer->queued = false;
+					}
+					buffer->decoding = true;
+					safeMutex.ReleaseLock();
+					decodeBuffer(buffer);
+					safeMutex.Lock();
+				}
+				buffer->refCount--;
+			}
+
+			if (buffer->samples == NULL) {
+				if (buffer->failed == false) {
+					queueDecode(buffer, priority);
+				}
+				return NULL;
+			}
+			buffer->refCount++;
+			return buffer;
+		}
+
+		void SoundSampleCache::release(SoundSampleBuffer *buffer) {
+			if (buffer == NULL) {
+				return;
+			}
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			buffer->refCount--;
+			evict(NULL);
+		}
+
+		void SoundSampleCache::prefetch(const string &path, int priority) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			SoundSampleBuffer *buffer = getBuffer(path);
+			if (buffer->samples == NULL && buffer->failed == false) {
+				queueDecode(buffer, priority);
+			}
+		}
+
+		// Decodes the most urgent queued file, returns false when the
+		// queue is empty. Prefetches are dropped once the cache is full
+		// so they never push out sounds that were actually played.
+		bool SoundSampleCache::decodeNext() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			SoundSampleBuffer *buffer = NULL;
+			for (; buffer == NULL && decodeQueue.empty() == false;) {
+				unsigned int bestIndex = 0;
+				for (unsigned int index = 1; index < decodeQueue.size(); ++index) {
+					if (decodeQueue[index]->priority > decodeQueue[bestIndex]->priority) {
+						bestIndex = index;
+					}
+				}
+				SoundSampleBuffer *candidate = decodeQueue[bestIndex];
+				decodeQueue.erase(decodeQueue.begin() + bestIndex);
+				candidate->queued = false;
+
+				if (candidate->priority > priorityPrefetch || memoryUsage < memoryLimit) {
+					buffer = candidate;
+				}
+			}
+			if (buffer == NULL) {
+				return false;
+			}
+
+			buffer->decoding = true;
+			safeMutex.ReleaseLock();
+
+			decodeBuffer(buffer);
+			return true;
+		}
+
+		// Called with the buffer marked as decoding and the mutex released
+		void SoundSampleCache::decodeBuffer(SoundSampleBuffer *buffer) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			SoundSampleDecoder *currentDecoder = decoder;
+			string path = buffer->path;
+			safeMutex.ReleaseLock();
+
+			SoundInfo info;
+			int8 *samples = NULL;
+			try {
+				samples = currentDecoder->decode(path, &info);
+			} catch (const exception &ex) {
+				SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] Error decoding [%s]: [%s]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, path.c_str(), ex.what());
+				samples = NULL;
+			}
+
+			safeMutex.Lock();
+			buffer->decoding = false;
+			if (samples == NULL) {
+				buffer->failed = true;
+				return;
+			}
+			buffer->info = info;
+			buffer->samples = samples;
+			memoryUsage += info.getSize();
+			evict(buffer);
+
+			if (SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled) SystemFlags::OutputDebug(SystemFlags::debugSound, "In [%s::%s Line: %d] decoded [%s] size = %u, cache memory = " MG_I64U_SPECIFIER "\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, path.c_str(), info.getSize(), memoryUsage);
+		}
+
+		// Frees the least recently used unpinned buffers until the
+		// cache fits the memory limit again
+		void SoundSampleCache::evict(const SoundSampleBuffer *keep) {
+			for (; memoryUsage > memoryLimit;) {
+				SoundSampleBuffer *oldest = NULL;
+				for (BufferMap::iterator iterMap = buffers.begin(); iterMap != buffers.end(); ++iterMap) {
+					SoundSampleBuffer *buffer = iterMap->second;
+					if (buffer != keep && buffer->samples != NULL && buffer->refCount <= 0 &&
+						(oldest == NULL || buffer->lastUsed < oldest->lastUsed)) {
+						oldest = buffer;
+					}
+				}
+				if (oldest == NULL) {
+					break;
+				}
+				memoryUsage -= oldest->info.getSize();
+				delete[] oldest->samples;
+				oldest->samples = NULL;
+			}
+		}
+
+		bool SoundSampleCache::waitForDecodeRequest(int waitMilliseconds) {
+			return (decodeSignal.waitTillSignalled(waitMilliseconds) == 0);
+		}
+
+		bool SoundSampleCache::isCached(const string &path) {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			BufferMap::iterator iterFind = buffers.find(path);
+			return (iterFind != buffers.end() && iterFind->second->samples != NULL);
+		}
+
+		// Drops all buffers that are not pinned or being decoded
+		void SoundSampleCache::clear() {
+			MutexSafeWrapper safeMutex(mutex, CODE_AT_LINE);
+			decodeQueue.clear();
+			for (BufferMap::iterator iterMap = buffers.begin(); iterMap != buffers.end();) {
+				SoundSampleBuffer *buffer = iterMap->second;
+				buffer->queued = false;
+				if (buffer->refCount <= 0 && buffer->decoding == false) {
+					if (buffer->samples != NULL) {
+						memoryUsage -= buffer->info.getSize();
+					}
+					delete buffer;
+					buffers.erase(iterMap++);
+				} else {
+					++iterMap;
+				}
+			}
+		}
+
+	}
+}//end namespace
@@ -0,0 +1,94 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "byte_delta.h"
+
+#include <cstring>
+#include "data_types.h"
+#include "byte_order.h"
+#include "leak_dumper.h"
+
+using Shared::Platform::uint16;
+
+namespace Shared {
+	namespace Util {
+
+		// =====================================================
+		//	class ByteDelta
+		// =====================================================
+
+		int ByteDelta::encode(const vector<unsigned char> &base,
+			const vector<unsigned char> &target,
+			vector<unsigned char> &payload, int maxRunGapBytes) {
+
+			int runCount = 0;
+			size_t targetSize = target.size();
+			for (size_t index = 0; index < targetSize; ) {
+				if (base[index] == target[index]) {
+					++index;
+					continue;
+				}
+
+				// Extend the run over short unchanged gaps, a new run costs 4 bytes
+				size_t runStart = index;
+				size_t runEnd = index + 1;
+				for (size_t scan = runEnd; scan < targetSize && scan - runEnd <= (size_t) maxRunGapBytes; ++scan) {
+					if (base[scan] != target[scan]) {
+						runEnd = scan + 1;
+					}
+				}
+
+				uint16 offset = Shared::PlatformByteOrder::toCommonEndian((uint16) runStart);
+				uint16 length = Shared::PlatformByteOrder::toCommonEndian((uint16) (runEnd - runStart));
+				const unsigned char *offsetBytes = reinterpret_cast<const unsigned char *>(&offset);
+				const unsigned char *lengthBytes = reinterpret_cast<const unsigned char *>(&length);
+				payload.insert(payload.end(), offsetBytes, offsetBytes + sizeof(offset));
+				payload.insert(payload.end(), lengthBytes, lengthBytes + sizeof(length));
+				payload.insert(payload.end(), target.begin() + runStart, target.begin() + runEnd);
+				runCount++;
+
+				index = runEnd;
+			}
+			return runCount;
+		}
+
+		bool ByteDelta::apply(const vector<unsigned char> &payload, int runCount,
+			vector<unsigned char> &buffer) {
+
+			vector<unsigned char> result(buffer);
+			size_t position = 0;
+			for (int run = 0; run < runCount; ++run) {
+				uint16 offset = 0;
+				uint16 length = 0;
+				if (position + sizeof(offset) + sizeof(length) > payload.size()) {
+					return false;
+				}
+				memcpy(&offset, &payload[position], sizeof(offset));
+				memcpy(&length, &payload[position + sizeof(offset)], sizeof(length));
+				offset = Shared::PlatformByteOrder::fromCommonEndian(offset);
+				length = Shared::PlatformByteOrder::fromCommonEndian(length);
+				position += sizeof(offset) + sizeof(length);
+
+				if (position + length > payload.size() || (size_t) offset + length > result.size()) {
+					return false;
+				}
+				if (length > 0) {
+					memcpy(&result[offset], &payload[position], length);
+				}
+				position += length;
+			}
+
+			buffer.swap(result);
+			return true;
+		}
+
+	}
+}//end namespace
@@ -0,0 +1,69 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2012 Mark Vejvoda, Titus Tscharntke
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "object_pool.h"
+#include "conversion.h"
+#include "thread.h"
+#include "platform_common.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+
+namespace Shared {
+	namespace Util {
+
+		// Most pools register during static initialization, function
+		// local ones on first use from whichever thread gets there
+		struct ObjectPoolRegistry {
+			Mutex mutex;
+			std::vector<ObjectPoolStats *> poolList;
+
+			ObjectPoolRegistry() : mutex(CODE_AT_LINE) {
+			}
+		};
+
+		static ObjectPoolRegistry &getRegistry() {
+			static ObjectPoolRegistry registry;
+			return registry;
+		}
+
+		// =====================================================
+		//	class ObjectPoolStats
+		// =====================================================
+
+		ObjectPoolStats::ObjectPoolStats(const char *name) : name(name), heapCount(0), reuseCount(0), releaseCount(0) {
+			ObjectPoolRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			registry.poolList.push_back(this);
+		}
+
+		std::vector<ObjectPoolStats *> ObjectPoolStats::getPoolList() {
+			ObjectPoolRegistry &registry = getRegistry();
+			MutexSafeWrapper safeMutex(&registry.mutex, CODE_AT_LINE);
+			return registry.poolList;
+		}
+
+		string ObjectPoolStats::getStatsText() {
+			string result = "";
+			std::vector<ObjectPoolStats *> poolList = getPoolList();
+			for (unsigned int i = 0; i < poolList.size(); ++i) {
+				const ObjectPoolStats *pool = poolList[i];
+				result += "Pool " + string(pool->getName()) +
+					": live " + intToStr(pool->getLiveCount()) +
+					" new " + intToStr(pool->getHeapCount()) +
+					" reused " + intToStr(pool->getReuseCount()) + "\n";
+			}
+			return result;
+		}
+
+	}
+}//end namespace
@@ -20,6 +20,7 @@
 
 using namespace std;
 using namespace Shared::Graphics;
+using Shared::Platform::uint32;
 
 namespace Shared {
 	namespace Util {
@@ -41,9 +42,27 @@ namespace Shared {
 			lastNumber = seed % m;
 		}
 
-		int RandomGen::rand(string lastCaller) {
-			if (lastCaller != "") {
-				this->lastCaller.push_back(lastCaller);
+		void RandomGen::init(int seed, RandomStream stream) {
+			init(getStreamSeed(seed, stream));
+		}
+
+		int RandomGen::getStreamSeed(int seed, RandomStream stream) {
+			if (stream == rsDefault) {
+				return seed;
+			}
+			// Integer hash of seed and stream, uses only unsigned 32 bit
+			// arithmetic so every platform derives the same stream seed
+			uint32 hash = static_cast<uint32>(seed) * 2654435761u;
+			hash ^= static_cast<uint32>(stream) * 0x9E3779B9u;
+			hash ^= hash >> 16;
+			hash *= 0x85EBCA6Bu;
+			hash ^= hash >> 13;
+			return static_cast<int>(hash % static_cast<uint32>(m));
+		}
+
+		int RandomGen::rand(const char *lastCaller) {
+			if (lastCaller != NULL && lastCaller[0] != '\0') {
+				addLastCaller(lastCaller);
 			}
 			this->lastNumber = (a*lastNumber + b) % m;
 			return lastNumber;
@@ -53,24 +72,36 @@ namespace Shared {
 			std::string result = "";
 			if (lastCaller.empty() == false) {
 				for (unsigned int index = 0; index < lastCaller.size(); ++index) {
-					result += lastCaller[index] + "|";
+					const LastCallerEntry &entry = lastCaller[index];
+					if (entry.callSite != NULL) {
+						result += entry.callSite;
+					} else {
+						result += entry.text;
+					}
+					result += "|";
 				}
 			}
 			return result;
 		}
 
 		void RandomGen::clearLastCaller() {
+			// clear() keeps the capacity so tracking stops allocating once warm
 			if (lastCaller.empty() == false) {
 				lastCaller.clear();
 			}
 		}
-		void RandomGen::addLastCaller(std::string text) {
+		void RandomGen::addLastCaller(const char *callSite) {
+			if (disableLastCallerTracking == false) {
+				lastCaller.push_back(LastCallerEntry(callSite, ""));
+			}
+		}
+		void RandomGen::addLastCaller(const std::string &text) {
 			if (disableLastCallerTracking == false) {
-				lastCaller.push_back(text);
+				lastCaller.push_back(LastCallerEntry(NULL, text));
 			}
 		}
 
-		int RandomGen::randRange(int min, int max, string lastCaller) {
+		int RandomGen::randRange(int min, int max, const char *lastCaller) {
 			if (min > max) {
 				char szBuf[8096] = "";
 				snprintf(szBuf, 8096, "In [%s::%s Line: %d] min > max, min = %d, max = %d", __FILE__, __FUNCTION__, __LINE__, min, max);
@@ -88,7 +119,14 @@ namespace Shared {
 			return res;
 		}
 
-		float RandomGen::randRange(float min, float max, string lastCaller) {
+		int RandomGen::randRange(int min, int max, const string &lastCaller) {
+			if (lastCaller != "") {
+				addLastCaller(lastCaller);
+			}
+			return randRange(min, max, (const char *) NULL);
+		}
+
+		float RandomGen::randRange(float min, float max, const char *lastCaller) {
 			if (min > max) {
 				char szBuf[8096] = "";
 				snprintf(szBuf, 8096, "In [%s::%s Line: %d] min > max, min = %f, max = %f", __FILE__, __FUNCTION__, __LINE__, min, max);
@@ -107,5 +145,12 @@ namespace Shared {
 			return res;
 		}
 
+		float RandomGen::randRange(float min, float max, const string &lastCaller) {
+			if (lastCaller != "") {
+				addLastCaller(lastCaller);
+			}
+			return randRange(min, max, (const char *) NULL);
+		}
+
 	}
 }//end namespace
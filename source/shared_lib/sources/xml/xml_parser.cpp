@@ -11,11 +11,14 @@
 
 #include "data_types.h"
 #include "xml_parser.h"
+#include "xml_tree_cache.h"
 
 #include <fstream>
 #include <stdexcept>
 #include <vector>
 #include <algorithm>
+#include <new>
+#include <cstring>
 
 #include "conversion.h"
 
@@ -32,6 +35,7 @@
 #include "platform_common.h"
 #include "platform_util.h"
 #include "cache_manager.h"
+#include "byte_order.h"
 
 #include "rapidxml/rapidxml_print.hpp"
 #include "leak_dumper.h"
@@ -50,6 +54,39 @@ namespace Shared {
 
 		using namespace Util;
 
+		// Parsed trees are stored as images: per node its name, text,
+		// attribute count, attribute name/value pairs and child count,
+		// followed by its children. Strings are 0 terminated.
+		static void writeImageString(vector<char> &image, const char *value) {
+			image.insert(image.end(), value, value + strlen(value) + 1);
+		}
+
+		static void writeImageCount(vector<char> &image, uint32 count) {
+			count = Shared::PlatformByteOrder::toCommonEndian(count);
+			const char *bytes = reinterpret_cast<const char *>(&count);
+			image.insert(image.end(), bytes, bytes + sizeof(count));
+		}
+
+		static const char *readImageString(const char *&image, const char *imageEnd) {
+			const char *terminator = (image < imageEnd ? static_cast<const char *>(memchr(image, 0, imageEnd - image)) : NULL);
+			if (terminator == NULL) {
+				throw megaglest_runtime_error("XML image is truncated");
+			}
+			const char *result = image;
+			image = terminator + 1;
+			return result;
+		}
+
+		static uint32 readImageCount(const char *&image, const char *imageEnd) {
+			if (imageEnd - image < (ptrdiff_t) sizeof(uint32)) {
+				throw megaglest_runtime_error("XML image is truncated");
+			}
+			uint32 count = 0;
+			memcpy(&count, image, sizeof(count));
+			image += sizeof(count);
+			return Shared::PlatformByteOrder::fromCommonEndian(count);
+		}
+
 		// =====================================================
 		//	class XmlIo
 		// =====================================================
@@ -332,7 +369,7 @@ namespace Shared {
 		}
 
 		XmlNode *XmlIoRapid::load(const string &path, const std::map<string, string> &mapTagReplacementValues,
-			bool noValidation, bool skipStackTrace, bool skipUpdatePathClimbingParts) {
+			bool noValidation, bool skipStackTrace, bool skipUpdatePathClimbingParts, vector<char> *image) {
 			bool showPerfStats = SystemFlags::VERBOSE_MODE_ENABLED;
 			Chrono chrono;
 			chrono.start();
@@ -340,6 +377,7 @@ namespace Shared {
 			//printf("Using RapidXml to load file [%s]\n",path.c_str());
 
 			XmlNode *rootNode = NULL;
+			XmlArena *arena = NULL;
 			try {
 
 				if (folderExists(path) == true) {
@@ -379,8 +417,10 @@ namespace Shared {
 				}
 				//printf("File size is: " MG_I64_SPECIFIER " for [%s]\n",file_size,path.c_str());
 
-				// Load data and add terminating 0
-				vector<char> buffer;
+				// Load data and add terminating 0. The buffer is kept by the
+				// arena of the loaded tree, attribute values point into it.
+				arena = new XmlArena(mapTagReplacementValues, skipUpdatePathClimbingParts);
+				vector<char> &buffer = arena->getBuffer();
 				buffer.resize((unsigned int) file_size + 100);
 				xmlFile.read(&buffer.front(), static_cast<streamsize>(file_size));
 				buffer[(unsigned int) file_size] = 0;
@@ -398,7 +438,14 @@ namespace Shared {
 
 				if (showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, chrono.getMillis());
 
-				rootNode = new XmlNode(doc.first_node(), mapTagReplacementValues, skipUpdatePathClimbingParts);
+				XmlArena *rootArena = arena;
+				arena = NULL;
+				rootNode = new XmlNode(doc.first_node(), rootArena, true);
+
+				if (image != NULL) {
+					image->clear();
+					XmlNode::writeImage(doc.first_node(), *image);
+				}
 
 				if (showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, chrono.getMillis());
 
@@ -408,12 +455,15 @@ namespace Shared {
 				}
 #endif
 			} catch (parse_error& ex) {
+				delete arena;
 				//		char szBuf[8096]="";
 				//		snprintf(szBuf,8096,"%s",ex.where<char>());
 				throw megaglest_runtime_error("Error loading XML: " + path + "\nMessage: " + ex.what(), true);
 			} catch (megaglest_runtime_error& ex) {
+				delete arena;
 				throw megaglest_runtime_error("Error loading XML: " + path + "\nMessage: " + ex.what(), !ex.wantStackTrace());
 			} catch (const exception &ex) {
+				delete arena;
 				char szBuf[8096] = "";
 
 				if (skipStackTrace == false) {
@@ -432,6 +482,20 @@ namespace Shared {
 			return rootNode;
 		}
 
+		XmlNode *XmlIoRapid::loadImage(vector<char> &image, const std::map<string, string> &mapTagReplacementValues,
+			bool skipUpdatePathClimbingParts) {
+			if (image.empty() == true) {
+				throw megaglest_runtime_error("XML image is empty");
+			}
+
+			// Attribute values point into the image kept by the arena
+			XmlArena *arena = new XmlArena(mapTagReplacementValues, skipUpdatePathClimbingParts);
+			arena->getBuffer().swap(image);
+			const char *imagePos = &arena->getBuffer().front();
+			const char *imageEnd = imagePos + arena->getBuffer().size();
+			return new XmlNode(imagePos, imageEnd, arena, true);
+		}
+
 		void XmlIoRapid::save(const string &path, const XmlNode *node) {
 			try {
 				if (node == NULL) {
@@ -565,7 +629,18 @@ namespace Shared {
 			} else
 #endif
 			{
-				this->rootNode = XmlIoRapid::getInstance().load(path, mapTagReplacementValues, noValidation, skipStackTrace, this->skipUpdatePathClimbingParts);
+				// Files of a cached folder are parsed only once
+				bool useTreeCache = XmlTreeCache::coversPath(path);
+				if (useTreeCache == true) {
+					this->rootNode = XmlTreeCache::loadTree(path, mapTagReplacementValues, this->skipUpdatePathClimbingParts);
+				}
+				if (this->rootNode == NULL) {
+					vector<char> image;
+					this->rootNode = XmlIoRapid::getInstance().load(path, mapTagReplacementValues, noValidation, skipStackTrace, this->skipUpdatePathClimbingParts, (useTreeCache == true ? &image : NULL));
+					if (useTreeCache == true) {
+						XmlTreeCache::storeTree(path, image);
+					}
+				}
 			}
 
 			if (SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] about to load [%s]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, path.c_str());
@@ -611,7 +686,8 @@ namespace Shared {
 
 #if defined(WANT_XERCES)
 
-		XmlNode::XmlNode(DOMNode *node, const std::map<string, string> &mapTagReplacementValues) : superNode(NULL) {
+		XmlNode::XmlNode(DOMNode *node, const std::map<string, string> &mapTagReplacementValues) :
+			name(&nameStorage), superNode(NULL), arena(NULL), ownsArena(false), inArena(false) {
 			if (node == NULL || node->getNodeName() == NULL) {
 				throw megaglest_runtime_error("XML structure seems to be corrupt!", true);
 			}
@@ -619,11 +695,11 @@ namespace Shared {
 			//get name
 			char str[strSize] = "";
 			XMLString::transcode(node->getNodeName(), str, strSize - 1);
-			name = str;
+			nameStorage = str;
 
 			//check document
 			if (node->getNodeType() == DOMNode::DOCUMENT_NODE) {
-				name = "document";
+				nameStorage = "document";
 			}
 
 			//check children
@@ -661,69 +737,190 @@ namespace Shared {
 #endif
 
 		XmlNode::XmlNode(xml_node<> *node, const std::map<string, string> &mapTagReplacementValues,
-			bool skipUpdatePathClimbingParts) : superNode(NULL) {
+			bool skipUpdatePathClimbingParts) : name(NULL), superNode(NULL), arena(NULL), ownsArena(true), inArena(false) {
 			if (node == NULL || node->name() == NULL) {
 				throw megaglest_runtime_error("XML structure seems to be corrupt!", true);
 			}
 
-			//get name
-			name = node->name();
-			children.reserve(1000);
-			attributes.reserve(1000);
+			// The caller owns the parsed buffer so values are copied
+			arena = new XmlArena(mapTagReplacementValues, skipUpdatePathClimbingParts);
+			try {
+				init(node);
+			} catch (...) {
+				delete arena;
+				arena = NULL;
+				throw;
+			}
+		}
 
-			//check document
-			if (node->type() == node_document) {
-				name = "document";
+		XmlNode::XmlNode(xml_node<> *node, XmlArena *arena, bool ownsArena) :
+			name(NULL), superNode(NULL), arena(arena), ownsArena(ownsArena), inArena(ownsArena == false) {
+			try {
+				init(node);
+			} catch (...) {
+				if (ownsArena == true) {
+					delete this->arena;
+					this->arena = NULL;
+				}
+				throw;
 			}
+		}
 
-			if (SystemFlags::VERBOSE_MODE_ENABLED) printf("Found XML Node\nName [%s]\nValue [%s]\n", name.c_str(), node->value());
+		XmlNode::XmlNode(const char *&image, const char *imageEnd, XmlArena *arena, bool ownsArena) :
+			name(NULL), superNode(NULL), arena(arena), ownsArena(ownsArena), inArena(ownsArena == false) {
+			try {
+				initFromImage(image, imageEnd);
+			} catch (...) {
+				if (ownsArena == true) {
+					delete this->arena;
+					this->arena = NULL;
+				}
+				throw;
+			}
+		}
+
+		void XmlNode::init(xml_node<> *node) {
+			if (node == NULL || node->name() == NULL) {
+				throw megaglest_runtime_error("XML structure seems to be corrupt!", true);
+			}
+
+			//get name, check document
+			name = arena->internName(node->type() == node_document ? "document" : node->name());
+
+			if (SystemFlags::VERBOSE_MODE_ENABLED) printf("Found XML Node\nName [%s]\nValue [%s]\n", name->c_str(), node->value());
+
+			unsigned int childCount = 0;
+			for (xml_node<> *currentNode = node->first_node();
+				currentNode; currentNode = currentNode->next_sibling()) {
+				if (currentNode->type() == node_element) {
+					childCount++;
+				}
+			}
+			unsigned int attributeCount = 0;
+			for (xml_attribute<> *attr = node->first_attribute();
+				attr; attr = attr->next_attribute()) {
+				attributeCount++;
+			}
+			children.reserve(childCount);
+			attributes.reserve(attributeCount);
 
 			//check children
 			for (xml_node<> *currentNode = node->first_node();
 				currentNode; currentNode = currentNode->next_sibling()) {
 				if (currentNode != NULL && currentNode->type() == node_element) {
-					XmlNode *xmlNode = new XmlNode(currentNode, mapTagReplacementValues, skipUpdatePathClimbingParts);
-					children.push_back(xmlNode);
+					children.push_back(arena->newNode(currentNode));
 				}
 			}
 
 			//check attributes
 			for (xml_attribute<> *attr = node->first_attribute();
 				attr; attr = attr->next_attribute()) {
-				XmlAttribute *xmlAttribute = new XmlAttribute(attr, mapTagReplacementValues);
-				attributes.push_back(xmlAttribute);
+				if (attr->name() == NULL) {
+					throw megaglest_runtime_error("XML attribute seems to be corrupt!");
+				}
+				attributes.push_back(arena->newAttribute(attr->name(), attr->value()));
 			}
 
 			//get value
 			if (node->type() == node_element && children.size() == 0) {
-				string xmlText = node->value();
+				setText(node->value());
+			}
+		}
+
+		void XmlNode::initFromImage(const char *&image, const char *imageEnd) {
+			name = arena->internName(readImageString(image, imageEnd));
+			const char *value = readImageString(image, imageEnd);
+
+			uint32 attributeCount = readImageCount(image, imageEnd);
+			attributes.reserve(attributeCount);
+			for (uint32 i = 0; i < attributeCount; ++i) {
+				const char *attributeName = readImageString(image, imageEnd);
+				const char *attributeValue = readImageString(image, imageEnd);
+				attributes.push_back(arena->newAttribute(attributeName, attributeValue));
+			}
+
+			uint32 childCount = readImageCount(image, imageEnd);
+			children.reserve(childCount);
+			for (uint32 i = 0; i < childCount; ++i) {
+				children.push_back(arena->newNode(image, imageEnd));
+			}
 
-				//		bool debugReplace = false;
-				//		if(xmlText.find("{SCENARIOPATH}") != string::npos) {
-				//			printf("\n----------------------\n** XML!! WILL REPLACE [%s]\n",xmlText.c_str());
-				//			debugReplace = true;
-				//		}
-				Properties::applyTagsToValue(xmlText, &mapTagReplacementValues, skipUpdatePathClimbingParts);
-				//		if(debugReplace) {
-				//			printf("\n\n** XML!! REPLACED WITH [%s]\n===================\n",xmlText.c_str());
-				//		}
-				text = xmlText;
+			if (children.size() == 0) {
+				setText(value);
 			}
 		}
 
-		XmlNode::XmlNode(const string &name) : superNode(NULL) {
-			this->name = name;
+		void XmlNode::setText(const char *value) {
+			text = value;
+			if (arena->mayContainTags(value) == true) {
+				Properties::applyTagsToValue(text, &arena->getTagReplacementValues(), arena->getSkipUpdatePathClimbingParts());
+			}
+		}
+
+		void XmlNode::writeImage(xml_node<> *node, vector<char> &image) {
+			if (node == NULL || node->name() == NULL) {
+				throw megaglest_runtime_error("XML structure seems to be corrupt!", true);
+			}
+
+			writeImageString(image, node->type() == node_document ? "document" : node->name());
+
+			uint32 childCount = 0;
+			for (xml_node<> *currentNode = node->first_node();
+				currentNode; currentNode = currentNode->next_sibling()) {
+				if (currentNode->type() == node_element) {
+					childCount++;
+				}
+			}
+			writeImageString(image, node->type() == node_element && childCount == 0 ? node->value() : "");
+
+			uint32 attributeCount = 0;
+			for (xml_attribute<> *attr = node->first_attribute();
+				attr; attr = attr->next_attribute()) {
+				attributeCount++;
+			}
+			writeImageCount(image, attributeCount);
+			for (xml_attribute<> *attr = node->first_attribute();
+				attr; attr = attr->next_attribute()) {
+				writeImageString(image, attr->name());
+				writeImageString(image, attr->value());
+			}
+
+			writeImageCount(image, childCount);
+			for (xml_node<> *currentNode = node->first_node();
+				currentNode; currentNode = currentNode->next_sibling()) {
+				if (currentNode->type() == node_element) {
+					writeImage(currentNode, image);
+				}
+			}
+		}
+
+		XmlNode::XmlNode(const string &name) : name(&nameStorage), nameStorage(name),
+			superNode(NULL), arena(NULL), ownsArena(false), inArena(false) {
 		}
 
 		XmlNode::~XmlNode() {
+			// Nodes from the arena are destroyed with it
 			for (unsigned int i = 0; i < children.size(); ++i) {
-				delete children[i];
+				if (children[i]->inArena == false) {
+					delete children[i];
+				}
 			}
 			children.clear();
 			for (unsigned int i = 0; i < attributes.size(); ++i) {
-				delete attributes[i];
+				if (attributes[i]->inArena == false) {
+					delete attributes[i];
+				}
 			}
 			attributes.clear();
+
+			if (ownsArena == true) {
+				delete arena;
+				arena = NULL;
+			}
+		}
+
+		const string *XmlNode::findName(const string &name) const {
+			return (arena != NULL ? arena->findName(name) : NULL);
 		}
 
 		XmlAttribute *XmlNode::getAttribute(unsigned int i) const {
@@ -734,8 +931,9 @@ namespace Shared {
 		}
 
 		XmlAttribute *XmlNode::getAttribute(const string &name, bool mustExist) const {
+			const string *internedName = findName(name);
 			for (unsigned int i = 0; i < attributes.size(); ++i) {
-				if (attributes[i]->getName() == name) {
+				if (arena != NULL ? attributes[i]->name == internedName : attributes[i]->getName() == name) {
 					return attributes[i];
 				}
 			}
@@ -748,8 +946,9 @@ namespace Shared {
 
 		bool XmlNode::hasAttribute(const string &name) const {
 			bool result = false;
+			const string *internedName = findName(name);
 			for (unsigned int i = 0; i < attributes.size(); ++i) {
-				if (attributes[i]->getName() == name) {
+				if (arena != NULL ? attributes[i]->name == internedName : attributes[i]->getName() == name) {
 					result = true;
 					break;
 				}
@@ -759,9 +958,12 @@ namespace Shared {
 
 		int XmlNode::clearChild(const string &childName) {
 			int clearChildCount = 0;
+			const string *internedName = findName(childName);
 			for (int i = (int) children.size() - 1; i >= 0; --i) {
-				if (children[i]->getName() == childName) {
-					delete children[i];
+				if (children[i]->isNamed(internedName, childName)) {
+					if (children[i]->inArena == false) {
+						delete children[i];
+					}
 					children.erase(children.begin() + i);
 					clearChildCount++;
 				}
@@ -779,8 +981,9 @@ namespace Shared {
 
 		vector<XmlNode *> XmlNode::getChildList(const string &childName) const {
 			vector<XmlNode *> list;
+			const string *internedName = findName(childName);
 			for (unsigned int j = 0; j < children.size(); ++j) {
-				if (children[j]->getName() == childName) {
+				if (children[j]->isNamed(internedName, childName)) {
 					list.push_back(children[j]);
 				}
 			}
@@ -793,12 +996,13 @@ namespace Shared {
 				return superNode->getChild(childName, i);
 			}
 			if (i >= children.size()) {
-				throw megaglest_runtime_error("\"" + name + "\" node doesn't have " + uIntToStr(i + 1) + " children named \"" + childName + "\"\n\nTree: " + getTreeString(), true);
+				throw megaglest_runtime_error("\"" + getName() + "\" node doesn't have " + uIntToStr(i + 1) + " children named \"" + childName + "\"\n\nTree: " + getTreeString(), true);
 			}
 
+			const string *internedName = findName(childName);
 			unsigned int count = 0;
 			for (unsigned int j = 0; j < children.size(); ++j) {
-				if (children[j]->getName() == childName) {
+				if (children[j]->isNamed(internedName, childName)) {
 					if (count == i) {
 						return children[j];
 					}
@@ -810,9 +1014,9 @@ namespace Shared {
 		}
 
 		bool XmlNode::hasChildNoSuper(const string &childName) const {
-			//int count= 0;
+			const string *internedName = findName(childName);
 			for (unsigned int j = 0; j < children.size(); ++j) {
-				if (children[j]->getName() == childName) {
+				if (children[j]->isNamed(internedName, childName)) {
 					return true;
 				}
 			}
@@ -825,12 +1029,13 @@ namespace Shared {
 					return superNode->getChild(childName, childIndex);
 				}
 				if (childIndex >= children.size()) {
-					throw megaglest_runtime_error("\"" + name + "\" node doesn't have " + intToStr(childIndex + 1) + " children named \"" + childName + "\"\n\nTree: " + getTreeString(), true);
+					throw megaglest_runtime_error("\"" + getName() + "\" node doesn't have " + intToStr(childIndex + 1) + " children named \"" + childName + "\"\n\nTree: " + getTreeString(), true);
 				}
 
+				const string *internedName = findName(childName);
 				unsigned int count = 0;
 				for (unsigned int j = 0; j < children.size(); ++j) {
-					if (children[j]->getName() == childName) {
+					if (children[j]->isNamed(internedName, childName)) {
 						if (count == childIndex) {
 							return children[j];
 						}
@@ -845,10 +1050,11 @@ namespace Shared {
 		bool XmlNode::hasChildAtIndex(const string &childName, int i) const {
 			if (superNode && !hasChildNoSuper(childName))
 				return superNode->hasChildAtIndex(childName, i);
+			const string *internedName = findName(childName);
 			int count = 0;
 			for (unsigned int j = 0; j < children.size(); ++j) {
 				//printf("Looking for [%s] at index: %d found [%s] index = %d\n",childName.c_str(),i,children[j]->getName().c_str(),j);
-				if (children[j]->getName() == childName) {
+				if (children[j]->isNamed(internedName, childName)) {
 					if (count == i) {
 						return true;
 					}
@@ -879,12 +1085,19 @@ namespace Shared {
 			assert(!superNode);
 			XmlNode *node = new XmlNode(name);
 			node->text = text;
+			if (arena != NULL) {
+				node->arena = arena;
+				node->name = arena->internName(name);
+			}
 			children.push_back(node);
 			return node;
 		}
 
 		XmlAttribute *XmlNode::addAttribute(const string &name, const string &value, const std::map<string, string> &mapTagReplacementValues) {
 			XmlAttribute *attr = new XmlAttribute(name, value, mapTagReplacementValues);
+			if (arena != NULL) {
+				attr->name = arena->internName(name);
+			}
 			attributes.push_back(attr);
 			return attr;
 		}
@@ -893,7 +1106,7 @@ namespace Shared {
 
 		DOMElement *XmlNode::buildElement(XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *document) const {
 			XMLCh str[strSize];
-			XMLString::transcode(name.c_str(), str, strSize - 1);
+			XMLString::transcode(name->c_str(), str, strSize - 1);
 
 			DOMElement *node = document->createElement(str);
 
@@ -917,7 +1130,7 @@ namespace Shared {
 #endif
 
 		xml_node<>* XmlNode::buildElement(xml_document<> *document) const {
-			xml_node<>* node = document->allocate_node(node_element, document->allocate_string(name.c_str()));
+			xml_node<>* node = document->allocate_node(node_element, document->allocate_string(name->c_str()));
 
 			for (unsigned int i = 0; i < attributes.size(); ++i) {
 				node->append_attribute(
@@ -956,62 +1169,63 @@ namespace Shared {
 
 #if defined(WANT_XERCES)
 
-		XmlAttribute::XmlAttribute(DOMNode *attribute, const std::map<string, string> &mapTagReplacementValues) {
+		XmlAttribute::XmlAttribute(DOMNode *attribute, const std::map<string, string> &mapTagReplacementValues) :
+			name(&nameStorage), rawValue(NULL), inArena(false) {
 			if (attribute == NULL || attribute->getNodeName() == NULL) {
 				throw megaglest_runtime_error("XML attribute seems to be corrupt!");
 			}
 
-			skipRestrictionCheck = false;
-			usesCommondata = false;
-			this->mapTagReplacementValues = mapTagReplacementValues;
 			char str[strSize] = "";
 
 			XMLString::transcode(attribute->getNodeValue(), str, strSize - 1);
-			value = str;
-			usesCommondata = ((value.find("$COMMONDATAPATH") != string::npos) || (value.find("%%COMMONDATAPATH%%") != string::npos));
-			skipRestrictionCheck = Properties::applyTagsToValue(this->value, &this->mapTagReplacementValues);
+			setValueWithTags(str, &mapTagReplacementValues, false);
 
 			XMLString::transcode(attribute->getNodeName(), str, strSize - 1);
-			name = str;
+			nameStorage = str;
 		}
 
 #endif
 
-		XmlAttribute::XmlAttribute(xml_attribute<> *attribute, const std::map<string, string> &mapTagReplacementValues) {
+		XmlAttribute::XmlAttribute(xml_attribute<> *attribute, const std::map<string, string> &mapTagReplacementValues) :
+			name(&nameStorage), rawValue(NULL), inArena(false) {
 			if (attribute == NULL || attribute->name() == NULL) {
 				throw megaglest_runtime_error("XML attribute seems to be corrupt!");
 			}
 
+			setValueWithTags(attribute->value(), &mapTagReplacementValues, false);
+			nameStorage = attribute->name();
+		}
+
+		XmlAttribute::XmlAttribute(const char *name, const char *value, XmlArena *arena) :
+			name(arena->internName(name)), rawValue(NULL), inArena(true) {
+			// Only values that may hold a tag go through the replacement,
+			// the path climbing setting of the tree applies to node text only
 			skipRestrictionCheck = false;
 			usesCommondata = false;
-			if (mapTagReplacementValues.size() > 0) {
-				this->mapTagReplacementValues = mapTagReplacementValues;
+			if (arena->mayContainTags(value) == true) {
+				setValueWithTags(value, &arena->getTagReplacementValues(), false);
+			} else if (arena->ownsStrings() == true) {
+				rawValue = value;
+			} else {
+				this->value = value;
 			}
-			//char str[strSize]				= "";
-
-			//XMLString::transcode(attribute->getNodeValue(), str, strSize-1);
-			value = attribute->value();
-			usesCommondata = ((value.find("$COMMONDATAPATH") != string::npos) || (value.find("%%COMMONDATAPATH%%") != string::npos));
-			skipRestrictionCheck = Properties::applyTagsToValue(this->value, &this->mapTagReplacementValues);
+		}
 
-			//XMLString::transcode(attribute->getNodeName(), str, strSize-1);
-			name = attribute->name();
+		XmlAttribute::XmlAttribute(const string &name, const string &value, const std::map<string, string> &mapTagReplacementValues) :
+			name(&nameStorage), nameStorage(name), rawValue(NULL), inArena(false) {
+			setValueWithTags(value, &mapTagReplacementValues, false);
 		}
 
-		XmlAttribute::XmlAttribute(const string &name, const string &value, const std::map<string, string> &mapTagReplacementValues) {
-			skipRestrictionCheck = false;
-			usesCommondata = false;
-			if (mapTagReplacementValues.size() > 0) {
-				this->mapTagReplacementValues = mapTagReplacementValues;
-			}
-			this->name = name;
+		void XmlAttribute::setValueWithTags(const string &value, const std::map<string, string> *mapTagReplacementValues, bool skipUpdatePathClimbingParts) {
+			this->rawValue = NULL;
 			this->value = value;
 
 			usesCommondata = ((value.find("$COMMONDATAPATH") != string::npos) || (value.find("%%COMMONDATAPATH%%") != string::npos));
-			skipRestrictionCheck = Properties::applyTagsToValue(this->value, &this->mapTagReplacementValues);
+			skipRestrictionCheck = Properties::applyTagsToValue(this->value, mapTagReplacementValues, skipUpdatePathClimbingParts);
 		}
 
 		bool XmlAttribute::getBoolValue() const {
+			const string value = getValueString();
 			if (value == "true") {
 				return true;
 			} else if (value == "false") {
@@ -1022,14 +1236,15 @@ namespace Shared {
 		}
 
 		int XmlAttribute::getIntValue() const {
-			return strToInt(value);
+			return strToInt(getValueString());
 		}
 
 		uint32 XmlAttribute::getUIntValue() const {
-			return strToUInt(value);
+			return strToUInt(getValueString());
 		}
 
 		int XmlAttribute::getIntValue(int min, int max) const {
+			const string value = getValueString();
 			int i = strToInt(value);
 			if (i<min || i>max) {
 				throw megaglest_runtime_error("Xml Attribute int out of range: " + getName() + ": " + value, true);
@@ -1038,10 +1253,11 @@ namespace Shared {
 		}
 
 		float XmlAttribute::getFloatValue() const {
-			return strToFloat(value);
+			return strToFloat(getValueString());
 		}
 
 		float XmlAttribute::getFloatValue(float min, float max) const {
+			const string value = getValueString();
 			float f = strToFloat(value);
 			//printf("getFloatValue f = %.10f [%s]\n",f,value.c_str());
 			if (f<min || f>max) {
@@ -1051,7 +1267,7 @@ namespace Shared {
 		}
 
 		const string XmlAttribute::getValue(string prefixValue, bool trimValueWithStartingSlash) const {
-			string result = value;
+			string result = getValueString();
 			if (skipRestrictionCheck == false && usesCommondata == false) {
 				if (trimValueWithStartingSlash == true) {
 					trimPathWithStartingSlash(result);
@@ -1062,6 +1278,7 @@ namespace Shared {
 		}
 
 		const string XmlAttribute::getRestrictedValue(string prefixValue, bool trimValueWithStartingSlash) const {
+			const string value = getValueString();
 			if (skipRestrictionCheck == false && usesCommondata == false) {
 				const string allowedCharacters = "abcdefghijklmnopqrstuvwxyz1234567890._-/";
 
@@ -1085,8 +1302,95 @@ namespace Shared {
 		}
 
 		void XmlAttribute::setValue(string val) {
+			rawValue = NULL;
 			value = val;
 		}
 
+		// =====================================================
+		//	class XmlArena
+		// =====================================================
+
+		// Nodes are constructed in place in the arena blocks
+#if defined(SL_LEAK_DUMP)
+#undef new
+#endif
+
+		XmlArena::XmlArena(const std::map<string, string> &mapTagReplacementValues, bool skipUpdatePathClimbingParts) {
+			this->mapTagReplacementValues = mapTagReplacementValues;
+			this->skipUpdatePathClimbingParts = skipUpdatePathClimbingParts;
+			blockUsed = blockSize;
+
+			// Characters every tag or path variable starts with
+			tagStartCharacters = "~$%{";
+			for (std::map<string, string>::const_iterator iterMap = mapTagReplacementValues.begin();
+				iterMap != mapTagReplacementValues.end(); ++iterMap) {
+				if (iterMap->first.empty() == false &&
+					tagStartCharacters.find(iterMap->first[0]) == string::npos) {
+					tagStartCharacters += iterMap->first[0];
+				}
+			}
+		}
+
+		XmlArena::~XmlArena() {
+			// A node is registered once its constructor returns, after all
+			// of its children. Going backwards destroys parents first, while
+			// the children they still look at are alive.
+			for (int i = (int) nodes.size() - 1; i >= 0; --i) {
+				nodes[i]->~XmlNode();
+			}
+			nodes.clear();
+			for (unsigned int i = 0; i < attributes.size(); ++i) {
+				attributes[i]->~XmlAttribute();
+			}
+			attributes.clear();
+			for (unsigned int i = 0; i < blocks.size(); ++i) {
+				delete[] blocks[i];
+			}
+			blocks.clear();
+		}
+
+		void *XmlArena::allocate(size_t size) {
+			const size_t alignment = 2 * sizeof(void *);
+			size = (size + alignment - 1) & ~(alignment - 1);
+			if (blockUsed + size > blockSize) {
+				blocks.push_back(new char[blockSize]);
+				blockUsed = 0;
+			}
+			void *result = blocks.back() + blockUsed;
+			blockUsed += size;
+			return result;
+		}
+
+		const string *XmlArena::internName(const string &name) {
+			return &*names.insert(name).first;
+		}
+
+		const string *XmlArena::findName(const string &name) const {
+			std::unordered_set<string>::const_iterator iterFind = names.find(name);
+			return (iterFind != names.end() ? &*iterFind : NULL);
+		}
+
+		bool XmlArena::mayContainTags(const char *value) const {
+			return (value != NULL && strpbrk(value, tagStartCharacters.c_str()) != NULL);
+		}
+
+		XmlNode *XmlArena::newNode(xml_node<> *node) {
+			XmlNode *result = ::new (allocate(sizeof(XmlNode))) XmlNode(node, this, false);
+			nodes.push_back(result);
+			return result;
+		}
+
+		XmlNode *XmlArena::newNode(const char *&image, const char *imageEnd) {
+			XmlNode *result = ::new (allocate(sizeof(XmlNode))) XmlNode(image, imageEnd, this, false);
+			nodes.push_back(result);
+			return result;
+		}
+
+		XmlAttribute *XmlArena::newAttribute(const char *name, const char *value) {
+			XmlAttribute *result = ::new (allocate(sizeof(XmlAttribute))) XmlAttribute(name, value, this);
+			attributes.push_back(result);
+			return result;
+		}
+
 	}
 }//end namespace
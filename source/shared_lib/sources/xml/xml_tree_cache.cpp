@@ -0,0 +1,240 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2001-2008 Martiño Figueroa
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "xml_tree_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include "xml_parser.h"
+#include "conversion.h"
+#include "checksum.h"
+#include "byte_order.h"
+#include "platform_common.h"
+#include "platform_util.h"
+#include "cache_manager.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::PlatformCommon;
+using namespace Shared::Util;
+
+namespace Shared {
+	namespace Xml {
+
+		typedef vector<XmlTreeCache *> ActiveTreeCacheList;
+		static string activeTreeCacheListName = string(__FILE__) + string("_activeTreeCacheListName");
+
+		static const char treeCacheFileId[] = "MGXC";
+
+		static bool writeCacheValue(FILE *fp, uint32 value) {
+			value = Shared::PlatformByteOrder::toCommonEndian(value);
+			return fwrite(&value, sizeof(value), 1, fp) == 1;
+		}
+
+		static bool readCacheValue(FILE *fp, uint32 &value) {
+			if (fread(&value, sizeof(value), 1, fp) != 1) {
+				return false;
+			}
+			value = Shared::PlatformByteOrder::fromCommonEndian(value);
+			return true;
+		}
+
+		// =====================================================
+		//	class XmlTreeCache
+		// =====================================================
+
+		XmlTreeCache::XmlTreeCache(const string &rootPath, uint32 contentChecksum, const string &cacheFile) {
+			this->rootPath = rootPath;
+			endPathWithSlash(this->rootPath);
+			this->cacheFile = cacheFile;
+			this->contentChecksum = contentChecksum;
+			this->changed = false;
+
+			if (cacheFile != "" && fileExists(cacheFile) == true && readFile() == false) {
+				entries.clear();
+				if (SystemFlags::VERBOSE_MODE_ENABLED) printf("Discarding XML cache [%s] for [%s]\n", cacheFile.c_str(), this->rootPath.c_str());
+			}
+
+			ActiveTreeCacheList &activeCaches = CacheManager::getCachedItem<ActiveTreeCacheList>(activeTreeCacheListName);
+			MutexSafeWrapper safeMutex(&CacheManager::getMutexForItem<ActiveTreeCacheList>(activeTreeCacheListName));
+			activeCaches.push_back(this);
+		}
+
+		XmlTreeCache::~XmlTreeCache() {
+			ActiveTreeCacheList &activeCaches = CacheManager::getCachedItem<ActiveTreeCacheList>(activeTreeCacheListName);
+			MutexSafeWrapper safeMutex(&CacheManager::getMutexForItem<ActiveTreeCacheList>(activeTreeCacheListName));
+			activeCaches.erase(std::remove(activeCaches.begin(), activeCaches.end(), this), activeCaches.end());
+			safeMutex.ReleaseLock();
+
+			if (changed == true && cacheFile != "") {
+				writeFile();
+			}
+		}
+
+		string XmlTreeCache::getCacheFileName(const string &rootPath) {
+			if (getCRCCacheFilePath() == "") {
+				return "";
+			}
+			Checksum checksum;
+			checksum.addString(rootPath);
+			return getCRCCacheFilePath() + "XML_CACHE_" + uIntToStr(checksum.getSum());
+		}
+
+		XmlTreeCache *XmlTreeCache::findCache(const string &path) {
+			ActiveTreeCacheList &activeCaches = CacheManager::getCachedItem<ActiveTreeCacheList>(activeTreeCacheListName);
+			for (unsigned int i = 0; i < activeCaches.size(); ++i) {
+				if (StartsWith(path, activeCaches[i]->rootPath) == true) {
+					return activeCaches[i];
+				}
+			}
+			return NULL;
+		}
+
+		bool XmlTreeCache::coversPath(const string &path) {
+			MutexSafeWrapper safeMutex(&CacheManager::getMutexForItem<ActiveTreeCacheList>(activeTreeCacheListName));
+			return findCache(path) != NULL;
+		}
+
+		XmlNode *XmlTreeCache::loadTree(const string &path, const std::map<string, string> &mapTagReplacementValues, bool skipUpdatePathClimbingParts) {
+			uint32 fileSize = (uint32) getFileSize(path);
+			uint32 fileTime = (uint32) getFileModificationTime(path);
+
+			vector<char> image;
+			MutexSafeWrapper safeMutex(&CacheManager::getMutexForItem<ActiveTreeCacheList>(activeTreeCacheListName));
+			XmlTreeCache *cache = findCache(path);
+			if (cache == NULL) {
+				return NULL;
+			}
+			EntryMap::const_iterator iterFind = cache->entries.find(path.substr(cache->rootPath.size()));
+			if (iterFind == cache->entries.end() || iterFind->second.fileSize != fileSize ||
+				iterFind->second.fileTime != fileTime) {
+				return NULL;
+			}
+			// The only copy of the image, the loaded tree keeps it
+			image = iterFind->second.image;
+			safeMutex.ReleaseLock();
+
+			try {
+				return XmlIoRapid::getInstance().loadImage(image, mapTagReplacementValues, skipUpdatePathClimbingParts);
+			} catch (const megaglest_runtime_error &ex) {
+				// Parsing the file again replaces the broken image
+				SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] Error [%s] loading cached [%s]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, ex.what(), path.c_str());
+			}
+			return NULL;
+		}
+
+		void XmlTreeCache::storeTree(const string &path, vector<char> &image) {
+			uint32 fileSize = (uint32) getFileSize(path);
+			uint32 fileTime = (uint32) getFileModificationTime(path);
+
+			MutexSafeWrapper safeMutex(&CacheManager::getMutexForItem<ActiveTreeCacheList>(activeTreeCacheListName));
+			XmlTreeCache *cache = findCache(path);
+			if (cache != NULL && image.empty() == false) {
+				Entry &entry = cache->entries[path.substr(cache->rootPath.size())];
+				entry.fileSize = fileSize;
+				entry.fileTime = fileTime;
+				entry.image.swap(image);
+				cache->changed = true;
+			}
+		}
+
+		bool XmlTreeCache::readFile() {
+#ifdef WIN32
+			FILE *fp = _wfopen(utf8_decode(cacheFile).c_str(), L"rb");
+#else
+			FILE *fp = fopen(cacheFile.c_str(), "rb");
+#endif
+			if (fp == NULL) {
+				return false;
+			}
+
+			char fileId[sizeof(treeCacheFileId)] = "";
+			uint32 version = 0;
+			uint32 checksum = 0;
+			uint32 entryCount = 0;
+			bool result = (fread(fileId, sizeof(treeCacheFileId) - 1, 1, fp) == 1 &&
+				strcmp(fileId, treeCacheFileId) == 0 &&
+				readCacheValue(fp, version) == true && version == formatVersion &&
+				readCacheValue(fp, checksum) == true && checksum == contentChecksum &&
+				readCacheValue(fp, entryCount) == true);
+
+			for (uint32 i = 0; result == true && i < entryCount; ++i) {
+				uint32 pathSize = 0;
+				uint32 imageSize = 0;
+				Entry entry;
+				result = (readCacheValue(fp, pathSize) == true && pathSize < 8192 &&
+					readCacheValue(fp, entry.fileSize) == true &&
+					readCacheValue(fp, entry.fileTime) == true &&
+					readCacheValue(fp, imageSize) == true && imageSize > 0);
+				if (result == true) {
+					string path(pathSize, '\0');
+					entry.image.resize(imageSize);
+					result = ((pathSize == 0 || fread(&path[0], pathSize, 1, fp) == 1) &&
+						fread(&entry.image.front(), imageSize, 1, fp) == 1);
+					if (result == true) {
+						Entry &loadedEntry = entries[path];
+						loadedEntry.fileSize = entry.fileSize;
+						loadedEntry.fileTime = entry.fileTime;
+						loadedEntry.image.swap(entry.image);
+					}
+				}
+			}
+			fclose(fp);
+
+			if (SystemFlags::VERBOSE_MODE_ENABLED) printf("Read %d cached XML files for [%s] result = %d\n", (int) entries.size(), rootPath.c_str(), result);
+			return result;
+		}
+
+		void XmlTreeCache::writeFile() {
+			// Write to a temporary file so a crash never leaves half a cache
+			string tempFile = cacheFile + ".tmp";
+#ifdef WIN32
+			FILE *fp = _wfopen(utf8_decode(tempFile).c_str(), L"wb");
+#else
+			FILE *fp = fopen(tempFile.c_str(), "wb");
+#endif
+			if (fp == NULL) {
+				SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] Can not write XML cache [%s]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, tempFile.c_str());
+				return;
+			}
+
+			bool result = (fwrite(treeCacheFileId, sizeof(treeCacheFileId) - 1, 1, fp) == 1 &&
+				writeCacheValue(fp, formatVersion) == true &&
+				writeCacheValue(fp, contentChecksum) == true &&
+				writeCacheValue(fp, (uint32) entries.size()) == true);
+
+			for (EntryMap::const_iterator iterMap = entries.begin();
+				result == true && iterMap != entries.end(); ++iterMap) {
+				const string &path = iterMap->first;
+				const Entry &entry = iterMap->second;
+				result = (writeCacheValue(fp, (uint32) path.size()) == true &&
+					writeCacheValue(fp, entry.fileSize) == true &&
+					writeCacheValue(fp, entry.fileTime) == true &&
+					writeCacheValue(fp, (uint32) entry.image.size()) == true &&
+					(path.empty() == true || fwrite(path.c_str(), path.size(), 1, fp) == 1) &&
+					fwrite(&entry.image.front(), entry.image.size(), 1, fp) == 1);
+			}
+			fclose(fp);
+
+			if (result == true) {
+				removeFile(cacheFile);
+				result = (rename(tempFile.c_str(), cacheFile.c_str()) == 0);
+			}
+			if (result == false) {
+				removeFile(tempFile);
+				SystemFlags::OutputDebug(SystemFlags::debugError, "In [%s::%s Line: %d] Can not write XML cache [%s]\n", extractFileFromDirectoryPath(__FILE__).c_str(), __FUNCTION__, __LINE__, cacheFile.c_str());
+			}
+			changed = false;
+		}
+
+	}
+}//end namespace
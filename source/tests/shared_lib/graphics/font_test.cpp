@@ -32,12 +32,44 @@ class FontTest : public CppUnit::TestFixture {
 
 	CPPUNIT_TEST( test_LTR_RTL_Mixed );
 	CPPUNIT_TEST( test_bidi_newline_handling );
+	CPPUNIT_TEST( test_metrics_text_cache );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
 
 public:
 
+	void test_metrics_text_cache() {
+		FontMetrics metrics;
+		metrics.setWidth('a', 2.0f);
+		metrics.setWidth('b', 3.0f);
+		metrics.setWidth(' ', 1.0f);
+
+		CPPUNIT_ASSERT_EQUAL( 0,metrics.getTextCacheSize() );
+		CPPUNIT_ASSERT_EQUAL( 7.0f,metrics.getTextWidth("aab") );
+		// Longest line wins for multi line text
+		CPPUNIT_ASSERT_EQUAL( 9.0f,metrics.getTextWidth("a\nbbb\nab") );
+		CPPUNIT_ASSERT_EQUAL( 2,metrics.getTextCacheSize() );
+		CPPUNIT_ASSERT_EQUAL( 7.0f,metrics.getTextWidth("aab") );
+		CPPUNIT_ASSERT_EQUAL( 2,metrics.getTextCacheSize() );
+
+		CPPUNIT_ASSERT_EQUAL( string("aa bb \nab "),metrics.wordWrapText("aa bb ab",11) );
+		CPPUNIT_ASSERT_EQUAL( string("aa bb \nab "),metrics.wordWrapText("aa bb ab",11) );
+
+		// Changing a glyph width must drop stale measurements
+		metrics.setWidth('a', 4.0f);
+		CPPUNIT_ASSERT_EQUAL( 0,metrics.getTextCacheSize() );
+		CPPUNIT_ASSERT_EQUAL( 11.0f,metrics.getTextWidth("aab") );
+
+		int oldMaxEntries = FontMetrics::textCacheMaxEntries;
+		FontMetrics::textCacheMaxEntries = 2;
+		metrics.getTextWidth("a");
+		metrics.getTextWidth("b");
+		metrics.getTextWidth("ab");
+		CPPUNIT_ASSERT_EQUAL( 2,metrics.getTextCacheSize() );
+		FontMetrics::textCacheMaxEntries = oldMaxEntries;
+	}
+
 	void test_bidi_newline_handling() {
 
 		string text = "\n\nHP: 9000/9000\nArmor: 0 (Stone)\nSight: 15\nProduce Slave";
@@ -0,0 +1,141 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "model.h"
+#include "model_batch.h"
+
+using namespace Shared::Graphics;
+
+class TestBatchModel : public Model {
+public:
+	virtual void init() {}
+	virtual void end() {}
+};
+
+//
+// Tests for ModelBatchList
+//
+class ModelBatchTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ModelBatchTest );
+
+	CPPUNIT_TEST( test_groups_by_model_and_pose );
+	CPPUNIT_TEST( test_orders_by_texture );
+	CPPUNIT_TEST( test_instance_transform );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	ModelInstance makeInstance(float x, float animProgress) {
+		ModelInstance instance;
+		instance.setTransform(Vec3f(x, 0.f, 0.f), 0.f);
+		instance.animProgress = animProgress;
+		return instance;
+	}
+
+public:
+
+	void test_groups_by_model_and_pose() {
+		TestBatchModel tree;
+		TestBatchModel rock;
+
+		ModelBatchList batchList;
+		batchList.add(&tree, makeInstance(1, 0.f));
+		batchList.add(&rock, makeInstance(2, 0.f));
+		batchList.add(&tree, makeInstance(3, 0.f));
+		batchList.add(&tree, makeInstance(4, 0.5f));
+		batchList.add(&rock, makeInstance(5, 0.f));
+		batchList.build();
+
+		const vector<ModelBatch> &batches = batchList.getBatches();
+		const vector<ModelInstance> &instances = batchList.getInstances();
+		CPPUNIT_ASSERT_EQUAL( 3,(int)batches.size() );
+		CPPUNIT_ASSERT_EQUAL( 5,batchList.getInstanceCount() );
+
+		int treeBatches = 0;
+		for(unsigned int index = 0; index < batches.size(); ++index) {
+			const ModelBatch &batch = batches[index];
+			if(batch.model == &rock) {
+				// Instances of a batch keep the order they were added in
+				CPPUNIT_ASSERT_EQUAL( 2,batch.instanceCount );
+				CPPUNIT_ASSERT_EQUAL( 2.f,instances[batch.firstInstance].transform[12] );
+				CPPUNIT_ASSERT_EQUAL( 5.f,instances[batch.firstInstance + 1].transform[12] );
+			}
+			else {
+				CPPUNIT_ASSERT( batch.model == &tree );
+				treeBatches++;
+				if(batch.animProgress == 0.f) {
+					CPPUNIT_ASSERT_EQUAL( 2,batch.instanceCount );
+					CPPUNIT_ASSERT_EQUAL( 1.f,instances[batch.firstInstance].transform[12] );
+					CPPUNIT_ASSERT_EQUAL( 3.f,instances[batch.firstInstance + 1].transform[12] );
+				}
+				else {
+					CPPUNIT_ASSERT_EQUAL( 1,batch.instanceCount );
+					CPPUNIT_ASSERT_EQUAL( 4.f,instances[batch.firstInstance].transform[12] );
+				}
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL( 2,treeBatches );
+
+		// Batches cover the instances in order without gaps
+		int nextInstance = 0;
+		for(unsigned int index = 0; index < batches.size(); ++index) {
+			CPPUNIT_ASSERT_EQUAL( nextInstance,batches[index].firstInstance );
+			nextInstance += batches[index].instanceCount;
+		}
+
+		batchList.clear();
+		batchList.build();
+		CPPUNIT_ASSERT( batchList.getBatches().empty() );
+	}
+
+	void test_orders_by_texture() {
+		TestBatchModel modelA;
+		TestBatchModel modelB;
+		TestBatchModel modelC;
+
+		// Models sharing a texture end up next to each other
+		const Texture *sharedTexture = reinterpret_cast<const Texture *>(0x2000);
+		const Texture *otherTexture = reinterpret_cast<const Texture *>(0x1000);
+
+		ModelBatchList batchList;
+		batchList.add(&modelA, sharedTexture, makeInstance(1, 0.f));
+		batchList.add(&modelB, otherTexture, makeInstance(2, 0.f));
+		batchList.add(&modelC, sharedTexture, makeInstance(3, 0.f));
+		batchList.build();
+
+		const vector<ModelBatch> &batches = batchList.getBatches();
+		CPPUNIT_ASSERT_EQUAL( 3,(int)batches.size() );
+		CPPUNIT_ASSERT( batches[0].model == &modelB );
+		CPPUNIT_ASSERT( (batches[1].model == &modelA && batches[2].model == &modelC) ||
+						(batches[1].model == &modelC && batches[2].model == &modelA) );
+	}
+
+	void test_instance_transform() {
+		ModelInstance instance;
+		instance.setTransform(Vec3f(1.f, 2.f, 3.f), 90.f);
+
+		// Rotating +x by 90 degrees around y gives -z, like glRotatef
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0,instance.transform[0],0.0001 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( -1.0,instance.transform[2],0.0001 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0,instance.transform[8],0.0001 );
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0,instance.transform[5],0.0001 );
+		CPPUNIT_ASSERT_EQUAL( 1.f,instance.transform[12] );
+		CPPUNIT_ASSERT_EQUAL( 2.f,instance.transform[13] );
+		CPPUNIT_ASSERT_EQUAL( 3.f,instance.transform[14] );
+		CPPUNIT_ASSERT_EQUAL( 1.f,instance.transform[15] );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ModelBatchTest );
+//
@@ -12,6 +12,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <memory>
 #include "model.h"
+#include "interpolation.h"
 #include <vector>
 #include <algorithm>
 
@@ -38,6 +39,7 @@ class ModelTest : public CppUnit::TestFixture {
 
 	CPPUNIT_TEST( test_ColorPicking_loop );
 	CPPUNIT_TEST( test_ColorPicking_prime );
+	CPPUNIT_TEST( test_interpolation_lerp_frames );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
@@ -100,6 +102,25 @@ public:
 		BaseColorPickEntity::setTrackColorUse(false);
 	}
 
+
+	void test_interpolation_lerp_frames() {
+		const unsigned int vertexCount = 5;
+		Vec3f prevFrame[vertexCount];
+		Vec3f nextFrame[vertexCount];
+		for(unsigned int i = 0; i < vertexCount; ++i) {
+			prevFrame[i] = Vec3f(i * 1.0f, i * -2.0f, 0.5f);
+			nextFrame[i] = Vec3f(i * 3.0f, 4.0f, i * 0.25f);
+		}
+
+		Vec3f result[vertexCount];
+		InterpolationData::lerpFrames(prevFrame, nextFrame, result, vertexCount, 0.375f);
+		for(unsigned int i = 0; i < vertexCount; ++i) {
+			Vec3f expected = prevFrame[i].lerp(0.375f, nextFrame[i]);
+			CPPUNIT_ASSERT_EQUAL( expected.x,result[i].x );
+			CPPUNIT_ASSERT_EQUAL( expected.y,result[i].y );
+			CPPUNIT_ASSERT_EQUAL( expected.z,result[i].z );
+		}
+	}
 };
 
 
@@ -0,0 +1,80 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "particle.h"
+
+using namespace Shared::Graphics;
+
+class TestParticleOwner : public ParticleOwner {
+public:
+	int endCount;
+
+	TestParticleOwner() : endCount(0) {}
+	virtual void end(ParticleSystem *particleSystem) {
+		endCount++;
+	}
+	virtual void logParticleInfo(string info) {}
+};
+
+//
+// Tests for ParticleManager
+//
+class ParticleManagerTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ParticleManagerTest );
+
+	CPPUNIT_TEST( test_removes_by_owner );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+public:
+
+	void test_removes_by_owner() {
+		TestParticleOwner firstOwner;
+		TestParticleOwner secondOwner;
+		ParticleManager particleManager;
+
+		vector<ParticleSystem *> systems;
+		for (int i = 0; i < 6; ++i) {
+			ParticleSystem *ps = new UnitParticleSystem(10);
+			ps->setParticleOwner(i % 2 == 0 ? &firstOwner : NULL);
+			particleManager.manage(ps);
+			systems.push_back(ps);
+		}
+		// Owners set after manage are indexed as well
+		systems[1]->setParticleOwner(&secondOwner);
+		CPPUNIT_ASSERT_EQUAL( 6, particleManager.getParticleSystemCount() );
+
+		particleManager.removeParticleSystemsForParticleOwner(&firstOwner);
+		CPPUNIT_ASSERT_EQUAL( 3, firstOwner.endCount );
+		CPPUNIT_ASSERT_EQUAL( 3, particleManager.getParticleSystemCount() );
+		CPPUNIT_ASSERT( particleManager.validateParticleSystemStillExists(systems[1]) );
+		CPPUNIT_ASSERT( particleManager.validateParticleSystemStillExists(systems[3]) );
+
+		particleManager.cleanupParticleSystems(systems[3]);
+		CPPUNIT_ASSERT( particleManager.validateParticleSystemStillExists(systems[3]) == false );
+		CPPUNIT_ASSERT_EQUAL( 2, particleManager.getParticleSystemCount() );
+
+		particleManager.update();
+		particleManager.removeParticleSystemsForParticleOwner(&secondOwner);
+		CPPUNIT_ASSERT_EQUAL( 1, secondOwner.endCount );
+		CPPUNIT_ASSERT( particleManager.validateParticleSystemStillExists(systems[5]) );
+
+		particleManager.end();
+		CPPUNIT_ASSERT_EQUAL( 0, particleManager.getParticleSystemCount() );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ParticleManagerTest );
+//
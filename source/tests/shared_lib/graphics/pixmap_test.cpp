@@ -0,0 +1,259 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include "pixmap.h"
+#include "randomgen.h"
+#include "platform_common.h"
+
+using namespace Shared::Graphics;
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+
+static void fillPixmap(Pixmap2D &pixmap, int seed) {
+	uint8 *pixels = pixmap.getPixels();
+	for (std::size_t i = 0; i < pixmap.getPixelByteCount(); ++i) {
+		pixels[i] = static_cast<uint8>((i * 31 + seed * 17) % 256);
+	}
+}
+
+// The splat as it was written per pixel, to compare against
+static void referenceSplat(Pixmap2D &target, const Pixmap2D *corners[4]) {
+	RandomGen random;
+	int w = target.getW();
+	int h = target.getH();
+	for (int i = 0; i < w; ++i) {
+		for (int j = 0; j < h; ++j) {
+			float avg = std::pow((w + h) / 2.f, 2.0f);
+			Vec2i cornerPos[4] = { Vec2i(0, 0), Vec2i(w, 0), Vec2i(0, h), Vec2i(w, h) };
+			float weight[4];
+			for (int corner = 0; corner < 4; ++corner) {
+				Vec2i a(i, j);
+				Vec2i b = cornerPos[corner];
+				float dist = (std::max(abs(a.x - b.x), abs(a.y - b.y)) + 3.f*a.dist(b)) / 4.f;
+				dist = std::pow(dist, 2.0f);
+				weight[corner] = dist > avg ? 0 : ((avg - dist))*random.randRange(0.5f, 1.0f);
+			}
+			float total = weight[0] + weight[1] + weight[2] + weight[3];
+			Vec4f pix = (corners[0]->getPixel4f(i, j)*weight[0] +
+				corners[1]->getPixel4f(i, j)*weight[1] +
+				corners[2]->getPixel4f(i, j)*weight[2] +
+				corners[3]->getPixel4f(i, j)*weight[3])*(1.0f / total);
+			target.setPixel(i, j, pix);
+		}
+	}
+}
+
+static void referenceLerp(Pixmap2D &target, float t, const Pixmap2D *first, const Pixmap2D *second) {
+	for (int y = 0; y < target.getH(); ++y) {
+		for (int x = 0; x < target.getW(); ++x) {
+			target.setPixel(x, y, first->getPixel4f(x, y).lerp(t, second->getPixel4f(x, y)));
+		}
+	}
+}
+
+static void referenceSubCopy(Pixmap2D &target, int x, int y, const Pixmap2D *source) {
+	uint8 pixel[4];
+	for (int j = 0; j < source->getH(); ++j) {
+		for (int i = 0; i < source->getW(); ++i) {
+			source->getPixel(i, j, pixel);
+			target.setPixel(x + i, y + j, pixel, source->getComponents());
+		}
+	}
+}
+
+//
+// Tests for Pixmap2D operations
+//
+class PixmapTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( PixmapTest );
+
+	CPPUNIT_TEST( test_splat_matches_per_pixel );
+	CPPUNIT_TEST( test_lerp );
+	CPPUNIT_TEST( test_sub_copy );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+public:
+
+	void test_splat_matches_per_pixel() {
+		Pixmap2D sources[4];
+		const Pixmap2D *corners[4];
+		for (int corner = 0; corner < 4; ++corner) {
+			// Mixed component counts take the missing channels as 0
+			sources[corner].init(32, 32, corner == 1 ? 3 : 4);
+			fillPixmap(sources[corner], corner);
+			corners[corner] = &sources[corner];
+		}
+
+		Pixmap2D splatted(32, 32, 4);
+		splatted.splat(corners[0], corners[1], corners[2], corners[3]);
+		Pixmap2D expected(32, 32, 4);
+		referenceSplat(expected, corners);
+
+		CPPUNIT_ASSERT( memcmp(splatted.getPixels(), expected.getPixels(), expected.getPixelByteCount()) == 0 );
+	}
+
+	void test_lerp() {
+		Pixmap2D first(8, 8, 3);
+		Pixmap2D second(8, 8, 3);
+		fillPixmap(first, 1);
+		fillPixmap(second, 2);
+
+		Pixmap2D result(8, 8, 3);
+		result.lerp(0.f, &first, &second);
+		CPPUNIT_ASSERT( memcmp(result.getPixels(), first.getPixels(), first.getPixelByteCount()) == 0 );
+
+		result.lerp(0.3f, &first, &second);
+		for (int y = 0; y < 8; ++y) {
+			for (int x = 0; x < 8; ++x) {
+				Vec4f expected = first.getPixel4f(x, y).lerp(0.3f, second.getPixel4f(x, y));
+				uint8 pixel[3];
+				result.getPixel(x, y, pixel);
+				CPPUNIT_ASSERT_EQUAL( static_cast<int>(static_cast<uint8>(expected.x * 255.f)), static_cast<int>(pixel[0]) );
+				CPPUNIT_ASSERT_EQUAL( static_cast<int>(static_cast<uint8>(expected.z * 255.f)), static_cast<int>(pixel[2]) );
+			}
+		}
+	}
+
+	void test_sub_copy() {
+		Pixmap2D target(16, 16, 4);
+		const uint8 black[4] = { 0, 0, 0, 0 };
+		target.setPixels(black, 4);
+		Pixmap2D source(4, 3, 4);
+		fillPixmap(source, 5);
+
+		target.subCopy(10, 12, &source);
+		uint8 expected[4];
+		uint8 pixel[4];
+		source.getPixel(3, 2, expected);
+		target.getPixel(13, 14, pixel);
+		CPPUNIT_ASSERT( memcmp(expected, pixel, 4) == 0 );
+		target.getPixel(9, 12, pixel);
+		CPPUNIT_ASSERT_EQUAL( 0, static_cast<int>(pixel[0]) );
+
+		Pixmap2D part(4, 3, 4);
+		part.copyImagePart(10, 12, &target);
+		CPPUNIT_ASSERT( memcmp(part.getPixels(), source.getPixels(), source.getPixelByteCount()) == 0 );
+	}
+};
+
+//
+// Timings of the Pixmap2D row kernels against the per-pixel versions.
+// Registered in the "benchmark" registry only, run them with
+// zetaglest_tests --benchmark
+//
+class PixmapBenchmark : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( PixmapBenchmark );
+
+	CPPUNIT_TEST( bench_splat );
+	CPPUNIT_TEST( bench_lerp );
+	CPPUNIT_TEST( bench_sub_copy );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	// Map sized, as the terrain splats are built
+	static const int size = 256;
+	static const int runs = 8;
+
+	Pixmap2D sources[4];
+	const Pixmap2D *corners[4];
+
+	void printTimes(const char *operation, int64 kernelMillis, int64 referenceMillis) {
+		printf("\nPixmap2D::%s %dx%d: %.2f msecs per call, per pixel %.2f msecs\n",
+			operation, size, size, kernelMillis / (double) runs, referenceMillis / (double) runs);
+	}
+
+public:
+
+	void setUp() {
+		for (int corner = 0; corner < 4; ++corner) {
+			sources[corner].init(size, size, 4);
+			fillPixmap(sources[corner], corner);
+			corners[corner] = &sources[corner];
+		}
+	}
+
+	void bench_splat() {
+		Pixmap2D splatted(size, size, 4);
+		Pixmap2D expected(size, size, 4);
+
+		Chrono chrono;
+		chrono.start();
+		for (int i = 0; i < runs; ++i) {
+			splatted.splat(corners[0], corners[1], corners[2], corners[3]);
+		}
+		int64 kernelMillis = chrono.getMillis();
+
+		Chrono referenceChrono;
+		referenceChrono.start();
+		for (int i = 0; i < runs; ++i) {
+			referenceSplat(expected, corners);
+		}
+		printTimes("splat", kernelMillis, referenceChrono.getMillis());
+		CPPUNIT_ASSERT( memcmp(splatted.getPixels(), expected.getPixels(), expected.getPixelByteCount()) == 0 );
+	}
+
+	void bench_lerp() {
+		Pixmap2D result(size, size, 4);
+		Pixmap2D expected(size, size, 4);
+
+		Chrono chrono;
+		chrono.start();
+		for (int i = 0; i < runs; ++i) {
+			result.lerp(0.3f, corners[0], corners[1]);
+		}
+		int64 kernelMillis = chrono.getMillis();
+
+		Chrono referenceChrono;
+		referenceChrono.start();
+		for (int i = 0; i < runs; ++i) {
+			referenceLerp(expected, 0.3f, corners[0], corners[1]);
+		}
+		printTimes("lerp", kernelMillis, referenceChrono.getMillis());
+	}
+
+	void bench_sub_copy() {
+		Pixmap2D target(size * 2, size * 2, 4);
+		Pixmap2D expected(size * 2, size * 2, 4);
+		const uint8 black[4] = { 0, 0, 0, 0 };
+		target.setPixels(black, 4);
+		expected.setPixels(black, 4);
+
+		Chrono chrono;
+		chrono.start();
+		for (int i = 0; i < runs; ++i) {
+			target.subCopy(i, size / 2, corners[0]);
+		}
+		int64 kernelMillis = chrono.getMillis();
+
+		Chrono referenceChrono;
+		referenceChrono.start();
+		for (int i = 0; i < runs; ++i) {
+			referenceSubCopy(expected, i, size / 2, corners[0]);
+		}
+		printTimes("subCopy", kernelMillis, referenceChrono.getMillis());
+		CPPUNIT_ASSERT( memcmp(target.getPixels(), expected.getPixels(), expected.getPixelByteCount()) == 0 );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( PixmapTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( PixmapBenchmark, "benchmark" );
+//
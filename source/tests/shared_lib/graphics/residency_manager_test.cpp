@@ -0,0 +1,110 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cstdio>
+#include <cstring>
+#include "texture.h"
+#include "residency_manager.h"
+
+using namespace Shared::Graphics;
+
+// Stands in for the GL texture, init only marks it as uploaded
+class TestTexture2D : public Texture2D {
+public:
+	virtual void init(Filter filter, int maxAnisotropy) {
+		ensurePixels();
+		inited = true;
+	}
+	virtual void end(bool deletePixelBuffer) {
+		inited = false;
+	}
+};
+
+static void advanceFrames(uint32 frameCount) {
+	for (uint32 i = 0; i < frameCount; ++i) {
+		ResidencyManager::nextFrame();
+	}
+}
+
+//
+// Tests for ResidencyManager
+//
+class ResidencyManagerTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ResidencyManagerTest );
+
+	CPPUNIT_TEST( test_evicts_idle_uploaded_textures );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+private:
+	string testFile;
+
+public:
+
+	void setUp() {
+		testFile = "residency_test.tga";
+		Pixmap2D source(8, 8, 4);
+		uint8 *pixels = source.getPixels();
+		for (std::size_t i = 0; i < source.getPixelByteCount(); ++i) {
+			pixels[i] = static_cast<uint8>(i * 7);
+		}
+		source.save(testFile);
+	}
+
+	void tearDown() {
+		ResidencyManager::setTexturePixelBudget(-1);
+		std::remove(testFile.c_str());
+	}
+
+	void test_evicts_idle_uploaded_textures() {
+		TestTexture2D uploaded;
+		uploaded.load(testFile);
+		TestTexture2D notUploaded;
+		notUploaded.load(testFile);
+		TestTexture2D modified;
+		modified.load(testFile);
+		modified.getPixmap();
+
+		Pixmap2D expected;
+		expected.init(4);
+		expected.load(testFile);
+		CPPUNIT_ASSERT( memcmp(uploaded.getPixmapConst()->getPixels(), expected.getPixels(), expected.getPixelByteCount()) == 0 );
+
+		uploaded.init(Texture::fBilinear, 1);
+		modified.init(Texture::fBilinear, 1);
+		ResidencyManager::setTexturePixelBudget(0);
+		int64 evictedCount = ResidencyManager::getEvictedCount();
+		int64 reloadedCount = ResidencyManager::getReloadedCount();
+
+		// Recently used textures are kept
+		CPPUNIT_ASSERT_EQUAL( 0, ResidencyManager::enforceBudget() );
+
+		advanceFrames(ResidencyManager::minIdleFrames + ResidencyManager::checkIntervalFrames);
+		CPPUNIT_ASSERT( uploaded.hasPixelData() == false );
+		CPPUNIT_ASSERT( notUploaded.hasPixelData() == true );
+		CPPUNIT_ASSERT( modified.hasPixelData() == true );
+		CPPUNIT_ASSERT_EQUAL( evictedCount + 1, ResidencyManager::getEvictedCount() );
+
+		// Reading the pixels brings them back from the file
+		CPPUNIT_ASSERT( memcmp(uploaded.getPixmapConst()->getPixels(), expected.getPixels(), expected.getPixelByteCount()) == 0 );
+		CPPUNIT_ASSERT_EQUAL( reloadedCount + 1, ResidencyManager::getReloadedCount() );
+		uploaded.getPixmapConst();
+		CPPUNIT_ASSERT_EQUAL( reloadedCount + 1, ResidencyManager::getReloadedCount() );
+		CPPUNIT_ASSERT( ResidencyManager::getResidentBytes(ResidencyManager::rcTexturePixels) >= (int64) expected.getPixelByteCount() * 3 );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ResidencyManagerTest );
+//
@@ -0,0 +1,150 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "sound_sample_cache.h"
+
+using namespace Shared::Sound;
+
+// Returns 100 bytes per file without touching the disk
+class TestSampleDecoder : public SoundSampleDecoder {
+public:
+	vector<string> decoded;
+
+	virtual int8 *decode(const string &path, SoundInfo *info) {
+		decoded.push_back(path);
+		if (path == "missing.wav") {
+			return NULL;
+		}
+		info->setChannels(1);
+		info->setBitsPerSample(8);
+		info->setSize(100);
+		int8 *samples = new int8[100];
+		samples[0] = (int8) path.size();
+		return samples;
+	}
+};
+
+//
+// Tests for SoundSampleCache
+//
+class SoundSampleCacheTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( SoundSampleCacheTest );
+
+	CPPUNIT_TEST( test_decodes_once_and_shares );
+	CPPUNIT_TEST( test_evicts_least_recently_used );
+	CPPUNIT_TEST( test_decodes_by_priority );
+	CPPUNIT_TEST( test_plays_short_sounds_right_away );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+public:
+
+	void test_decodes_once_and_shares() {
+		TestSampleDecoder decoder;
+		SoundSampleCache cache;
+		cache.setDecoder(&decoder);
+
+		// Without decode threads the first play decodes right away
+		SoundSampleBuffer *first = cache.acquire("a.wav");
+		SoundSampleBuffer *second = cache.acquire("a.wav");
+		CPPUNIT_ASSERT( first != NULL );
+		CPPUNIT_ASSERT( first == second );
+		CPPUNIT_ASSERT_EQUAL( (uint32)100,first->getInfo()->getSize() );
+		CPPUNIT_ASSERT_EQUAL( (uint64)100,cache.getMemoryUsage() );
+		CPPUNIT_ASSERT_EQUAL( 1,(int)decoder.decoded.size() );
+		cache.release(first);
+		cache.release(second);
+
+		// Files that fail to decode are not retried
+		CPPUNIT_ASSERT( cache.acquire("missing.wav") == NULL );
+		CPPUNIT_ASSERT( cache.acquire("missing.wav") == NULL );
+		CPPUNIT_ASSERT_EQUAL( 2,(int)decoder.decoded.size() );
+
+		cache.clear();
+		CPPUNIT_ASSERT_EQUAL( (uint64)0,cache.getMemoryUsage() );
+	}
+
+	void test_evicts_least_recently_used() {
+		TestSampleDecoder decoder;
+		SoundSampleCache cache;
+		cache.setDecoder(&decoder);
+		cache.setMemoryLimit(300);
+
+		cache.release(cache.acquire("a.wav"));
+		cache.release(cache.acquire("b.wav"));
+		SoundSampleBuffer *pinned = cache.acquire("c.wav");
+		cache.release(cache.acquire("a.wav"));
+
+		// b is the oldest unpinned buffer
+		cache.release(cache.acquire("d.wav"));
+		CPPUNIT_ASSERT( cache.isCached("a.wav") );
+		CPPUNIT_ASSERT( cache.isCached("b.wav") == false );
+		CPPUNIT_ASSERT( cache.isCached("c.wav") );
+		CPPUNIT_ASSERT( cache.isCached("d.wav") );
+		CPPUNIT_ASSERT_EQUAL( (uint64)300,cache.getMemoryUsage() );
+
+		// Pinned buffers survive a smaller limit until released
+		cache.setMemoryLimit(50);
+		CPPUNIT_ASSERT( cache.isCached("c.wav") );
+		CPPUNIT_ASSERT_EQUAL( (uint64)100,cache.getMemoryUsage() );
+		cache.release(pinned);
+		CPPUNIT_ASSERT( cache.isCached("c.wav") == false );
+		CPPUNIT_ASSERT_EQUAL( (uint64)0,cache.getMemoryUsage() );
+	}
+
+	void test_decodes_by_priority() {
+		TestSampleDecoder decoder;
+		SoundSampleCache cache;
+		cache.setDecoder(&decoder);
+		cache.setMemoryLimit(200);
+
+		cache.prefetch("low.wav");
+		cache.prefetch("high.wav", SoundSampleCache::priorityPlay);
+		cache.prefetch("also_low.wav");
+		cache.prefetch("low.wav", 5);
+
+		CPPUNIT_ASSERT( cache.decodeNext() );
+		CPPUNIT_ASSERT( cache.decodeNext() );
+		CPPUNIT_ASSERT_EQUAL( string("high.wav"),decoder.decoded[0] );
+		CPPUNIT_ASSERT_EQUAL( string("low.wav"),decoder.decoded[1] );
+
+		// The cache is full, so the remaining prefetch is dropped
+		CPPUNIT_ASSERT( cache.decodeNext() == false );
+		CPPUNIT_ASSERT_EQUAL( 2,(int)decoder.decoded.size() );
+		CPPUNIT_ASSERT( cache.isCached("also_low.wav") == false );
+	}
+
+	void test_plays_short_sounds_right_away() {
+		TestSampleDecoder decoder;
+		SoundSampleCache cache;
+		cache.setDecoder(&decoder);
+		cache.setInlineDecodeLimit(100);
+		cache.startDecodeThreads(1);
+
+		// Short sounds are there on the first play even with decode threads
+		SoundSampleBuffer *buffer = cache.acquire("short.wav", SoundSampleCache::priorityPlay, 100);
+		CPPUNIT_ASSERT( buffer != NULL );
+		cache.release(buffer);
+
+		// Longer ones are left to the threads
+		CPPUNIT_ASSERT( cache.acquire("long.wav", SoundSampleCache::priorityPlay, 101) == NULL );
+
+		cache.stopDecodeThreads();
+		CPPUNIT_ASSERT_EQUAL( 0,cache.getDecodeThreadCount() );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( SoundSampleCacheTest );
+//
@@ -0,0 +1,119 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "byte_delta.h"
+
+using namespace Shared::Util;
+
+//
+// Tests for ByteDelta
+//
+class ByteDeltaTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ByteDeltaTest );
+
+	CPPUNIT_TEST( test_unchanged_has_no_runs );
+	CPPUNIT_TEST( test_roundtrip );
+	CPPUNIT_TEST( test_short_gaps_join_runs );
+	CPPUNIT_TEST( test_rejects_bad_payload );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	vector<unsigned char> makeBuffer(size_t size) {
+		vector<unsigned char> buffer(size);
+		for (size_t i = 0; i < size; ++i) {
+			buffer[i] = static_cast<unsigned char>(i * 13);
+		}
+		return buffer;
+	}
+
+public:
+
+	void test_unchanged_has_no_runs() {
+		vector<unsigned char> base = makeBuffer(64);
+		vector<unsigned char> payload;
+		CPPUNIT_ASSERT_EQUAL( 0,ByteDelta::encode(base, base, payload, 4) );
+		CPPUNIT_ASSERT( payload.empty() );
+
+		vector<unsigned char> buffer(base);
+		CPPUNIT_ASSERT( ByteDelta::apply(payload, 0, buffer) );
+		CPPUNIT_ASSERT( buffer == base );
+	}
+
+	void test_roundtrip() {
+		vector<unsigned char> base = makeBuffer(1000);
+		vector<unsigned char> target(base);
+		target[0] ^= 0xff;
+		target[500] ^= 0xff;
+		target[501] ^= 0xff;
+		target[999] ^= 0xff;
+
+		vector<unsigned char> payload;
+		int runCount = ByteDelta::encode(base, target, payload, 4);
+		CPPUNIT_ASSERT_EQUAL( 3,runCount );
+		// Three run headers and the four changed bytes
+		CPPUNIT_ASSERT_EQUAL( 3 * 4 + 4,(int)payload.size() );
+
+		vector<unsigned char> buffer(base);
+		CPPUNIT_ASSERT( ByteDelta::apply(payload, runCount, buffer) );
+		CPPUNIT_ASSERT( buffer == target );
+	}
+
+	void test_short_gaps_join_runs() {
+		vector<unsigned char> base = makeBuffer(100);
+		vector<unsigned char> target(base);
+		target[10] ^= 0xff;
+		target[14] ^= 0xff;
+		target[40] ^= 0xff;
+
+		vector<unsigned char> payload;
+		int runCount = ByteDelta::encode(base, target, payload, 4);
+		CPPUNIT_ASSERT_EQUAL( 2,runCount );
+
+		vector<unsigned char> buffer(base);
+		CPPUNIT_ASSERT( ByteDelta::apply(payload, runCount, buffer) );
+		CPPUNIT_ASSERT( buffer == target );
+
+		payload.clear();
+		CPPUNIT_ASSERT_EQUAL( 3,ByteDelta::encode(base, target, payload, 0) );
+	}
+
+	void test_rejects_bad_payload() {
+		vector<unsigned char> base = makeBuffer(100);
+		vector<unsigned char> target(base);
+		target[90] ^= 0xff;
+
+		vector<unsigned char> payload;
+		int runCount = ByteDelta::encode(base, target, payload, 4);
+
+		// Applied to a shorter buffer the run is out of range
+		vector<unsigned char> shortBuffer = makeBuffer(50);
+		vector<unsigned char> shortCopy(shortBuffer);
+		CPPUNIT_ASSERT( ByteDelta::apply(payload, runCount, shortBuffer) == false );
+		CPPUNIT_ASSERT( shortBuffer == shortCopy );
+
+		// More runs than the payload holds
+		vector<unsigned char> buffer(base);
+		CPPUNIT_ASSERT( ByteDelta::apply(payload, runCount + 1, buffer) == false );
+		CPPUNIT_ASSERT( buffer == base );
+
+		// Truncated run bytes
+		payload.pop_back();
+		CPPUNIT_ASSERT( ByteDelta::apply(payload, runCount, buffer) == false );
+		CPPUNIT_ASSERT( buffer == base );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ByteDeltaTest );
+//
@@ -0,0 +1,155 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <fstream>
+#include "platform_common.h"
+
+using namespace Shared::PlatformCommon;
+using namespace Shared::Util;
+
+//
+// Tests for ContentManifest
+//
+class ContentManifestTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ContentManifestTest );
+
+	CPPUNIT_TEST( test_changed_and_obsolete_entries );
+	CPPUNIT_TEST( test_build_save_load_roundtrip );
+	CPPUNIT_TEST( test_rejects_paths_outside_root );
+	CPPUNIT_TEST( test_empty_file_entry );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	void writeTextFile(const string &fileName, const string &text) {
+		std::ofstream file(fileName.c_str());
+		file << text;
+		file.close();
+	}
+
+public:
+
+	void test_changed_and_obsolete_entries() {
+		writeTextFile("content_manifest_test_remote.manifest",
+			"MegaGlestContentManifest 1\ntechtrees\n"
+			"10 100 factions/magic/magic.xml\n"
+			"20 200 factions/tech/tech.xml\n"
+			"30 300 my tech.xml\n");
+		writeTextFile("content_manifest_test_local.manifest",
+			"MegaGlestContentManifest 1\n\n"
+			"10 100 factions/magic/magic.xml\n"
+			"21 200 factions/tech/tech.xml\n"
+			"40 400 old.xml\n");
+
+		ContentManifest remoteManifest;
+		ContentManifest localManifest;
+		CPPUNIT_ASSERT( remoteManifest.load("content_manifest_test_remote.manifest") );
+		CPPUNIT_ASSERT( localManifest.load("content_manifest_test_local.manifest") );
+		removeFile("content_manifest_test_remote.manifest");
+		removeFile("content_manifest_test_local.manifest");
+
+		CPPUNIT_ASSERT_EQUAL( string("techtrees"),remoteManifest.getAccount() );
+		CPPUNIT_ASSERT_EQUAL( 3,(int)remoteManifest.getEntries().size() );
+
+		vector<ContentManifest::Entry> changed = remoteManifest.getChangedEntries(localManifest);
+		CPPUNIT_ASSERT_EQUAL( 2,(int)changed.size() );
+		CPPUNIT_ASSERT_EQUAL( string("factions/tech/tech.xml"),changed[0].path );
+		CPPUNIT_ASSERT_EQUAL( string("my tech.xml"),changed[1].path );
+		CPPUNIT_ASSERT_EQUAL( (int64)300,changed[1].size );
+
+		vector<string> obsolete = remoteManifest.getObsoletePaths(localManifest);
+		CPPUNIT_ASSERT_EQUAL( 1,(int)obsolete.size() );
+		CPPUNIT_ASSERT_EQUAL( string("old.xml"),obsolete[0] );
+	}
+
+	void test_build_save_load_roundtrip() {
+		string root = "content_manifest_test_root/";
+		createDirectoryPaths(root + "models");
+		writeTextFile(root + "a.xml", "<a/>");
+		writeTextFile(root + "models/b.g3d", "model data");
+
+		ContentManifest manifest;
+		manifest.build(root, "tilesets", true);
+		CPPUNIT_ASSERT_EQUAL( 2,(int)manifest.getEntries().size() );
+		CPPUNIT_ASSERT_EQUAL( string("a.xml"),manifest.getEntries()[0].path );
+		CPPUNIT_ASSERT_EQUAL( string("models/b.g3d"),manifest.getEntries()[1].path );
+		CPPUNIT_ASSERT_EQUAL( (int64)10,manifest.getEntries()[1].size );
+
+		CPPUNIT_ASSERT( manifest.save("content_manifest_test.manifest") );
+		ContentManifest loaded;
+		CPPUNIT_ASSERT( loaded.load("content_manifest_test.manifest") );
+		removeFile("content_manifest_test.manifest");
+
+		CPPUNIT_ASSERT_EQUAL( string("tilesets"),loaded.getAccount() );
+		CPPUNIT_ASSERT( loaded.getChangedEntries(manifest).empty() );
+		CPPUNIT_ASSERT( loaded.getObsoletePaths(manifest).empty() );
+
+		// A changed file shows up once the folder is rebuilt without caches
+		writeTextFile(root + "a.xml", "<a value=\"1\"/>");
+		ContentManifest rebuilt;
+		rebuilt.build(root, "", true);
+		vector<ContentManifest::Entry> changed = loaded.getChangedEntries(rebuilt);
+		CPPUNIT_ASSERT_EQUAL( 1,(int)changed.size() );
+		CPPUNIT_ASSERT_EQUAL( string("a.xml"),changed[0].path );
+
+		removeFolder(root);
+	}
+
+	void test_rejects_paths_outside_root() {
+		writeTextFile("content_manifest_test_bad.manifest",
+			"MegaGlestContentManifest 1\ntechtrees\n"
+			"10 100 ../../evil.xml\n");
+
+		ContentManifest manifest;
+		CPPUNIT_ASSERT( manifest.load("content_manifest_test_bad.manifest") == false );
+		CPPUNIT_ASSERT( manifest.getEntries().empty() );
+		removeFile("content_manifest_test_bad.manifest");
+	}
+
+	void test_empty_file_entry() {
+		string root = "content_manifest_test_empty/";
+		createDirectoryPaths(root);
+		writeTextFile(root + "empty.txt", "");
+
+		ContentManifest manifest;
+		manifest.build(root, "techtrees", true);
+		CPPUNIT_ASSERT_EQUAL( 1,(int)manifest.getEntries().size() );
+		CPPUNIT_ASSERT_EQUAL( (int64)0,manifest.getEntries()[0].size );
+
+		// The client checks a downloaded file against the manifest CRC
+		Checksum checksum;
+		checksum.addFile(root + "empty.txt");
+		CPPUNIT_ASSERT_EQUAL( checksum.getSum(),manifest.getEntries()[0].crc );
+
+		CPPUNIT_ASSERT( manifest.save("content_manifest_test_empty.manifest") );
+		ContentManifest loaded;
+		CPPUNIT_ASSERT( loaded.load("content_manifest_test_empty.manifest") );
+		removeFile("content_manifest_test_empty.manifest");
+		CPPUNIT_ASSERT_EQUAL( (int64)0,loaded.getEntries()[0].size );
+
+		// A missing or non empty local copy has to be fetched again
+		ContentManifest missing;
+		CPPUNIT_ASSERT_EQUAL( 1,(int)loaded.getChangedEntries(missing).size() );
+
+		writeTextFile(root + "empty.txt", "stale");
+		ContentManifest stale;
+		stale.build(root, "", true);
+		CPPUNIT_ASSERT_EQUAL( 1,(int)loaded.getChangedEntries(stale).size() );
+
+		removeFolder(root);
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ContentManifestTest );
+//
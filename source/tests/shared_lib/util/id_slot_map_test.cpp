@@ -0,0 +1,94 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "id_slot_map.h"
+#include <vector>
+
+using namespace Shared::Util;
+
+//
+// Tests for IdSlotMap
+//
+class IdSlotMapTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( IdSlotMapTest );
+
+	CPPUNIT_TEST( test_insert_find_erase );
+	CPPUNIT_TEST( test_iteration_in_id_order );
+	CPPUNIT_TEST( test_clear_reuses_pages );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+public:
+
+	void test_insert_find_erase() {
+		IdSlotMap<int> slotMap;
+		CPPUNIT_ASSERT( slotMap.empty() );
+		CPPUNIT_ASSERT( slotMap.find(5) == slotMap.end() );
+
+		slotMap[5] = 50;
+		slotMap[100001] = 7;
+		slotMap[5] = 55;
+		CPPUNIT_ASSERT_EQUAL( (size_t)2,slotMap.size() );
+		CPPUNIT_ASSERT_EQUAL( 55,slotMap.find(5)->second );
+		CPPUNIT_ASSERT_EQUAL( 7,*slotMap.get(100001) );
+		CPPUNIT_ASSERT( slotMap.get(6) == NULL );
+		CPPUNIT_ASSERT( slotMap.get(-1) == NULL );
+
+		CPPUNIT_ASSERT_EQUAL( (size_t)1,slotMap.erase(5) );
+		CPPUNIT_ASSERT_EQUAL( (size_t)0,slotMap.erase(5) );
+		CPPUNIT_ASSERT( slotMap.find(5) == slotMap.end() );
+		CPPUNIT_ASSERT_EQUAL( (size_t)1,slotMap.size() );
+	}
+
+	void test_iteration_in_id_order() {
+		IdSlotMap<int> slotMap;
+		int ids[] = { 200003, 7, 100000, 300, 0 };
+		for(int index = 0; index < 5; ++index) {
+			slotMap[ids[index]] = index;
+		}
+
+		std::vector<int> visited;
+		for(IdSlotMap<int>::const_iterator iterMap = slotMap.begin();
+			iterMap != slotMap.end(); ++iterMap) {
+			visited.push_back(iterMap->first);
+		}
+		CPPUNIT_ASSERT_EQUAL( (size_t)5,visited.size() );
+		CPPUNIT_ASSERT_EQUAL( 0,visited[0] );
+		CPPUNIT_ASSERT_EQUAL( 7,visited[1] );
+		CPPUNIT_ASSERT_EQUAL( 300,visited[2] );
+		CPPUNIT_ASSERT_EQUAL( 100000,visited[3] );
+		CPPUNIT_ASSERT_EQUAL( 200003,visited[4] );
+	}
+
+	void test_clear_reuses_pages() {
+		IdSlotMap<std::vector<int> > slotMap;
+		slotMap[10].push_back(1);
+		slotMap[11].push_back(2);
+		slotMap.clear();
+		CPPUNIT_ASSERT( slotMap.empty() );
+		CPPUNIT_ASSERT( slotMap.begin() == slotMap.end() );
+
+		// A recycled page must not report entries filled before the clear
+		CPPUNIT_ASSERT( slotMap.get(11) == NULL );
+		CPPUNIT_ASSERT_EQUAL( (size_t)0,slotMap[11].size() );
+		CPPUNIT_ASSERT_EQUAL( (size_t)1,slotMap.size() );
+
+		IdSlotMap<std::vector<int> > copy(slotMap);
+		CPPUNIT_ASSERT( copy.get(11) != NULL );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( IdSlotMapTest );
+//
@@ -0,0 +1,82 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <algorithm>
+#include "object_pool.h"
+
+using namespace Shared::Util;
+
+struct PooledItem {
+	int values[4];
+};
+
+//
+// Tests for ObjectPool and BufferPool
+//
+class ObjectPoolTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ObjectPoolTest );
+
+	CPPUNIT_TEST( test_reuses_released_blocks );
+	CPPUNIT_TEST( test_buffers_keep_capacity );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+public:
+
+	void test_reuses_released_blocks() {
+		// Pools stay registered for the debug stats, so they are static
+		static ObjectPool<PooledItem, 2> pool("test item");
+		std::vector<ObjectPoolStats *> poolList = ObjectPoolStats::getPoolList();
+		CPPUNIT_ASSERT( std::find(poolList.begin(), poolList.end(), &pool) != poolList.end() );
+
+		void *first = pool.allocate(sizeof(PooledItem));
+		void *second = pool.allocate(sizeof(PooledItem));
+		CPPUNIT_ASSERT_EQUAL( (int64) 2, pool.getHeapCount() );
+		CPPUNIT_ASSERT_EQUAL( (int64) 2, pool.getLiveCount() );
+
+		pool.release(first, sizeof(PooledItem));
+		CPPUNIT_ASSERT( pool.allocate(sizeof(PooledItem)) == first );
+		CPPUNIT_ASSERT_EQUAL( (int64) 1, pool.getReuseCount() );
+
+		// Blocks of other sizes are never kept
+		void *larger = pool.allocate(sizeof(PooledItem) * 2);
+		pool.release(larger, sizeof(PooledItem) * 2);
+		CPPUNIT_ASSERT_EQUAL( (int64) 3, pool.getHeapCount() );
+
+		pool.release(first, sizeof(PooledItem));
+		pool.release(second, sizeof(PooledItem));
+		CPPUNIT_ASSERT_EQUAL( (int64) 0, pool.getLiveCount() );
+	}
+
+	void test_buffers_keep_capacity() {
+		static BufferPool<std::vector<int> > pool("test buffer");
+
+		std::vector<int> buffer;
+		pool.acquire(buffer);
+		buffer.resize(100);
+		pool.release(buffer);
+		CPPUNIT_ASSERT( buffer.capacity() == 0 );
+
+		std::vector<int> reused;
+		pool.acquire(reused);
+		CPPUNIT_ASSERT( reused.empty() );
+		CPPUNIT_ASSERT( reused.capacity() >= 100 );
+		CPPUNIT_ASSERT_EQUAL( (int64) 1, pool.getReuseCount() );
+		pool.release(reused);
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ObjectPoolTest );
+//
@@ -0,0 +1,81 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "randomgen.h"
+#include <string>
+
+using namespace Shared::Util;
+
+//
+// Tests for RandomGen
+//
+class RandomGenTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( RandomGenTest );
+
+	CPPUNIT_TEST( test_caller_overloads_same_sequence );
+	CPPUNIT_TEST( test_last_caller_tracking );
+	CPPUNIT_TEST( test_streams_are_independent );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+public:
+
+	void test_caller_overloads_same_sequence() {
+		RandomGen randomA;
+		RandomGen randomB;
+		randomA.init(1234);
+		randomB.init(1234);
+
+		for(int index = 0; index < 100; ++index) {
+			CPPUNIT_ASSERT_EQUAL( randomA.randRange(0, 1000, std::string("caller")),randomB.randRange(0, 1000, "caller") );
+			CPPUNIT_ASSERT_EQUAL( randomA.randRange(-1.0f, 1.0f),randomB.randRange(-1.0f, 1.0f, "caller") );
+		}
+	}
+
+	void test_last_caller_tracking() {
+		RandomGen random;
+		random.init(1);
+		random.randRange(0, 10, "site1");
+		random.randRange(0, 10, std::string("site2"));
+		random.randRange(0, 10);
+		CPPUNIT_ASSERT_EQUAL( std::string("site1|site2|"),random.getLastCaller() );
+
+		random.clearLastCaller();
+		random.setDisableLastCallerTracking(true);
+		random.randRange(0, 10, "site3");
+		random.addLastCaller("site4");
+		CPPUNIT_ASSERT_EQUAL( std::string(""),random.getLastCaller() );
+	}
+
+	void test_streams_are_independent() {
+		CPPUNIT_ASSERT_EQUAL( 42,RandomGen::getStreamSeed(42, rsDefault) );
+		CPPUNIT_ASSERT( RandomGen::getStreamSeed(42, rsSimulation) != RandomGen::getStreamSeed(42, rsParticles) );
+
+		RandomGen simulation;
+		RandomGen particles;
+		simulation.init(42, rsSimulation);
+		particles.init(42, rsParticles);
+		int simulationNumber = simulation.getLastNumber();
+
+		// Drawing from the particle stream must not touch the simulation stream
+		for(int index = 0; index < 100; ++index) {
+			particles.randRange(0.0f, 1.0f);
+		}
+		CPPUNIT_ASSERT_EQUAL( simulationNumber,simulation.getLastNumber() );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( RandomGenTest );
+//
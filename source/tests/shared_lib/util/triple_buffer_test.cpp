@@ -0,0 +1,65 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "triple_buffer.h"
+
+using namespace Shared::Util;
+
+//
+// Tests for TripleBuffer
+//
+class TripleBufferTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( TripleBufferTest );
+
+	CPPUNIT_TEST( test_reader_sees_latest_value );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+public:
+
+	void test_reader_sees_latest_value() {
+		TripleBuffer<int> buffer;
+		CPPUNIT_ASSERT_EQUAL( false, buffer.update() );
+
+		buffer.getWriteBuffer() = 1;
+		buffer.publish();
+		CPPUNIT_ASSERT( buffer.hasUpdate() );
+		CPPUNIT_ASSERT( buffer.update() );
+		CPPUNIT_ASSERT_EQUAL( 1, buffer.getReadBuffer() );
+		CPPUNIT_ASSERT_EQUAL( false, buffer.update() );
+
+		// Values published before the reader looks replace each other
+		buffer.getWriteBuffer() = 2;
+		buffer.publish();
+		buffer.getWriteBuffer() = 3;
+		buffer.publish();
+		CPPUNIT_ASSERT_EQUAL( 1, buffer.getReadBuffer() );
+		CPPUNIT_ASSERT( buffer.update() );
+		CPPUNIT_ASSERT_EQUAL( 3, buffer.getReadBuffer() );
+
+		// The writer never gets the buffer being read
+		for (int value = 4; value < 10; ++value) {
+			buffer.getWriteBuffer() = value;
+			buffer.publish();
+			CPPUNIT_ASSERT( &buffer.getWriteBuffer() != &buffer.getReadBuffer() );
+		}
+		CPPUNIT_ASSERT_EQUAL( 3, buffer.getReadBuffer() );
+		CPPUNIT_ASSERT( buffer.update() );
+		CPPUNIT_ASSERT_EQUAL( 9, buffer.getReadBuffer() );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( TripleBufferTest );
+//
@@ -335,6 +335,7 @@ class XmlNodeTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST( test_valid_named_node );
 	CPPUNIT_TEST( test_child_nodes );
 	CPPUNIT_TEST( test_node_attributes );
+	CPPUNIT_TEST( test_loaded_tree );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
@@ -471,6 +472,53 @@ public:
 		CPPUNIT_ASSERT_EQUAL( true, node.hasAttribute("some-attribute") );
 	}
 
+	void test_loaded_tree() {
+		const string test_filename = "xml_test_loaded_tree.xml";
+		std::ofstream xmlFile(test_filename.c_str());
+		xmlFile << "<?xml version=\"1.0\"?>" << std::endl
+				<< "<unit>" << std::endl
+				<< "<image path=\"{TESTPATH}/unit.bmp\" size=\"2\"/>" << std::endl
+				<< "<skill name=\"move\"/>" << std::endl
+				<< "<skill name=\"attack\"/>" << std::endl
+				<< "<description>plain text</description>" << std::endl
+				<< "</unit>" << std::endl;
+		xmlFile.close();
+		SafeRemoveTestFile deleteFile(test_filename);
+
+		std::map<string,string> mapTagReplacementValues;
+		mapTagReplacementValues["{TESTPATH}"] = "data/units";
+		XmlNode *rootNode = XmlIoRapid::getInstance().load(test_filename, mapTagReplacementValues);
+
+		CPPUNIT_ASSERT_EQUAL( string("unit"), rootNode->getName() );
+		CPPUNIT_ASSERT_EQUAL( (size_t)4, rootNode->getChildCount() );
+
+		// Values with tags are replaced, plain values are read as is
+		XmlNode *imageNode = rootNode->getChild("image");
+		CPPUNIT_ASSERT_EQUAL( string("data/units/unit.bmp"), imageNode->getAttribute("path")->getValue() );
+		CPPUNIT_ASSERT_EQUAL( 2, imageNode->getAttribute("size")->getIntValue() );
+		CPPUNIT_ASSERT_EQUAL( string("plain text"), rootNode->getChild("description")->getText() );
+
+		CPPUNIT_ASSERT_EQUAL( string("attack"), rootNode->getChild("skill",1)->getAttribute("name")->getValue() );
+		CPPUNIT_ASSERT_EQUAL( (size_t)2, rootNode->getChildList("skill").size() );
+		CPPUNIT_ASSERT_EQUAL( false, rootNode->hasChild("not-in-file") );
+
+		// Nodes added after loading are found by name like loaded ones
+		rootNode->addChild("skill")->addAttribute("name", "stop", mapTagReplacementValues);
+		rootNode->addChild("not-in-file");
+		CPPUNIT_ASSERT_EQUAL( (size_t)3, rootNode->getChildList("skill").size() );
+		CPPUNIT_ASSERT_EQUAL( string("stop"), rootNode->getChild("skill",2)->getAttribute("name")->getValue() );
+		CPPUNIT_ASSERT_EQUAL( true, rootNode->hasChild("not-in-file") );
+
+		CPPUNIT_ASSERT_EQUAL( 3, rootNode->clearChild("skill") );
+		CPPUNIT_ASSERT_EQUAL( (size_t)3, rootNode->getChildCount() );
+
+		// Loaded nodes free the nodes added to them along with the tree
+		imageNode->addChild("frame")->addAttribute("index", "1", mapTagReplacementValues);
+		CPPUNIT_ASSERT_EQUAL( (size_t)1, imageNode->getChildCount() );
+
+		delete rootNode;
+	}
+
 };
 
 #if defined(WANT_XERCES)
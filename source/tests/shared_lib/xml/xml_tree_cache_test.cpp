@@ -0,0 +1,138 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2013 Mark Vejvoda
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <fstream>
+#ifdef WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+#include "xml_parser.h"
+#include "xml_tree_cache.h"
+#include "platform_common.h"
+
+using namespace Shared::Xml;
+using namespace Shared::PlatformCommon;
+
+//
+// Tests for XmlTreeCache
+//
+class XmlTreeCacheTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( XmlTreeCacheTest );
+
+	CPPUNIT_TEST( test_reloads_unchanged_folder );
+	CPPUNIT_TEST( test_reparses_edited_file );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	void writeUnitFile(const string &path, const string &description, time_t fileTime) {
+		std::ofstream xmlFile(path.c_str());
+		xmlFile << "<?xml version=\"1.0\"?>" << std::endl
+				<< "<unit><description>" << description << "</description></unit>" << std::endl;
+		xmlFile.close();
+
+		struct utimbuf times;
+		times.actime = fileTime;
+		times.modtime = fileTime;
+		utime(path.c_str(), &times);
+	}
+
+public:
+
+	void test_reloads_unchanged_folder() {
+		const string folder = "xml_tree_cache_test/";
+		const string path = folder + "unit.xml";
+		const string cacheFile = "xml_tree_cache_test.cache";
+		createDirectoryPaths(folder);
+
+		std::ofstream xmlFile(path.c_str());
+		xmlFile << "<?xml version=\"1.0\"?>" << std::endl
+				<< "<unit>" << std::endl
+				<< "<image path=\"{TESTPATH}/unit.bmp\"/>" << std::endl
+				<< "<description>plain text</description>" << std::endl
+				<< "</unit>" << std::endl;
+		xmlFile.close();
+
+		std::map<string,string> mapTagReplacementValues;
+		mapTagReplacementValues["{TESTPATH}"] = "first";
+
+		// The first load parses the file and saves its image
+		{
+			XmlTreeCache cache(folder, 1234, cacheFile);
+			XmlTree xmlTree;
+			xmlTree.load(path, mapTagReplacementValues);
+			CPPUNIT_ASSERT_EQUAL( 1, cache.getEntryCount() );
+			CPPUNIT_ASSERT( cache.isChanged() );
+		}
+
+		// Tags are replaced when the image is loaded, not when it is saved
+		mapTagReplacementValues["{TESTPATH}"] = "second";
+		{
+			XmlTreeCache cache(folder, 1234, cacheFile);
+			CPPUNIT_ASSERT_EQUAL( 1, cache.getEntryCount() );
+
+			XmlTree xmlTree;
+			xmlTree.load(path, mapTagReplacementValues);
+			CPPUNIT_ASSERT( cache.isChanged() == false );
+
+			const XmlNode *rootNode = xmlTree.getRootNode();
+			CPPUNIT_ASSERT_EQUAL( string("unit"), rootNode->getName() );
+			CPPUNIT_ASSERT_EQUAL( string("second/unit.bmp"), rootNode->getChild("image")->getAttribute("path")->getValue() );
+			CPPUNIT_ASSERT_EQUAL( string("plain text"), rootNode->getChild("description")->getText() );
+		}
+
+		// A different folder checksum discards the saved images
+		{
+			XmlTreeCache cache(folder, 4321, cacheFile);
+			CPPUNIT_ASSERT_EQUAL( 0, cache.getEntryCount() );
+		}
+
+		removeFile(cacheFile);
+		removeFolder(folder);
+	}
+
+	void test_reparses_edited_file() {
+		const string folder = "xml_tree_cache_edit_test/";
+		const string path = folder + "unit.xml";
+		const string cacheFile = "xml_tree_cache_edit_test.cache";
+		createDirectoryPaths(folder);
+		std::map<string,string> mapTagReplacementValues;
+
+		writeUnitFile(path, "first", 1000000000);
+		{
+			XmlTreeCache cache(folder, 1234, cacheFile);
+			XmlTree xmlTree;
+			xmlTree.load(path, mapTagReplacementValues);
+		}
+
+		// Same size and same folder checksum, only the file time differs
+		writeUnitFile(path, "other", 1000000060);
+		{
+			XmlTreeCache cache(folder, 1234, cacheFile);
+			CPPUNIT_ASSERT_EQUAL( 1, cache.getEntryCount() );
+
+			XmlTree xmlTree;
+			xmlTree.load(path, mapTagReplacementValues);
+			CPPUNIT_ASSERT( cache.isChanged() );
+			CPPUNIT_ASSERT_EQUAL( string("other"), xmlTree.getRootNode()->getChild("description")->getText() );
+		}
+
+		removeFile(cacheFile);
+		removeFolder(folder);
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( XmlTreeCacheTest );
+//
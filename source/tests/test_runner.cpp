@@ -12,12 +12,21 @@
 #include <cppunit/CompilerOutputter.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
+#include <cstring>
 
 
 int main(int argc, char* argv[])
 {
+  // Timing suites are kept out of the default registry
+  const char *registryName = "All Tests";
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--benchmark") == 0) {
+      registryName = "benchmark";
+    }
+  }
+
   // Get the top level suite from the registry
-  CppUnit::Test *suite = CppUnit::TestFactoryRegistry::getRegistry().makeTest();
+  CppUnit::Test *suite = CppUnit::TestFactoryRegistry::getRegistry(registryName).makeTest();
 
   // Adds the test to the list of test to run
   CppUnit::TextUi::TestRunner runner;